@@ -0,0 +1,237 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/data/cube.hpp"
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+//  -- General --
+#include "gen/enum.hpp"
+#include "gen/log.hpp"
+
+//  -- Utility --
+#include "utl/colourmap.hpp"
+#include "utl/file.hpp"
+#include "utl/stream.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace data
+    {
+
+
+
+        //  == INSTANTIATION ==
+        //  -- Constructors --
+        /**
+         *  Construct a cube of zeroed voxels with a given resolution.
+         *
+         *  @param  t_res   Number of voxels along each side of the cube.
+         */
+        Cube::Cube(const size_t t_res) :
+            m_res(t_res),
+            m_data(t_res * t_res * t_res, 0.0)
+        {
+        }
+
+
+
+        //  == METHODS ==
+        //  -- Getters --
+        /**
+         *  Determine the maximum voxel value within the data.
+         *
+         *  @return The maximum voxel value within the cube.
+         */
+        double Cube::get_max_value() const
+        {
+            double max = 0.0;
+
+            for (size_t i = 0; i < m_data.size(); ++i)
+            {
+                if (m_data[i] > max)
+                {
+                    max = m_data[i];
+                }
+            }
+
+            return (max);
+        }
+
+
+        //  -- Setters --
+        /**
+         *  Set every voxel of a cubic region of the cube to a given value.
+         *
+         *  @param  t_x     X index of the first voxel of the region.
+         *  @param  t_y     Y index of the first voxel of the region.
+         *  @param  t_z     Z index of the first voxel of the region.
+         *  @param  t_size  Number of voxels along each side of the region.
+         *  @param  t_value Value to set the voxels to.
+         *
+         *  @pre    The region must lie within the cube.
+         */
+        void Cube::fill(const size_t t_x, const size_t t_y, const size_t t_z, const size_t t_size, const double t_value)
+        {
+            assert((t_x + t_size) <= m_res);
+            assert((t_y + t_size) <= m_res);
+            assert((t_z + t_size) <= m_res);
+
+            for (size_t k = t_z; k < (t_z + t_size); ++k)
+            {
+                for (size_t j = t_y; j < (t_y + t_size); ++j)
+                {
+                    const size_t row = ((k * m_res) + j) * m_res;
+                    std::fill(m_data.begin() + static_cast<long int>(row + t_x),
+                              m_data.begin() + static_cast<long int>(row + t_x + t_size), t_value);
+                }
+            }
+        }
+
+
+        //  -- Saving --
+        /**
+         *  Save the cube as a raw little-endian float32 volume, following a small header.
+         *  The header holds the tag, then the resolution along x, y and z and the bytes per value as 64 bit integers,
+         *  followed by the minimum and maximum spatial bounds of the volume as float64 values.
+         *  Values follow with the x index varying fastest, then y, then z.
+         *
+         *  @param  t_path      Path to the file to write, without an extension.
+         *  @param  t_min_bound Minimum spatial bound of the volume.
+         *  @param  t_max_bound Maximum spatial bound of the volume.
+         */
+        void Cube::save(const std::string& t_path, const std::array<double, 3>& t_min_bound,
+                        const std::array<double, 3>& t_max_bound) const
+        {
+            std::ofstream file(t_path + ".raw", std::ios::binary);
+
+            // Write the header.
+            file.write(RAW_CUBE_TAG, sizeof(RAW_CUBE_TAG) - 1);
+            for (size_t i = 0; i < 3; ++i)
+            {
+                utl::write_little_endian(file, static_cast<std::uint64_t>(m_res));
+            }
+            utl::write_little_endian(file, static_cast<std::uint64_t>(sizeof(float)));
+            utl::write_little_endian(file, t_min_bound.data(), t_min_bound.size());
+            utl::write_little_endian(file, t_max_bound.data(), t_max_bound.size());
+
+            // Convert and write the voxels a block at a time.
+            std::vector<float> block(std::min(RAW_CUBE_BLOCK, m_data.size()));
+            for (size_t i = 0; i < m_data.size(); i += block.size())
+            {
+                const size_t num_block = std::min(block.size(), m_data.size() - i);
+                std::copy(m_data.begin() + static_cast<std::ptrdiff_t>(i),
+                          m_data.begin() + static_cast<std::ptrdiff_t>(i + num_block), block.begin());
+                utl::write_little_endian(file, block.data(), num_block);
+            }
+
+            if (!file)
+            {
+                ERROR("Unable to save data::Cube.", "Unable to write file: '" << t_path << ".raw'.");
+            }
+        }
+
+        /**
+         *  Save the slices of one dimension of the cube as images, coloured by the rainbow colourmap.
+         *  Slices, and the pixels within them, are ordered from the maximum index of the cube towards the minimum.
+         *
+         *  @param  t_output_dir    Directory to write the slice sub-directory to.
+         *  @param  t_dimension     Dimension to be sliced.
+         *  @param  t_norm          Normalisation value.
+         *  @param  t_format        Format to save the images as.
+         *
+         *  @pre    t_dimension must be less than three.
+         *  @pre    t_norm must be greater than zero.
+         */
+        void Cube::save_slices(const std::string& t_output_dir, const size_t t_dimension, const double t_norm,
+                               const Image::format t_format) const
+        {
+            assert(t_dimension < 3);
+            assert(t_norm > 0.0);
+
+            // Set dimension name.
+            std::string dim_name;
+            switch (t_dimension)
+            {
+                case X:
+                    dim_name = "X";
+                    break;
+                case Y:
+                    dim_name = "Y";
+                    break;
+                case Z:
+                    dim_name = "Z";
+                    break;
+                default: ERROR("Unable to save cube slice images.",
+                               "The given slice dimension: '" << t_dimension << "' is invalid.");
+            }
+
+            // Create sub-directory.
+            const std::string sub_dir = t_output_dir + "tree_" + dim_name + "_slices/";
+            utl::create_directory(sub_dir);
+
+            // Write the images.
+            for (size_t i = 0; i < m_res; ++i)
+            {
+                TEMP("Saving " + dim_name + " slices", 100.0 * i / m_res);
+
+                // Create the image.
+                Image img(m_res, m_res);
+
+                // Write each pixel.
+                for (size_t j = 0; j < m_res; ++j)
+                {
+                    for (size_t k = 0; k < m_res; ++k)
+                    {
+                        // Slices run from the maximum bound of the tree, so read the cube from its far corner.
+                        const size_t a = m_res - 1 - i;
+                        const size_t b = m_res - 1 - j;
+                        const size_t c = m_res - 1 - k;
+
+                        double value = 0.0;
+                        switch (t_dimension)
+                        {
+                            case X:
+                                value = get_voxel(a, b, c);
+                                break;
+                            case Y:
+                                value = get_voxel(b, a, c);
+                                break;
+                            case Z:
+                                value = get_voxel(b, c, a);
+                                break;
+                            default: ERROR("Unable to save cube slice images.",
+                                           "The given slice dimension: '" << t_dimension << "' is invalid.");
+                        }
+
+                        img.add_to_pixel(j, k, utl::colourmap::transform_rainbow(value / t_norm));
+                    }
+                }
+
+                // Save the image.
+                img.save(sub_dir + dim_name + "_" + std::to_string(i), 1.0, t_format);
+            }
+
+            LOG("Grid " << dim_name << " slice image saving complete.");
+        }
+
+
+
+    } // namespace data
+} // namespace arc
@@ -0,0 +1,92 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_DATA_CUBE_HPP
+#define ARCTORUS_SRC_CLS_DATA_CUBE_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <string>
+#include <vector>
+
+//  -- Classes --
+#include "cls/data/image.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace data
+    {
+
+
+
+        //  == SETTINGS ==
+        //  -- Raw Output --
+        constexpr const char   RAW_CUBE_TAG[] = "ARCVOLUM"; //! Tag beginning each raw volume file.
+        constexpr const size_t RAW_CUBE_BLOCK = 65536;      //! Voxels converted and written at a time.
+
+
+
+        //  == CLASS ==
+        /**
+         *  Cubic volume of scalar voxel data.
+         *  Voxels are held within a single contiguous buffer with the x index varying fastest, then y, then z.
+         */
+        class Cube
+        {
+            //  == FIELDS ==
+          private:
+            //  -- Size --
+            const size_t m_res; //! Number of voxels along each side of the cube.
+
+            //  -- Data --
+            std::vector<double> m_data; //! Voxel data of the cube.
+
+
+            //  == INSTANTIATION ==
+          public:
+            //  -- Constructors --
+            explicit Cube(size_t t_res);
+
+
+            //  == METHODS ==
+          public:
+            //  -- Getters --
+            size_t get_res() const { return (m_res); }
+            double get_voxel(const size_t t_x, const size_t t_y, const size_t t_z) const
+            {
+                return (m_data[(((t_z * m_res) + t_y) * m_res) + t_x]);
+            }
+            double get_max_value() const;
+
+            //  -- Setters --
+            void fill(size_t t_x, size_t t_y, size_t t_z, size_t t_size, double t_value);
+
+            //  -- Saving --
+            void save(const std::string& t_path, const std::array<double, 3>& t_min_bound,
+                      const std::array<double, 3>& t_max_bound) const;
+            void save_slices(const std::string& t_output_dir, size_t t_dimension, double t_norm,
+                             Image::format t_format) const;
+        };
+
+
+
+    } // namespace data
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_DATA_CUBE_HPP
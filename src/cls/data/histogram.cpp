@@ -13,9 +13,16 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <cstdint>
+#include <fstream>
+
 //  -- General --
 #include "gen/log.hpp"
 
+//  -- Utility --
+#include "utl/stream.hpp"
+
 //  -- Classes --
 #include "cls/data/table.hpp"
 #include "cls/file/handle.hpp"
@@ -47,6 +54,8 @@ namespace arc
                              const bool t_dynamic) :
             m_min_bound(t_min_bound),
             m_max_bound(t_max_bound),
+            m_init_min_bound(t_min_bound),
+            m_init_max_bound(t_max_bound),
             m_bin_width((m_max_bound - m_min_bound) / t_num_bins),
             m_data(t_num_bins),
             m_dynamic(t_dynamic)
@@ -58,6 +67,56 @@ namespace arc
 
 
         //  == OPERATORS ==
+        //  -- Mathematical --
+        /**
+         *  Add the bin counts of another histogram to this histogram.
+         *  Dynamic histograms which have grown to different ranges are grown to the larger of the two ranges first.
+         *
+         *  @param  t_rhs   Histogram to add to this histogram.
+         *
+         *  @pre    t_rhs must have the same number of bins as this histogram.
+         *
+         *  @post   m_min_bound must equal that of the added histogram.
+         *  @post   m_max_bound must equal that of the added histogram.
+         *
+         *  @return A reference to this histogram after the addition.
+         */
+        Histogram& Histogram::operator+=(const Histogram& t_rhs)
+        {
+            assert(m_data.size() == t_rhs.m_data.size());
+
+            // Grow the histograms until their ranges match.
+            Histogram rhs = t_rhs;
+            while ((rhs.m_max_bound - m_max_bound) > (0.5 * m_bin_width))
+            {
+                ascend();
+            }
+            while ((m_max_bound - rhs.m_max_bound) > (0.5 * rhs.m_bin_width))
+            {
+                rhs.ascend();
+            }
+            while ((m_min_bound - rhs.m_min_bound) > (0.5 * m_bin_width))
+            {
+                descend();
+            }
+            while ((rhs.m_min_bound - m_min_bound) > (0.5 * rhs.m_bin_width))
+            {
+                rhs.descend();
+            }
+
+            assert(std::fabs(m_min_bound - rhs.m_min_bound) <= (0.5 * m_bin_width));
+            assert(std::fabs(m_max_bound - rhs.m_max_bound) <= (0.5 * m_bin_width));
+
+            // Add the bin counts.
+            for (size_t i = 0; i < m_data.size(); ++i)
+            {
+                m_data[i] += rhs.m_data[i];
+            }
+
+            return (*this);
+        }
+
+
         //  -- Printing --
         /**
          *  Enable printing of a histogram to a given ostream.
@@ -79,6 +138,27 @@ namespace arc
 
         //  == METHODS ==
         //  -- Getters --
+        /**
+         *  Determine a histogram format from its name.
+         *
+         *  @param  t_name  Name of the format, either "text" or "raw".
+         *
+         *  @return The named histogram format.
+         */
+        Histogram::format Histogram::get_format(const std::string& t_name)
+        {
+            if (t_name == "text")
+            {
+                return (format::TEXT);
+            }
+            if (t_name == "raw")
+            {
+                return (format::RAW);
+            }
+
+            ERROR("Unable to determine histogram format.", "Histogram format: '" << t_name << "' is not recognised.");
+        }
+
         /**
          *  Create a vector of bin positions.
          *
@@ -141,6 +221,25 @@ namespace arc
             return (m_min_bound + (m_bin_width * (utl::max_index(m_data) + 0.5)));
         }
 
+        /**
+         *  Determine the bin a value falls within.
+         *  A value upon the maximum bound falls within the last bin.
+         *
+         *  @param  t_val   Value to find the bin of.
+         *
+         *  @pre    t_val must be within the bounds of the histogram.
+         *
+         *  @return The index of the bin holding the value.
+         */
+        size_t Histogram::get_bin(const double t_val) const
+        {
+            assert((t_val >= m_min_bound) && (t_val <= m_max_bound));
+
+            const auto r_bin = static_cast<size_t>((t_val - m_min_bound) / m_bin_width);
+
+            return ((r_bin == m_data.size()) ? (r_bin - 1) : r_bin);
+        }
+
 
         //  -- Collection --
         /**
@@ -186,11 +285,50 @@ namespace arc
                 }
             }
 
-            assert((t_val >= m_min_bound) && (t_val <= m_max_bound));
+            m_data[get_bin(t_val)] += t_weight;
+        }
 
-            const auto bin = static_cast<size_t>((t_val - m_min_bound) / m_bin_width);
+        /**
+         *  Add a weight directly to a given bin.
+         *
+         *  @param  t_bin       Index of the bin to add to.
+         *  @param  t_weight    Weight to add.
+         *
+         *  @pre    t_bin must be less than get_num_bin.
+         */
+        void Histogram::add_to_bin(const size_t t_bin, const double t_weight)
+        {
+            assert(t_bin < m_data.size());
+
+            m_data[t_bin] += t_weight;
+        }
+
+        /**
+         *  Empty all bins of the histogram.
+         *  The bounds of a dynamic histogram which has grown are restored to those it was constructed with, so the
+         *  bins a value falls within never depend upon values binned before the histogram was cleared.
+         */
+        void Histogram::clear()
+        {
+            m_min_bound = m_init_min_bound;
+            m_max_bound = m_init_max_bound;
+            m_bin_width = (m_max_bound - m_min_bound) / m_data.size();
+
+            std::fill(m_data.begin(), m_data.end(), 0.0);
+        }
 
-            (bin == m_data.size()) ? m_data[bin - 1] += t_weight : m_data[bin] += t_weight;
+        /**
+         *  Empty a single bin of the histogram.
+         *
+         *  @param  t_bin   Index of the bin to empty.
+         *
+         *  @pre    t_bin must be less than get_num_bin.
+         */
+        void Histogram::clear_bin(const size_t t_bin)
+        {
+            assert(t_bin < m_data.size());
+
+            m_data[t_bin] = 0.0;
         }
 
 
@@ -213,18 +351,64 @@ namespace arc
             return (stream.str());
         }
 
+        /**
+         *  Write the bounds and bin counts of the histogram to a given stream as raw binary.
+         *
+         *  @param  t_stream    Stream to write to.
+         */
+        void Histogram::write_binary(std::ostream& t_stream) const
+        {
+            utl::write_binary(t_stream, m_min_bound);
+            utl::write_binary(t_stream, m_max_bound);
+            utl::write_binary(t_stream, m_bin_width);
+            utl::write_binary(t_stream, m_data);
+        }
+
+        /**
+         *  Read the bounds and bin counts of the histogram from a stream written by write_binary.
+         *
+         *  @param  t_stream    Stream to read from.
+         */
+        void Histogram::read_binary(std::istream& t_stream)
+        {
+            std::vector<double> data;
+
+            utl::read_binary(t_stream, m_min_bound);
+            utl::read_binary(t_stream, m_max_bound);
+            utl::read_binary(t_stream, m_bin_width);
+            utl::read_binary(t_stream, data);
+
+            if (!t_stream || (data.size() != m_data.size()))
+            {
+                ERROR("Unable to read histogram.", "Stored histogram does not match the number of bins.");
+            }
+
+            m_data = data;
+        }
+
 
         //  -- Saving --
         /**
-         *  Save the state of the histogram to a given file path.
+         *  Save the state of the histogram to a given file path, in a given format.
+         *  The file extension is determined by the format.
+         *  The raw format holds the bounds and the un-normalised counts, so ignores the normalisation and alignment.
          *
-         *  @param  t_path      Path to the save location of the file.
+         *  @param  t_path      Path to the save location of the file, excluding the extension.
          *  @param  t_normalise When true, normalise the count data to a maximum of unity.
          *  @param  t_align     Alignment position of the bin.
+         *  @param  t_format    Format to save the histogram as.
          */
-        void Histogram::save(const std::string& t_path, const bool t_normalise, const align t_align) const
+        void Histogram::save(const std::string& t_path, const bool t_normalise, const align t_align,
+                             const format t_format) const
         {
-            file::Handle file(t_path, std::fstream::out);
+            if (t_format == format::RAW)
+            {
+                write_raw(t_path + ".raw");
+
+                return;
+            }
+
+            file::Handle file(t_path + ".dat", std::fstream::out);
 
             switch (t_align)
             {
@@ -247,6 +431,29 @@ namespace arc
             file << serialise(t_normalise, t_align);
         }
 
+        /**
+         *  Write the histogram to a given file path as raw little-endian values, following a small header.
+         *  The header holds the tag and the number of bins as a 64 bit integer, followed by the minimum and maximum bounds.
+         *  Bin counts follow in order of increasing bin position.
+         *
+         *  @param  t_path  Path to the save location of the file.
+         */
+        void Histogram::write_raw(const std::string& t_path) const
+        {
+            std::ofstream file(t_path, std::ios::binary);
+
+            file.write(RAW_HISTOGRAM_TAG, sizeof(RAW_HISTOGRAM_TAG) - 1);
+            utl::write_little_endian(file, static_cast<std::uint64_t>(m_data.size()));
+            utl::write_little_endian(file, m_min_bound);
+            utl::write_little_endian(file, m_max_bound);
+            utl::write_little_endian(file, m_data.data(), m_data.size());
+
+            if (!file)
+            {
+                ERROR("Unable to save data::Histogram.", "Unable to write file: '" << t_path << "'.");
+            }
+        }
+
 
         //  -- Growth --
         /**
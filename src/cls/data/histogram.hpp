@@ -15,7 +15,9 @@
 
 //  == INCLUDES ==
 //  -- System --
+#include <istream>
 #include <ostream>
+#include <string>
 #include <vector>
 
 
@@ -28,6 +30,12 @@ namespace arc
 
 
 
+        //  == SETTINGS ==
+        //  -- Raw Output --
+        constexpr const char RAW_HISTOGRAM_TAG[] = "ARCHISTO";  //! Tag beginning each raw histogram file.
+
+
+
         //  == CLASS ==
         /**
          *  Collects double values and bins them into an array of bins.
@@ -47,12 +55,24 @@ namespace arc
                 RIGHT   //! Save bin right position.
             };
 
+            //  -- Format --
+            /**
+             *  Enumeration of the file formats a histogram may be saved as.
+             */
+            enum class format
+            {
+                TEXT,   //! Ascii table of bin positions and counts.
+                RAW     //! Little-endian float64 bounds and counts, following a small header.
+            };
+
 
             //  == FIELDS ==
           private:
             //  -- Bounds --
-            double m_min_bound; //! Minimum bound of the histogram range.
-            double m_max_bound; //! Minimum bound of the histogram range.
+            double       m_min_bound;       //! Minimum bound of the histogram range.
+            double       m_max_bound;       //! Minimum bound of the histogram range.
+            const double m_init_min_bound;  //! Minimum bound the histogram was constructed with.
+            const double m_init_max_bound;  //! Maximum bound the histogram was constructed with.
 
             //  -- Data --
             double              m_bin_width;    //! Width of the histogram bins.
@@ -70,6 +90,9 @@ namespace arc
 
             //  == OPERATORS ==
           public:
+            //  -- Mathematical --
+            Histogram& operator+=(const Histogram& t_rhs);
+
             //  -- Printing --
             friend std::ostream& operator<<(std::ostream& t_stream, const Histogram& t_hist);
 
@@ -77,6 +100,7 @@ namespace arc
             //  == METHODS ==
           public:
             //  -- Getters --
+            static format get_format(const std::string& t_name);
             double get_min_bound() const { return (m_min_bound); }
             double get_max_bound() const { return (m_max_bound); }
             double get_bin_width() const { return (m_bin_width); }
@@ -84,15 +108,27 @@ namespace arc
             std::vector<double> get_bin_pos(align t_align = align::CENTER) const;
             double get_average() const;
             double get_most_probable() const;
+            size_t get_bin(double t_val) const;
+            double get_count(size_t t_bin) const { return (m_data[t_bin]); }
 
             //  -- Collection --
             void bin_value(double t_val, double t_weight = 1.0);
+            void add_to_bin(size_t t_bin, double t_weight);
+            void clear();
+            void clear_bin(size_t t_bin);
 
             //  -- Serialisation --
             std::string serialise(bool t_normalise = false, align t_align = align::CENTER) const;
+            void write_binary(std::ostream& t_stream) const;
+            void read_binary(std::istream& t_stream);
 
             //  -- Saving --
-            void save(const std::string& t_path, bool t_normalise = false, align t_align = align::CENTER) const;
+            void save(const std::string& t_path, bool t_normalise = false, align t_align = align::CENTER,
+                      format t_format = format::TEXT) const;
+
+          private:
+            //  -- Saving --
+            void write_raw(const std::string& t_path) const;
 
 
           public:
@@ -13,10 +13,19 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+
 //  -- General --
 #include "gen/enum.hpp"
 #include "gen/log.hpp"
 
+//  -- Utility --
+#include "utl/stream.hpp"
+
 //  -- Classes --
 #include "cls/file/handle.hpp"
 
@@ -39,13 +48,40 @@ namespace arc
          *  @param  t_height    Height of the image.
          */
         Image::Image(const size_t t_width, const size_t t_height) :
-            m_data(std::vector<std::vector<std::array<double, 3>>>(t_width, std::vector<std::array<double, 3>>(t_height)))
+            m_width(t_width),
+            m_height(t_height),
+            m_data(3 * t_width * t_height, 0.0)
         {
         }
 
 
 
         //  == OPERATORS ==
+        //  -- Mathematical --
+        /**
+         *  Add the pixel values of another image to this image.
+         *
+         *  @param  t_rhs   Image to add to this image.
+         *
+         *  @pre    t_rhs must have the same width as this image.
+         *  @pre    t_rhs must have the same height as this image.
+         *
+         *  @return A reference to this image after the addition.
+         */
+        Image& Image::operator+=(const Image& t_rhs)
+        {
+            assert(t_rhs.get_width() == get_width());
+            assert(t_rhs.get_height() == get_height());
+
+            for (size_t i = 0; i < m_data.size(); ++i)
+            {
+                m_data[i] += t_rhs.m_data[i];
+            }
+
+            return (*this);
+        }
+
+
         //  -- Printing --
         /**
          *  Enable printing of an image to a given ostream.
@@ -58,22 +94,9 @@ namespace arc
         std::ostream& operator<<(std::ostream& t_stream, const Image& t_image)
         {
             // Determine the maximum of the file.
-            double      max = 0.0;
-            for (size_t i   = 0; i < t_image.get_height(); ++i)
-            {
-                for (size_t j = 0; j < t_image.get_width(); ++j)
-                {
-                    for (size_t k = 0; k < 3; ++k)
-                    {
-                        if (t_image.m_data[i][j][k] > max)
-                        {
-                            max = t_image.m_data[i][j][k];
-                        }
-                    }
-                }
-            }
+            const std::array<double, 3> max = t_image.get_max_value();
 
-            t_stream << t_image.serialise(max);
+            t_stream << t_image.serialise(std::max({max[R], max[G], max[B]}));
 
             return (t_stream);
         }
@@ -82,6 +105,39 @@ namespace arc
 
         //  == METHODS ==
         //  -- Getters --
+        /**
+         *  Determine an image format from its name.
+         *
+         *  @param  t_name  Name of the format, one of "ppm_ascii", "ppm", "pfm", "raw32" or "raw64".
+         *
+         *  @return The named image format.
+         */
+        Image::format Image::get_format(const std::string& t_name)
+        {
+            if (t_name == "ppm_ascii")
+            {
+                return (format::PPM_ASCII);
+            }
+            if (t_name == "ppm")
+            {
+                return (format::PPM);
+            }
+            if (t_name == "pfm")
+            {
+                return (format::PFM);
+            }
+            if (t_name == "raw32")
+            {
+                return (format::RAW32);
+            }
+            if (t_name == "raw64")
+            {
+                return (format::RAW64);
+            }
+
+            ERROR("Unable to determine image format.", "Image format: '" << t_name << "' is not recognised.");
+        }
+
         /**
          *  Determine the maximum rgb pixel value within the data.
          *
@@ -93,16 +149,13 @@ namespace arc
             std::array<double, 3> r_max({{0.0, 0.0, 0.0}});
 
             // Check each pixel for the maximum.
-            for (size_t i = 0; i < get_width(); ++i)
+            for (size_t i = 0; i < m_data.size(); i += 3)
             {
-                for (size_t j = 0; j < get_height(); ++j)
+                for (size_t k = 0; k < 3; ++k)
                 {
-                    for (size_t k = 0; k < 3; ++k)
+                    if (m_data[i + k] > r_max[k])
                     {
-                        if (m_data[i][j][k] > r_max[k])
-                        {
-                            r_max[k] = m_data[i][j][k];
-                        }
+                        r_max[k] = m_data[i + k];
                     }
                 }
             }
@@ -110,6 +163,27 @@ namespace arc
             return (r_max);
         }
 
+        /**
+         *  Get the value of a given pixel.
+         *
+         *  @param  t_row   Row of the pixel.
+         *  @param  t_col   Column of the pixel.
+         *
+         *  @pre    t_row must be less than get_width.
+         *  @pre    t_col must be less than get_height.
+         *
+         *  @return The rgb value of the pixel.
+         */
+        std::array<double, 3> Image::get_pixel(const size_t t_row, const size_t t_col) const
+        {
+            assert(t_row < get_width());
+            assert(t_col < get_height());
+
+            const size_t pix = 3 * ((t_col * m_width) + t_row);
+
+            return (std::array<double, 3>({{m_data[pix + R], m_data[pix + G], m_data[pix + B]}}));
+        }
+
 
         //  -- Setters --
         /**
@@ -127,9 +201,40 @@ namespace arc
             assert(t_row < get_width());
             assert(t_col < get_height());
 
-            m_data[t_row][t_col][R] += t_data[R];
-            m_data[t_row][t_col][G] += t_data[G];
-            m_data[t_row][t_col][B] += t_data[B];
+            const size_t pix = 3 * ((t_col * m_width) + t_row);
+
+            m_data[pix + R] += t_data[R];
+            m_data[pix + G] += t_data[G];
+            m_data[pix + B] += t_data[B];
+        }
+
+        /**
+         *  Set the value of every pixel of the image to zero.
+         */
+        void Image::clear()
+        {
+            std::fill(m_data.begin(), m_data.end(), 0.0);
+        }
+
+        /**
+         *  Set the value of a given pixel to zero.
+         *
+         *  @param  t_row   Row of the pixel.
+         *  @param  t_col   Column of the pixel.
+         *
+         *  @pre    t_row must be less than get_width.
+         *  @pre    t_col must be less than get_height.
+         */
+        void Image::clear_pixel(const size_t t_row, const size_t t_col)
+        {
+            assert(t_row < get_width());
+            assert(t_col < get_height());
+
+            const size_t pix = 3 * ((t_col * m_width) + t_row);
+
+            m_data[pix + R] = 0.0;
+            m_data[pix + G] = 0.0;
+            m_data[pix + B] = 0.0;
         }
 
 
@@ -153,10 +258,6 @@ namespace arc
             {
                 WARN("Unable to serialise data::Image.", "No data to form into image.");
             }
-            if (m_data.front().empty())
-            {
-                WARN("Unable to serialise data::Image.", "No data to form into image.");
-            }
 
             // Create a stream to write to.
             std::stringstream stream;
@@ -171,7 +272,8 @@ namespace arc
                 {
                     for (size_t k = 0; k < 3; ++k)
                     {
-                        stream << std::min(255, static_cast<int>(225 * (m_data[j][i][k] / t_norm))) << "\t";
+                        stream << std::min(255, static_cast<int>(225 * (m_data[(3 * ((i * m_width) + j)) + k] / t_norm)))
+                               << "\t";
                     }
                     stream << "\t";
                 }
@@ -181,19 +283,193 @@ namespace arc
             return (stream.str());
         }
 
+        /**
+         *  Write the dimensions and pixel values of the image to a given stream as raw binary.
+         *
+         *  @param  t_stream    Stream to write to.
+         */
+        void Image::write_binary(std::ostream& t_stream) const
+        {
+            utl::write_binary(t_stream, static_cast<unsigned long int>(get_width()));
+            utl::write_binary(t_stream, static_cast<unsigned long int>(get_height()));
+            utl::write_binary(t_stream, m_data);
+        }
+
+        /**
+         *  Read the pixel values of the image from a stream written by write_binary.
+         *
+         *  @param  t_stream    Stream to read from.
+         */
+        void Image::read_binary(std::istream& t_stream)
+        {
+            unsigned long int width  = 0;
+            unsigned long int height = 0;
+            utl::read_binary(t_stream, width);
+            utl::read_binary(t_stream, height);
+
+            if (!t_stream || (width != get_width()) || (height != get_height()))
+            {
+                ERROR("Unable to read image.", "Stored image does not match the image dimensions.");
+            }
+
+            utl::read_binary(t_stream, m_data);
+
+            if (!t_stream || (m_data.size() != (3 * m_width * m_height)))
+            {
+                ERROR("Unable to read image.", "Stored image is incomplete.");
+            }
+        }
+
 
         //  -- Saving --
         /**
-         *  Save the state of the image to a given file path.
+         *  Save the state of the image to a given file path, in a given format.
+         *  The file extension is determined by the format.
+         *  Raw formats hold the un-normalised pixel values for analysis, so ignore the normalisation value.
          *
-         *  @param  t_path  Path to the save location of the file.
-         *  @param  t_norm  Normalisation value.
+         *  @param  t_path      Path to the save location of the file, excluding the extension.
+         *  @param  t_norm      Normalisation value.
+         *  @param  t_format    Format to save the image as.
+         */
+        void Image::save(const std::string& t_path, const double t_norm, const format t_format) const
+        {
+            // The ascii format is written through a file handle as before.
+            if (t_format == format::PPM_ASCII)
+            {
+                file::Handle file(t_path + ".ppm", std::fstream::out, false);
+
+                file << serialise(t_norm);
+
+                return;
+            }
+
+            // Open a binary file with the extension of the format.
+            std::string extension;
+            switch (t_format)
+            {
+                case format::PPM:
+                    extension = ".ppm";
+                    break;
+                case format::PFM:
+                    extension = ".pfm";
+                    break;
+                case format::RAW32:
+                case format::RAW64:
+                    extension = ".raw";
+                    break;
+                default: ERROR("Unable to save data::Image.", "Code should be unreachable.");
+            }
+            std::ofstream file(t_path + extension, std::ios::binary);
+
+            // Write the image.
+            switch (t_format)
+            {
+                case format::PPM:
+                    write_ppm(file, t_norm);
+                    break;
+                case format::PFM:
+                    write_pfm(file, t_norm);
+                    break;
+                case format::RAW32:
+                    write_raw<float>(file);
+                    break;
+                case format::RAW64:
+                    write_raw<double>(file);
+                    break;
+                default: ERROR("Unable to save data::Image.", "Code should be unreachable.");
+            }
+
+            if (!file)
+            {
+                ERROR("Unable to save data::Image.", "Unable to write file: '" << t_path << extension << "'.");
+            }
+        }
+
+        /**
+         *  Write the image to a given stream as a binary portable pixmap.
+         *  Pixels are quantised exactly as the ascii format is.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_norm      Normalisation value.
+         *
+         *  @pre    t_norm must be greater than zero.
+         */
+        void Image::write_ppm(std::ostream& t_stream, const double t_norm) const
+        {
+            assert(t_norm > 0.0);
+
+            // Quantise each channel.
+            std::vector<unsigned char> pixels(m_data.size());
+            for (size_t i = 0; i < m_data.size(); ++i)
+            {
+                pixels[i] = static_cast<unsigned char>(std::min(255, static_cast<int>(225 * (m_data[i] / t_norm))));
+            }
+
+            // Write the header, then the pixels in one block.
+            t_stream << "P6\n" << get_width() << " " << get_height() << "\n255\n";
+            t_stream.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        }
+
+        /**
+         *  Write the image to a given stream as a little-endian portable float map.
+         *  Portable float maps store rows from the bottom of the image upwards.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_norm      Normalisation value.
+         *
+         *  @pre    t_norm must be greater than zero.
          */
-        void Image::save(const std::string& t_path, const double t_norm) const
+        void Image::write_pfm(std::ostream& t_stream, const double t_norm) const
         {
-            file::Handle file(t_path, std::fstream::out, false);
+            assert(t_norm > 0.0);
+
+            // Normalise each channel, flipping the row order.
+            const size_t       row_size = 3 * m_width;
+            std::vector<float> pixels(m_data.size());
+            for (size_t i = 0; i < m_height; ++i)
+            {
+                const size_t src = i * row_size;
+                const size_t dst = (m_height - 1 - i) * row_size;
+                for (size_t j = 0; j < row_size; ++j)
+                {
+                    pixels[dst + j] = static_cast<float>(m_data[src + j] / t_norm);
+                }
+            }
 
-            file << serialise(t_norm);
+            // Write the header, a negative scale marking little-endian data, then the pixels in one block.
+            t_stream << "PF\n" << get_width() << " " << get_height() << "\n-1.0\n";
+            utl::write_little_endian(t_stream, pixels.data(), pixels.size());
+        }
+
+        /**
+         *  Write the un-normalised image to a given stream as raw little-endian values, following a small header.
+         *  The header holds the tag, then the width, height, number of channels and bytes per value as 64 bit integers.
+         *  Values follow row by row, with the three colour channels of each pixel adjacent.
+         *
+         *  @tparam T   Type to write the values as.
+         *
+         *  @param  t_stream    Stream to write to.
+         */
+        template <typename T>
+        void Image::write_raw(std::ostream& t_stream) const
+        {
+            // Write the header.
+            t_stream.write(RAW_IMAGE_TAG, sizeof(RAW_IMAGE_TAG) - 1);
+            utl::write_little_endian(t_stream, static_cast<std::uint64_t>(m_width));
+            utl::write_little_endian(t_stream, static_cast<std::uint64_t>(m_height));
+            utl::write_little_endian(t_stream, static_cast<std::uint64_t>(3));
+            utl::write_little_endian(t_stream, static_cast<std::uint64_t>(sizeof(T)));
+
+            // Write the pixels in one block, converting them first if required.
+            if constexpr (std::is_same<T, double>::value)
+            {
+                utl::write_little_endian(t_stream, m_data.data(), m_data.size());
+            }
+            else
+            {
+                const std::vector<T> pixels(m_data.begin(), m_data.end());
+                utl::write_little_endian(t_stream, pixels.data(), pixels.size());
+            }
         }
 
 
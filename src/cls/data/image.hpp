@@ -16,6 +16,9 @@
 //  == INCLUDES ==
 //  -- System --
 #include <array>
+#include <istream>
+#include <ostream>
+#include <string>
 #include <vector>
 
 
@@ -28,16 +31,43 @@ namespace arc
 
 
 
+        //  == SETTINGS ==
+        //  -- Raw Output --
+        constexpr const char RAW_IMAGE_TAG[] = "ARCIMAGE";  //! Tag beginning each raw image file.
+
+
+
         //  == CLASS ==
         /**
          *  Image data writer.
+         *  Pixels are held within a single contiguous buffer, row by row, with the three colour channels of each pixel
+         *  adjacent, so images can be written with a single call.
          */
         class Image
         {
+            //  == ENUMERATIONS ==
+          public:
+            /**
+             *  Enumeration of the file formats an image may be saved as.
+             */
+            enum class format
+            {
+                PPM_ASCII,  //! Normalised ascii portable pixmap.
+                PPM,        //! Normalised binary portable pixmap.
+                PFM,        //! Normalised float32 portable float map.
+                RAW32,      //! Un-normalised little-endian float32 values, following a small header.
+                RAW64       //! Un-normalised little-endian float64 values, following a small header.
+            };
+
+
             //  == FIELDS ==
           private:
+            //  -- Size --
+            size_t m_width;     //! Width of the image in pixels.
+            size_t m_height;    //! Height of the image in pixels.
+
             //  -- Data --
-            std::vector<std::vector<std::array<double, 3>>> m_data; //! Pixel data of the image.
+            std::vector<double> m_data; //! Pixel data of the image, row by row.
 
 
             //  == INSTANTIATION ==
@@ -48,6 +78,9 @@ namespace arc
 
             //  == OPERATORS ==
           public:
+            //  -- Mathematical --
+            Image& operator+=(const Image& t_rhs);
+
             //  -- Printing --
             friend std::ostream& operator<<(std::ostream& t_stream, const Image& t_image);
 
@@ -55,18 +88,31 @@ namespace arc
             //  == METHODS ==
           public:
             //  -- Getters --
-            size_t get_width() const { return (m_data.size()); }
-            size_t get_height() const { return (m_data.front().size()); }
+            static format get_format(const std::string& t_name);
+            size_t get_width() const { return (m_width); }
+            size_t get_height() const { return (m_height); }
             std::array<double, 3> get_max_value() const;
+            std::array<double, 3> get_pixel(size_t t_row, size_t t_col) const;
 
             //  -- Setters --
             void add_to_pixel(size_t t_row, size_t t_col, const std::array<double, 3>& t_data);
+            void clear();
+            void clear_pixel(size_t t_row, size_t t_col);
 
             //  -- Serialisation --
             std::string serialise(double t_norm) const;
+            void write_binary(std::ostream& t_stream) const;
+            void read_binary(std::istream& t_stream);
 
             //  -- Saving --
-            void save(const std::string& t_path, double t_nor = 1.0) const;
+            void save(const std::string& t_path, double t_norm = 1.0, format t_format = format::PPM_ASCII) const;
+
+          private:
+            //  -- Saving --
+            void write_ppm(std::ostream& t_stream, double t_norm) const;
+            void write_pfm(std::ostream& t_stream, double t_norm) const;
+            template <typename T>
+            void write_raw(std::ostream& t_stream) const;
         };
 
 
@@ -13,9 +13,11 @@
 
 
 //  == INCLUDES ==
+//  -- General --
+#include "gen/config.hpp"
+
 //  -- Utility --
 #include "utl/colourmap.hpp"
-#include "utl/file.hpp"
 
 
 
@@ -44,26 +46,75 @@ namespace arc
         Ccd::Ccd(const std::string& t_name, const size_t t_width, const size_t t_height, const bool t_col,
                  const math::Vec<3>& t_trans, const math::Vec<3>& t_dir, const double t_spin, const math::Vec<3>& t_scale) :
             m_name(t_name),
-            m_mesh(utl::read(std::string(config::ARCTORUS_DIR) + "res/meshes/square.obj"), t_trans, t_dir, t_spin, t_scale),
+            m_mesh(geom::Mesh::load(std::string(config::ARCTORUS_DIR) + "res/meshes/square.obj", t_trans, t_dir, t_spin, t_scale)),
             m_norm(t_dir),
             m_col(t_col),
-            m_image(t_width, t_height)
+            m_image({data::Image(t_width, t_height)}),
+            m_touched(1)
         {
         }
 
 
 
         //  == METHODS ==
+        //  -- Getters --
+        /**
+         *  Reduce the images recorded by each slot into a single image.
+         *
+         *  @return The total image recorded by the detector.
+         */
+        data::Image Ccd::get_image() const
+        {
+            // Create the return image.
+            data::Image r_image = m_image.front();
+
+            // Add the images of the other slots.
+            for (size_t i = 1; i < m_image.size(); ++i)
+            {
+                r_image += m_image[i];
+            }
+
+            return (r_image);
+        }
+
+
         //  -- Setters --
+        /**
+         *  Set the number of slots which may record hits, giving each slot its own blank image.
+         *  The final slot holds the hits merged from the other slots, and its image is retained.
+         *
+         *  @param  t_num_slots Number of recording slots, including the final merged slot.
+         *
+         *  @pre    t_num_slots must not be zero.
+         */
+        void Ccd::set_num_slots(const size_t t_num_slots)
+        {
+            assert(t_num_slots != 0);
+
+            const data::Image total = m_image.back();
+
+            m_image = std::vector<data::Image>(t_num_slots - 1, data::Image(total.get_width(), total.get_height()));
+            m_image.push_back(total);
+            m_touched = std::vector<std::vector<size_t>>(t_num_slots);
+        }
+
         /**
          *  Add a hit to the detector.
+         *  Each slot is only ever recorded to by a single thread, so no locking is required.
+         *  The pixels given weight are listed, so a slot may be merged without visiting every pixel of the image.
          *
          *  @param  t_pos           Position of the hit.
          *  @param  t_weight        Weight of the hit.
          *  @param  t_wavelength    Wavelength of the hit.
+         *  @param  t_slot          Slot to record the hit within.
+         *
+         *  @pre    t_slot must be less than the number of slots set.
          */
-        void Ccd::add_hit(const math::Vec<3>& t_pos, const double t_weight, const double t_wavelength)
+        void Ccd::add_hit(const math::Vec<3>& t_pos, const double t_weight, const double t_wavelength,
+                          const size_t t_slot)
         {
+            assert(t_slot < m_image.size());
+
             const math::Vec<3> alpha = m_mesh.get_tri(1).get_pos(1);
             const math::Vec<3> beta  = m_mesh.get_tri(1).get_pos(2);
             const math::Vec<3> gamma = m_mesh.get_tri(1).get_pos(0);
@@ -80,13 +131,82 @@ namespace arc
             assert ((x >= 0.0) && (x <= 1.0));
             assert ((y >= 0.0) && (y <= 1.0));
 
-            const auto pix_x = static_cast<size_t>(x * m_image.get_width());
-            const auto pix_y = static_cast<size_t>(y * m_image.get_height());
+            data::Image& image = m_image[t_slot];
+
+            const auto pix_x = static_cast<size_t>(x * image.get_width());
+            const auto pix_y = static_cast<size_t>(y * image.get_height());
 
             const std::array<double, 3> col = m_col ? utl::colourmap::transform_rainbow((t_wavelength - 400E-9) / 300E-9)
                                                     : std::array<double, 3>({{1.0, 1.0, 1.0}});
 
-            m_image.add_to_pixel(pix_x, pix_y, {{t_weight * col[R], t_weight * col[G], t_weight * col[B]}});
+            const std::array<double, 3> pix = image.get_pixel(pix_x, pix_y);
+            if ((pix[R] == 0.0) && (pix[G] == 0.0) && (pix[B] == 0.0))
+            {
+                m_touched[t_slot].push_back((pix_y * image.get_width()) + pix_x);
+            }
+            image.add_to_pixel(pix_x, pix_y, {{t_weight * col[R], t_weight * col[G], t_weight * col[B]}});
+        }
+
+        /**
+         *  Take the hits recorded within a slot as a list of the pixels given weight, and empty the slot.
+         *  Only the pixels given weight are visited.
+         *
+         *  @param  t_slot  Slot to take.
+         *
+         *  @pre    t_slot must be less than the index of the final slot.
+         *
+         *  @return The indices and values of the pixels given weight, in the order they were first given weight.
+         */
+        Ccd::pixels Ccd::take_slot(const size_t t_slot)
+        {
+            assert(t_slot < (m_image.size() - 1));
+
+            // Create the return list.
+            pixels r_pixels;
+            r_pixels.reserve(m_touched[t_slot].size());
+
+            data::Image& image = m_image[t_slot];
+            for (size_t i = 0; i < m_touched[t_slot].size(); ++i)
+            {
+                const size_t pix_x = m_touched[t_slot][i] % image.get_width();
+                const size_t pix_y = m_touched[t_slot][i] / image.get_width();
+
+                r_pixels.emplace_back(m_touched[t_slot][i], image.get_pixel(pix_x, pix_y));
+                image.clear_pixel(pix_x, pix_y);
+            }
+            m_touched[t_slot].clear();
+
+            return (r_pixels);
+        }
+
+        /**
+         *  Add a list of pixel values, taken from a slot, to the final slot.
+         *
+         *  @param  t_pixels    Indices and values of the pixels to add.
+         */
+        void Ccd::add_pixels(const pixels& t_pixels)
+        {
+            data::Image& image = m_image.back();
+            for (size_t i = 0; i < t_pixels.size(); ++i)
+            {
+                image.add_to_pixel(t_pixels[i].first % image.get_width(), t_pixels[i].first / image.get_width(),
+                                   t_pixels[i].second);
+            }
+        }
+
+
+        //  -- Checkpointing --
+        /**
+         *  Read an image from a stream written by data::Image::write_binary, and add it to the final slot.
+         *
+         *  @param  t_stream    Stream to read from.
+         */
+        void Ccd::read_binary(std::istream& t_stream)
+        {
+            data::Image image(m_image.back().get_width(), m_image.back().get_height());
+            image.read_binary(t_stream);
+
+            m_image.back() += image;
         }
 
 
@@ -96,14 +216,15 @@ namespace arc
          *
          *  @param  t_output_dir    Directory to write the images to.
          *  @param  t_norm          Normalisation value.
+         *  @param  t_format        Format to save the image as.
          *
          *  @pre    t_norm must be greater than zero.
          */
-        void Ccd::save(const std::string& t_output_dir, double t_norm) const
+        void Ccd::save(const std::string& t_output_dir, double t_norm, const data::Image::format t_format) const
         {
             assert(t_norm > 0.0);
 
-            m_image.save(t_output_dir + m_name + ".ppm", t_norm);
+            get_image().save(t_output_dir + m_name, t_norm, t_format);
         }
 
 
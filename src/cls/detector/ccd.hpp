@@ -14,6 +14,11 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <utility>
+#include <vector>
+
 //  -- Classes --
 #include "cls/data/image.hpp"
 #include "cls/geom/mesh.hpp"
@@ -35,18 +40,25 @@ namespace arc
          */
         class Ccd
         {
+            //  == TYPES ==
+          public:
+            //  -- Data --
+            using pixels = std::vector<std::pair<size_t, std::array<double, 3>>>;  //! Pixel indices and their values.
+
+
             //  == FIELDS ==
           private:
             //  -- Properties --
             const std::string  m_name;  //! Name of the ccd.
-            const geom::Mesh   m_mesh;  //! Mesh describing the surface of the detector.
+            geom::Mesh         m_mesh;  //! Mesh describing the surface of the detector.
             const math::Vec<3> m_norm;  //! Normal direction.
 
             //  -- Settings --
             const bool m_col;   //! If true save the image as wavelength colours. Otherwise save as greyscale intensity.
 
             //  -- Data --
-            data::Image m_image;        //! Ccd image data.
+            std::vector<data::Image>         m_image;   //! Ccd image data recorded by each slot.
+            std::vector<std::vector<size_t>> m_touched; //! Pixel indices given weight within each slot.
 
 
             //  == INSTANTIATION ==
@@ -61,15 +73,27 @@ namespace arc
             //  == METHODS ==
           public:
             //  -- Getters --
+            const std::string& get_name() const { return (m_name); }
             const geom::Mesh& get_mesh() const { return (m_mesh); }
             const math::Vec<3>& get_norm() const { return (m_norm); }
-            std::array<double, 3> get_max_value() const { return (m_image.get_max_value()); }
+            size_t get_width() const { return (m_image.back().get_width()); }
+            size_t get_height() const { return (m_image.back().get_height()); }
+            std::array<double, 3> get_max_value() const { return (get_image().get_max_value()); }
+            data::Image get_image() const;
+            const data::Image& get_merged_image() const { return (m_image.back()); }
 
             //  -- Setters --
-            void add_hit(const math::Vec<3>& t_pos, double t_weight, double t_wavelength);
+            void set_num_slots(size_t t_num_slots);
+            void add_hit(const math::Vec<3>& t_pos, double t_weight, double t_wavelength, size_t t_slot);
+            pixels take_slot(size_t t_slot);
+            void add_pixels(const pixels& t_pixels);
+
+            //  -- Checkpointing --
+            void read_binary(std::istream& t_stream);
 
             //  -- Save --
-            void save(const std::string& t_output_dir, double t_norm) const;
+            void save(const std::string& t_output_dir, double t_norm,
+                      data::Image::format t_format = data::Image::format::PPM_ASCII) const;
         };
 
 
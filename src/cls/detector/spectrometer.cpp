@@ -35,11 +35,12 @@ namespace arc
          *  @pre    t_min_bound must be less than t_max_bound.
          *  @pre    t_num_bins must be positive.
          */
-        Spectrometer::Spectrometer(const std::string& t_name, const geom::Mesh& t_mesh, const double t_min_bound,
+        Spectrometer::Spectrometer(const std::string& t_name, geom::Mesh&& t_mesh, const double t_min_bound,
                                    const double t_max_bound, const size_t t_num_bins) :
             m_name(t_name),
-            m_mesh(t_mesh),
-            m_data(t_min_bound, t_max_bound, t_num_bins)
+            m_mesh(std::move(t_mesh)),
+            m_data({data::Histogram(t_min_bound, t_max_bound, t_num_bins)}),
+            m_touched(1)
         {
             assert(t_min_bound >= 0.0);
             assert(t_min_bound < t_max_bound);
@@ -49,29 +50,142 @@ namespace arc
 
 
         //  == METHODS ==
+        //  -- Getters --
+        /**
+         *  Reduce the histograms recorded by each slot into a single histogram.
+         *
+         *  @return The total wavelength histogram recorded by the spectrometer.
+         */
+        data::Histogram Spectrometer::get_data() const
+        {
+            // Create the return histogram.
+            data::Histogram r_data = m_data.front();
+
+            // Add the histograms of the other slots.
+            for (size_t i = 1; i < m_data.size(); ++i)
+            {
+                r_data += m_data[i];
+            }
+
+            return (r_data);
+        }
+
+
         //  -- Setters --
+        /**
+         *  Set the number of slots which may record hits, giving each slot its own empty histogram.
+         *  The final slot holds the hits merged from the other slots, and its histogram is retained.
+         *
+         *  @param  t_num_slots Number of recording slots, including the final merged slot.
+         *
+         *  @pre    t_num_slots must not be zero.
+         */
+        void Spectrometer::set_num_slots(const size_t t_num_slots)
+        {
+            assert(t_num_slots != 0);
+
+            const data::Histogram total = m_data.back();
+
+            m_data = std::vector<data::Histogram>(t_num_slots - 1, data::Histogram(total.get_min_bound(),
+                                                                                   total.get_max_bound(),
+                                                                                   total.get_num_bin()));
+            m_data.push_back(total);
+            m_touched = std::vector<std::vector<size_t>>(t_num_slots);
+        }
+
         /**
          *  Add a hit to the spectrometer.
+         *  Each slot is only ever recorded to by a single thread, so no locking is required.
+         *  The bins given weight are listed, so a slot may be merged without visiting every bin of the histogram.
          *
          *  @param  t_wavelength    Wavelength to be binned.
          *  @param  t_weight        Statistical weight of the value.
+         *  @param  t_slot          Slot to record the hit within.
          *
          *  @pre    t_wavelength must be non-negative.
          *  @pre    t_weight must be non-negative.
+         *  @pre    t_slot must be less than the number of slots set.
          */
-        void Spectrometer::add_hit(const double t_wavelength, const double t_weight)
+        void Spectrometer::add_hit(const double t_wavelength, const double t_weight, const size_t t_slot)
         {
             assert(t_wavelength >= 0.0);
             assert(t_weight >= 0.0);
+            assert(t_slot < m_data.size());
+
+            data::Histogram& hist = m_data[t_slot];
 
             // Check if wavelength is outside of recorded range.
-            if ((t_wavelength < m_data.get_min_bound()) || (t_wavelength > m_data.get_max_bound()))
+            if ((t_wavelength < hist.get_min_bound()) || (t_wavelength > hist.get_max_bound()))
             {
                 return;
             }
 
             // Bin the value.
-            m_data.bin_value(t_wavelength, t_weight);
+            const size_t bin = hist.get_bin(t_wavelength);
+            if (hist.get_count(bin) == 0.0)
+            {
+                m_touched[t_slot].push_back(bin);
+            }
+            hist.add_to_bin(bin, t_weight);
+        }
+
+        /**
+         *  Take the hits recorded within a slot as a list of the bins given weight, and empty the slot.
+         *  Only the bins given weight are visited.
+         *
+         *  @param  t_slot  Slot to take.
+         *
+         *  @pre    t_slot must be less than the index of the final slot.
+         *
+         *  @return The indices and counts of the bins given weight, in the order they were first given weight.
+         */
+        Spectrometer::bins Spectrometer::take_slot(const size_t t_slot)
+        {
+            assert(t_slot < (m_data.size() - 1));
+
+            // Create the return list.
+            bins r_bins;
+            r_bins.reserve(m_touched[t_slot].size());
+
+            data::Histogram& hist = m_data[t_slot];
+            for (size_t i = 0; i < m_touched[t_slot].size(); ++i)
+            {
+                const size_t bin = m_touched[t_slot][i];
+
+                r_bins.emplace_back(bin, hist.get_count(bin));
+                hist.clear_bin(bin);
+            }
+            m_touched[t_slot].clear();
+
+            return (r_bins);
+        }
+
+        /**
+         *  Add a list of bin counts, taken from a slot, to the final slot.
+         *
+         *  @param  t_bins  Indices and counts of the bins to add.
+         */
+        void Spectrometer::add_bins(const bins& t_bins)
+        {
+            for (size_t i = 0; i < t_bins.size(); ++i)
+            {
+                m_data.back().add_to_bin(t_bins[i].first, t_bins[i].second);
+            }
+        }
+
+
+        //  -- Checkpointing --
+        /**
+         *  Read a histogram from a stream written by data::Histogram::write_binary, and add it to the final slot.
+         *
+         *  @param  t_stream    Stream to read from.
+         */
+        void Spectrometer::read_binary(std::istream& t_stream)
+        {
+            data::Histogram hist(m_data.back().get_min_bound(), m_data.back().get_max_bound(), m_data.back().get_num_bin());
+            hist.read_binary(t_stream);
+
+            m_data.back() += hist;
         }
 
 
@@ -80,10 +194,11 @@ namespace arc
          *  Save the state of the spectrometer.
          *
          *  @param  t_output_dir    Directory to write the images to.
+         *  @param  t_format        Format to save the data as.
          */
-        void Spectrometer::save(const std::string& t_output_dir) const
+        void Spectrometer::save(const std::string& t_output_dir, const data::Histogram::format t_format) const
         {
-            m_data.save(t_output_dir + m_name + ".dat");
+            get_data().save(t_output_dir + m_name, false, data::Histogram::align::CENTER, t_format);
         }
 
 
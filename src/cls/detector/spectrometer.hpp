@@ -14,6 +14,10 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <utility>
+#include <vector>
+
 //  -- Classes --
 #include "cls/data/histogram.hpp"
 #include "cls/geom/mesh.hpp"
@@ -35,33 +39,53 @@ namespace arc
          */
         class Spectrometer
         {
+            //  == TYPES ==
+          public:
+            //  -- Data --
+            using bins = std::vector<std::pair<size_t, double>>;   //! Bin indices and their counts.
+
+
             //  == FIELDS ==
           private:
             //  -- Properties --
             const std::string m_name;   //! Name of the ccd.
-            const geom::Mesh  m_mesh;   //! Mesh describing the surface of the detector.
+            geom::Mesh        m_mesh;   //! Mesh describing the surface of the detector.
 
             //  -- Data --
-            data::Histogram m_data;         //! Wavelength data.
+            std::vector<data::Histogram>     m_data;    //! Wavelength data recorded by each slot.
+            std::vector<std::vector<size_t>> m_touched; //! Bin indices given weight within each slot.
 
 
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            Spectrometer(const std::string& t_name, const geom::Mesh& t_mesh, double t_min_bound, double t_max_bound,
+            Spectrometer(const std::string& t_name, geom::Mesh&& t_mesh, double t_min_bound, double t_max_bound,
                          size_t t_num_bins);
 
 
             //  == METHODS ==
           public:
             //  -- Getters --
+            const std::string& get_name() const { return (m_name); }
             const geom::Mesh& get_mesh() const { return (m_mesh); }
+            double get_min_bound() const { return (m_data.back().get_min_bound()); }
+            double get_max_bound() const { return (m_data.back().get_max_bound()); }
+            size_t get_num_bin() const { return (m_data.back().get_num_bin()); }
+            data::Histogram get_data() const;
+            const data::Histogram& get_merged_data() const { return (m_data.back()); }
 
             //  -- Setters --
-            void add_hit(double t_wavelength, double t_weight);
+            void set_num_slots(size_t t_num_slots);
+            void add_hit(double t_wavelength, double t_weight, size_t t_slot);
+            bins take_slot(size_t t_slot);
+            void add_bins(const bins& t_bins);
+
+            //  -- Checkpointing --
+            void read_binary(std::istream& t_stream);
 
             //  -- Save --
-            void save(const std::string& t_output_dir) const;
+            void save(const std::string& t_output_dir,
+                      data::Histogram::format t_format = data::Histogram::format::TEXT) const;
         };
 
 
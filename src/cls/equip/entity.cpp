@@ -28,8 +28,8 @@ namespace arc
          *  @param  t_mesh  Mesh to describe the boundaries of the entity.
          *  @param  t_mat   Material describing the optical properties of the entity.
          */
-        Entity::Entity(const geom::Mesh& t_mesh, const phys::Material& t_mat) :
-            m_mesh(t_mesh),
+        Entity::Entity(geom::Mesh&& t_mesh, const phys::Material& t_mat) :
+            m_mesh(std::move(t_mesh)),
             m_mat(t_mat)
         {
         }
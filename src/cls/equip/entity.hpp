@@ -37,14 +37,14 @@ namespace arc
             //  == FIELDS ==
           private:
             //  -- Properties --
-            const geom::Mesh     m_mesh;    //! Mesh describing the boundaries of the entity.
+            geom::Mesh           m_mesh;    //! Mesh describing the boundaries of the entity.
             const phys::Material m_mat;     //! Material describing the entities optical properties.
 
 
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            Entity(const geom::Mesh& t_mesh, const phys::Material& t_mat);
+            Entity(geom::Mesh&& t_mesh, const phys::Material& t_mat);
 
 
             //  == METHODS ==
@@ -31,8 +31,8 @@ namespace arc
          *
          *  @post   m_power must be greater than zero.
          */
-        Light::Light(const geom::Mesh& t_mesh, const phys::Spectrum& t_spec, const double t_power) :
-            m_mesh(t_mesh),
+        Light::Light(geom::Mesh&& t_mesh, const phys::Spectrum& t_spec, const double t_power) :
+            m_mesh(std::move(t_mesh)),
             m_spec(t_spec),
             m_tri_select(init_rand_tri()),
             m_power(t_power)
@@ -44,6 +44,7 @@ namespace arc
         //  -- Initialisation --
         /**
          *  Initialise the random triangle index generator.
+         *  Meshes may hold very many triangles, so the constant time alias method is used.
          *
          *  @return The random triangle index generator.
          */
@@ -58,7 +59,7 @@ namespace arc
                 r_tri_area[i] = m_mesh.get_tri(i).get_area();
             }
 
-            return (random::Index(r_tri_area));
+            return (random::Index(r_tri_area, random::Index::method::ALIAS));
         }
 
 
@@ -70,16 +71,17 @@ namespace arc
          *  material.
          *
          *  @param  t_mat   Material to sample initial optical properties from.
+         *  @param  t_rng   Random number generator to draw from.
          *
          *  @return The newly generated photon.
          */
-        phys::Photon Light::gen_photon(const phys::Material& t_mat) const
+        phys::Photon Light::gen_photon(const phys::Material& t_mat, random::Generator& t_rng) const
         {
             // Get a random position and normal from the tree.
             math::Vec<3> pos, norm;
-            std::tie(pos, norm) = m_mesh.get_tri(m_tri_select.gen_index()).gen_random_pos_and_norm();
+            std::tie(pos, norm) = m_mesh.get_tri(m_tri_select.gen_index(t_rng)).gen_random_pos_and_norm(t_rng);
 
-            return (phys::Photon(pos, norm, m_spec.gen_wavelength(), t_mat));
+            return (phys::Photon(pos, norm, m_spec.gen_wavelength(t_rng), t_mat));
         }
 
 
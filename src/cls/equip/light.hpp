@@ -40,7 +40,7 @@ namespace arc
             //  == FIELDS ==
           private:
             //  -- Properties --
-            const geom::Mesh     m_mesh;    //! Mesh describing the surface of the light.
+            geom::Mesh           m_mesh;    //! Mesh describing the surface of the light.
             const phys::Spectrum m_spec;    //! Linear random generator forming the emission spectrum.
 
             //  -- Sorting --
@@ -51,7 +51,7 @@ namespace arc
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            Light(const geom::Mesh& t_mesh, const phys::Spectrum& t_spec, double t_power);
+            Light(geom::Mesh&& t_mesh, const phys::Spectrum& t_spec, double t_power);
 
             //  -- Initialisation --
             random::Index init_rand_tri() const;
@@ -67,7 +67,7 @@ namespace arc
             double get_power() const { return (m_power); }
 
             //  -- Generation --
-            phys::Photon gen_photon(const phys::Material& t_mat) const;
+            phys::Photon gen_photon(const phys::Material& t_mat, random::Generator& t_rng) const;
         };
 
 
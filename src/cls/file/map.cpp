@@ -0,0 +1,123 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/file/map.hpp"
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//  -- General --
+#include "gen/config.hpp"
+#include "gen/log.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace file
+    {
+
+
+
+        //  == INSTANTIATION ==
+        //  -- Constructors --
+        /**
+         *  Construct a read-only mapping of a given file.
+         *
+         *  @param  t_path  Path to the file being mapped.
+         */
+        Map::Map(const std::string& t_path) :
+            m_path(init_path(t_path)),
+            m_size(0),
+            m_mod_time(0),
+            m_data(nullptr)
+        {
+            const int file = ::open(m_path.c_str(), O_RDONLY);
+            if (file < 0)
+            {
+                ERROR("Failed to construct file::Map object.", "The file: '" << m_path << "' could not be opened.");
+            }
+
+            struct stat info{};
+            if (::fstat(file, &info) != 0)
+            {
+                ::close(file);
+                ERROR("Failed to construct file::Map object.", "The file: '" << m_path << "' could not be inspected.");
+            }
+            m_size     = static_cast<size_t>(info.st_size);
+            m_mod_time = (static_cast<long long int>(info.st_mtim.tv_sec) * 1000000000LL) + info.st_mtim.tv_nsec;
+
+            // Empty files can not be mapped, but have no contents to read.
+            if (m_size > 0)
+            {
+                void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (data == MAP_FAILED)
+                {
+                    ::close(file);
+                    ERROR("Failed to construct file::Map object.", "The file: '" << m_path << "' could not be mapped.");
+                }
+                ::madvise(data, m_size, MADV_SEQUENTIAL);
+
+                m_data = static_cast<const char*>(data);
+            }
+
+            // The mapping remains valid once the descriptor is closed.
+            ::close(file);
+        }
+
+
+        //  -- Destructors --
+        /**
+         *  Release the mapping.
+         */
+        Map::~Map()
+        {
+            if (m_data != nullptr)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+        }
+
+
+        //  -- Initialisation --
+        /**
+         *  Locate the file to map, first relative to the working directory and then to the Arctorus directory.
+         *
+         *  @param  t_path  Path to the file being mapped.
+         *
+         *  @return The path of the file which can be read.
+         */
+        std::string Map::init_path(const std::string& t_path) const
+        {
+            if (::access(t_path.c_str(), R_OK) == 0)
+            {
+                return (t_path);
+            }
+
+            const std::string r_path = config::ARCTORUS_DIR + t_path;
+            if (::access(r_path.c_str(), R_OK) != 0)
+            {
+                ERROR("Failed to construct file::Map object.", "The file: '" << t_path << "' could not be opened.");
+            }
+
+            return (r_path);
+        }
+
+
+
+    } // namespace file
+} // namespace arc
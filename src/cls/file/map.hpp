@@ -0,0 +1,91 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_FILE_MAP_HPP
+#define ARCTORUS_SRC_CLS_FILE_MAP_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <string>
+#include <string_view>
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace file
+    {
+
+
+
+        //  == CLASS ==
+        /**
+         *  A read-only memory mapping of a given file.
+         *  The file is located in the same way as by file::Handle, relative to the current working directory first,
+         *  and then relative to the Arctorus top level directory.
+         *  The contents are paged in by the operating system as they are read, so are never copied into a string.
+         *  Upon destruction of the map object, the mapping is released.
+         */
+        class Map
+        {
+            //  == FIELDS ==
+          private:
+            //  -- Properties --
+            const std::string m_path;       //! Path to the opened file.
+            size_t            m_size;       //! Size of the file in bytes.
+            long long int     m_mod_time;   //! [ns] Last modification time of the file.
+
+            //  -- Mapping --
+            const char* m_data; //! Start of the mapped contents.
+
+
+            //  == INSTANTIATION ==
+          public:
+            //  -- Constructors --
+            Map(const Map& /*unused*/) = delete;
+            Map(const Map&& /*unused*/) = delete;
+            explicit Map(const std::string& t_path);
+
+            //  -- Destructors --
+            ~Map();
+
+          private:
+            //  -- Initialisation --
+            std::string init_path(const std::string& t_path) const;
+
+
+            //  == OPERATORS ==
+          public:
+            //  -- Copy --
+            Map& operator=(const Map& /*unused*/) = delete;
+            Map& operator=(const Map&& /*unused*/) = delete;
+
+
+            //  == METHODS ==
+          public:
+            //  -- Getters --
+            const std::string& get_path() const { return (m_path); }
+            size_t get_size() const { return (m_size); }
+            long long int get_mod_time() const { return (m_mod_time); }
+            std::string_view get_contents() const { return (std::string_view(m_data, m_size)); }
+        };
+
+
+
+    } // namespace file
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_FILE_MAP_HPP
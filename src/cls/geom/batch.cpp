@@ -0,0 +1,333 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/geom/batch.hpp"
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(ENABLE_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace geom
+    {
+
+
+
+        //  == METHODS ==
+        //  -- Setters --
+        /**
+         *  Add a triangle to the end of the batch.
+         *  When the padded storage is full it is extended by a block of degenerate triangles.
+         *  The bounding box is grown to contain the triangle, and padded in proportion to its largest extent.
+         *
+         *  @param  t_tri   Triangle to add.
+         */
+        void Batch::add_tri(const Triangle& t_tri)
+        {
+            const size_t index = m_num_tri;
+
+            // Extend the storage by a block if it is full.
+            if ((index % BATCH_WIDTH) == 0)
+            {
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    m_alpha[i].resize(index + BATCH_WIDTH, 0.0);
+                    m_edge_alpha_beta[i].resize(index + BATCH_WIDTH, 0.0);
+                    m_edge_alpha_gamma[i].resize(index + BATCH_WIDTH, 0.0);
+                }
+            }
+
+            // Calculate edge vectors sharing vertex alpha.
+            const math::Vec<3> edge_alpha_beta  = t_tri.get_pos(BETA) - t_tri.get_pos(ALPHA);
+            const math::Vec<3> edge_alpha_gamma = t_tri.get_pos(GAMMA) - t_tri.get_pos(ALPHA);
+
+            // Store the triangle.
+            for (size_t i = 0; i < 3; ++i)
+            {
+                m_alpha[i][index]            = t_tri.get_pos(ALPHA)[i];
+                m_edge_alpha_beta[i][index]  = edge_alpha_beta[i];
+                m_edge_alpha_gamma[i][index] = edge_alpha_gamma[i];
+            }
+            ++m_num_tri;
+
+            // Grow the bounds to contain the triangle.
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if (index == 0)
+                {
+                    m_min_bound[i] = t_tri.get_pos(ALPHA)[i];
+                    m_max_bound[i] = t_tri.get_pos(ALPHA)[i];
+                }
+                for (size_t j = ALPHA; j <= GAMMA; ++j)
+                {
+                    m_min_bound[i] = std::min(m_min_bound[i], t_tri.get_pos(j)[i]);
+                    m_max_bound[i] = std::max(m_max_bound[i], t_tri.get_pos(j)[i]);
+                }
+            }
+            m_bound_pad = BOUND_PAD * (m_max_bound - m_min_bound).max();
+        }
+
+
+        //  -- Geometric --
+        /**
+         *  Determine the distance to the closest triangle of the batch hit before a given distance along the ray.
+         *  The closest hit is chosen exactly as a sequential scan of Triangle::intersection_dist would choose it.
+         *  If the ray segment misses the bounding box of the batch no triangles are tested.
+         *  If no triangle is hit the returned index is the number of triangles and the distance is t_max.
+         *
+         *  @param  t_pos   Start position of the ray.
+         *  @param  t_dir   Direction of the ray.
+         *  @param  t_max   Distance along the ray beyond which hits are ignored.
+         *
+         *  @pre    t_dir must be normalised.
+         *  @pre    t_max must be positive.
+         *
+         *  @return A pair containing the batch index of the closest triangle and the distance to it.
+         */
+        std::pair<size_t, double> Batch::intersection_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir,
+                                                           const double t_max) const
+        {
+            assert(t_dir.is_normalised());
+            assert(t_max > 0.0);
+
+            // Skip the triangles if the ray segment misses them all.
+            size_t r_index = m_num_tri;
+            double r_dist  = t_max;
+            if ((m_num_tri == 0) || !bound_hit(t_pos, t_dir, t_max))
+            {
+                return (std::pair<size_t, double>(r_index, r_dist));
+            }
+
+            // Run through each block and keep the first of the closest hits.
+            std::array<double, BATCH_WIDTH> dist;
+            for (size_t i = 0; i < m_num_tri; i += BATCH_WIDTH)
+            {
+                intersect_block(i, t_pos, t_dir, dist);
+
+                for (size_t j = 0; j < BATCH_WIDTH; ++j)
+                {
+                    if (dist[j] < r_dist)
+                    {
+                        r_index = i + j;
+                        r_dist  = dist[j];
+                    }
+                }
+            }
+
+            return (std::pair<size_t, double>(r_index, r_dist));
+        }
+
+        /**
+         *  Determine if a ray segment passes through the padded bounding box of the batch.
+         *
+         *  @param  t_pos   Start position of the ray.
+         *  @param  t_dir   Direction of the ray.
+         *  @param  t_max   Length of the ray segment.
+         *
+         *  @return True if the ray segment passes through the padded bounding box.
+         */
+        bool Batch::bound_hit(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, const double t_max) const
+        {
+            double enter = 0.0;
+            double exit  = t_max;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const double min_bound = m_min_bound[i] - m_bound_pad;
+                const double max_bound = m_max_bound[i] + m_bound_pad;
+
+                // A ray parallel to the slab must start within it.
+                if (t_dir[i] == 0.0)
+                {
+                    if ((t_pos[i] < min_bound) || (t_pos[i] > max_bound))
+                    {
+                        return (false);
+                    }
+
+                    continue;
+                }
+
+                // Clip the segment to the slab.
+                const double near = (min_bound - t_pos[i]) / t_dir[i];
+                const double far  = (max_bound - t_pos[i]) / t_dir[i];
+                enter = std::max(enter, std::min(near, far));
+                exit  = std::min(exit, std::max(near, far));
+
+                if (enter > exit)
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+        }
+
+#if defined(ENABLE_SIMD) && defined(__AVX2__)
+        /**
+         *  Determine the distance to each triangle of a block of the batch using AVX2 instructions.
+         *  Operations are performed in the same order as Triangle::intersection_dist so results match it exactly.
+         *  Missed triangles are given an infinite distance.
+         *
+         *  @param  t_first Index of the first triangle of the block.
+         *  @param  t_pos   Start position of the ray.
+         *  @param  t_dir   Direction of the ray.
+         *  @param  t_dist  Array to write the distance to each triangle of the block into.
+         *
+         *  @pre    t_first must be a multiple of the batch width.
+         */
+        void Batch::intersect_block(const size_t t_first, const math::Vec<3>& t_pos, const math::Vec<3>& t_dir,
+                                    std::array<double, BATCH_WIDTH>& t_dist) const
+        {
+            assert((t_first % BATCH_WIDTH) == 0);
+
+            // Load the block.
+            const __m256d ab_x = _mm256_loadu_pd(&m_edge_alpha_beta[X][t_first]);
+            const __m256d ab_y = _mm256_loadu_pd(&m_edge_alpha_beta[Y][t_first]);
+            const __m256d ab_z = _mm256_loadu_pd(&m_edge_alpha_beta[Z][t_first]);
+            const __m256d ag_x = _mm256_loadu_pd(&m_edge_alpha_gamma[X][t_first]);
+            const __m256d ag_y = _mm256_loadu_pd(&m_edge_alpha_gamma[Y][t_first]);
+            const __m256d ag_z = _mm256_loadu_pd(&m_edge_alpha_gamma[Z][t_first]);
+
+            // Broadcast the ray.
+            const __m256d dir_x = _mm256_set1_pd(t_dir[X]);
+            const __m256d dir_y = _mm256_set1_pd(t_dir[Y]);
+            const __m256d dir_z = _mm256_set1_pd(t_dir[Z]);
+
+            // Calculate determinant.
+            const __m256d p_x = _mm256_sub_pd(_mm256_mul_pd(dir_y, ag_z), _mm256_mul_pd(dir_z, ag_y));
+            const __m256d p_y = _mm256_sub_pd(_mm256_mul_pd(dir_z, ag_x), _mm256_mul_pd(dir_x, ag_z));
+            const __m256d p_z = _mm256_sub_pd(_mm256_mul_pd(dir_x, ag_y), _mm256_mul_pd(dir_y, ag_x));
+            const __m256d det = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ab_x, p_x), _mm256_mul_pd(ab_y, p_y)),
+                                              _mm256_mul_pd(ab_z, p_z));
+
+            // Calculate first barycentric coordinate.
+            const __m256d t_x = _mm256_sub_pd(_mm256_set1_pd(t_pos[X]), _mm256_loadu_pd(&m_alpha[X][t_first]));
+            const __m256d t_y = _mm256_sub_pd(_mm256_set1_pd(t_pos[Y]), _mm256_loadu_pd(&m_alpha[Y][t_first]));
+            const __m256d t_z = _mm256_sub_pd(_mm256_set1_pd(t_pos[Z]), _mm256_loadu_pd(&m_alpha[Z][t_first]));
+            const __m256d u   = _mm256_div_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(t_x, p_x), _mm256_mul_pd(t_y, p_y)), _mm256_mul_pd(t_z, p_z)), det);
+
+            // Calculate second barycentric coordinate.
+            const __m256d q_x = _mm256_sub_pd(_mm256_mul_pd(t_y, ab_z), _mm256_mul_pd(t_z, ab_y));
+            const __m256d q_y = _mm256_sub_pd(_mm256_mul_pd(t_z, ab_x), _mm256_mul_pd(t_x, ab_z));
+            const __m256d q_z = _mm256_sub_pd(_mm256_mul_pd(t_x, ab_y), _mm256_mul_pd(t_y, ab_x));
+            const __m256d v   = _mm256_div_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dir_x, q_x), _mm256_mul_pd(dir_y, q_y)),
+                              _mm256_mul_pd(dir_z, q_z)), det);
+
+            // Calculate distance to intersection.
+            const __m256d dist = _mm256_div_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ag_x, q_x), _mm256_mul_pd(ag_y, q_y)), _mm256_mul_pd(ag_z, q_z)),
+                det);
+
+            // Mask out parallel triangles, intersections outside of the triangle and triangles behind the ray.
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d one  = _mm256_set1_pd(1.0);
+            __m256d       miss = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), det), _mm256_set1_pd(BATCH_TOL),
+                                               _CMP_LT_OQ);
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(u, zero, _CMP_LT_OQ));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(u, one, _CMP_GT_OQ));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(v, zero, _CMP_LT_OQ));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(_mm256_add_pd(u, v), one, _CMP_GT_OQ));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(dist, zero, _CMP_LT_OQ));
+
+            _mm256_storeu_pd(t_dist.data(),
+                             _mm256_blendv_pd(dist, _mm256_set1_pd(std::numeric_limits<double>::infinity()), miss));
+        }
+#else
+        /**
+         *  Determine the distance to each triangle of a block of the batch.
+         *  Operations are performed in the same order as Triangle::intersection_dist so results match it exactly.
+         *  Missed triangles are given an infinite distance.
+         *
+         *  @param  t_first Index of the first triangle of the block.
+         *  @param  t_pos   Start position of the ray.
+         *  @param  t_dir   Direction of the ray.
+         *  @param  t_dist  Array to write the distance to each triangle of the block into.
+         *
+         *  @pre    t_first must be a multiple of the batch width.
+         */
+        void Batch::intersect_block(const size_t t_first, const math::Vec<3>& t_pos, const math::Vec<3>& t_dir,
+                                    std::array<double, BATCH_WIDTH>& t_dist) const
+        {
+            assert((t_first % BATCH_WIDTH) == 0);
+
+            for (size_t i = 0; i < BATCH_WIDTH; ++i)
+            {
+                const size_t index = t_first + i;
+                t_dist[i] = std::numeric_limits<double>::infinity();
+
+                // Load the triangle.
+                const double ab_x = m_edge_alpha_beta[X][index];
+                const double ab_y = m_edge_alpha_beta[Y][index];
+                const double ab_z = m_edge_alpha_beta[Z][index];
+                const double ag_x = m_edge_alpha_gamma[X][index];
+                const double ag_y = m_edge_alpha_gamma[Y][index];
+                const double ag_z = m_edge_alpha_gamma[Z][index];
+
+                // Calculate determinant.
+                const double p_x = (t_dir[Y] * ag_z) - (t_dir[Z] * ag_y);
+                const double p_y = (t_dir[Z] * ag_x) - (t_dir[X] * ag_z);
+                const double p_z = (t_dir[X] * ag_y) - (t_dir[Y] * ag_x);
+                const double det = ((ab_x * p_x) + (ab_y * p_y)) + (ab_z * p_z);
+
+                // Check if ray is parallel to the triangle surface.
+                if (std::abs(det) < BATCH_TOL)
+                {
+                    continue;
+                }
+
+                // Calculate first barycentric coordinate and test bounds.
+                const double t_x = t_pos[X] - m_alpha[X][index];
+                const double t_y = t_pos[Y] - m_alpha[Y][index];
+                const double t_z = t_pos[Z] - m_alpha[Z][index];
+                const double u   = (((t_x * p_x) + (t_y * p_y)) + (t_z * p_z)) / det;
+                if ((u < 0.0) || (u > 1.0))
+                {
+                    continue;
+                }
+
+                // Calculate second barycentric coordinate and test bounds.
+                const double q_x = (t_y * ab_z) - (t_z * ab_y);
+                const double q_y = (t_z * ab_x) - (t_x * ab_z);
+                const double q_z = (t_x * ab_y) - (t_y * ab_x);
+                const double v   = (((t_dir[X] * q_x) + (t_dir[Y] * q_y)) + (t_dir[Z] * q_z)) / det;
+                if ((v < 0.0) || ((u + v) > 1.0))
+                {
+                    continue;
+                }
+
+                // Calculate distance to intersection, and check if triangle is behind ray.
+                const double dist = (((ag_x * q_x) + (ag_y * q_y)) + (ag_z * q_z)) / det;
+                if (dist < 0.0)
+                {
+                    continue;
+                }
+
+                t_dist[i] = dist;
+            }
+        }
+#endif
+
+
+
+    } // namespace geom
+} // namespace arc
@@ -0,0 +1,100 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_GEOM_BATCH_HPP
+#define ARCTORUS_SRC_CLS_GEOM_BATCH_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <utility>
+#include <vector>
+
+//  -- General --
+#include "gen/config.hpp"
+
+//  -- Classes --
+#include "cls/geom/triangle.hpp"
+#include "cls/math/vec.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace geom
+    {
+
+
+
+        //  == SETTINGS ==
+        //  -- Batching --
+        constexpr const size_t BATCH_WIDTH = 4;         //! Number of triangles intersected together.
+        constexpr const double BATCH_TOL   = 1.0e-15;   //! Determinant tolerance matching Triangle::intersection_dist.
+        constexpr const double BOUND_PAD   = 1.0e-6;    //! Padding of the bounding box relative to its largest extent.
+
+
+
+        //  == CLASS ==
+        /**
+         *  Block of triangles stored as a structure of arrays for intersecting several triangles at once.
+         *  Vertex alpha and the edges leaving it are precomputed for each triangle.
+         *  Storage is padded to a multiple of the batch width with degenerate triangles which can never be hit.
+         *  A padded bounding box around the triangles lets queries skip the whole batch when the ray segment misses it.
+         */
+        class Batch
+        {
+            //  == FIELDS ==
+          private:
+            //  -- Geometry --
+            std::array<std::vector<double>, 3> m_alpha;             //! Position of vertex alpha.
+            std::array<std::vector<double>, 3> m_edge_alpha_beta;   //! Edge from vertex alpha to vertex beta.
+            std::array<std::vector<double>, 3> m_edge_alpha_gamma;  //! Edge from vertex alpha to vertex gamma.
+
+            //  -- Bounds --
+            math::Vec<3> m_min_bound;   //! Minimum bound of the triangles.
+            math::Vec<3> m_max_bound;   //! Maximum bound of the triangles.
+            double       m_bound_pad = 0.0; //! Padding applied to the bounds when testing them.
+
+            //  -- Size --
+            size_t m_num_tri = 0;   //! Number of triangles held, excluding padding.
+
+
+            //  == METHODS ==
+          public:
+            //  -- Getters --
+            size_t get_num_tri() const { return (m_num_tri); }
+            bool empty() const { return (m_num_tri == 0); }
+
+            //  -- Setters --
+            void add_tri(const Triangle& t_tri);
+
+            //  -- Geometric --
+            std::pair<size_t, double> intersection_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir,
+                                                        double t_max) const;
+
+          private:
+            //  -- Geometric --
+            bool bound_hit(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, double t_max) const;
+            void intersect_block(size_t t_first, const math::Vec<3>& t_pos, const math::Vec<3>& t_dir,
+                                 std::array<double, BATCH_WIDTH>& t_dist) const;
+        };
+
+
+
+    } // namespace geom
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_GEOM_BATCH_HPP
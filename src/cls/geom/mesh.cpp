@@ -13,6 +13,20 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unistd.h>
+
+//  -- General --
+#include "gen/log.hpp"
+
 //  -- Utility --
 #include "utl/stream.hpp"
 
@@ -40,15 +54,25 @@ namespace arc
          *  @pre    t_dir's magnitude must be greater than zero.
          *  @pre    t_scale elements must all be non-zero.
          */
-        Mesh::Mesh(const std::string& t_serial, const math::Vec<3>& t_trans, const math::Vec<3>& t_dir, double t_spin,
-                   const math::Vec<3>& t_scale) :
+        Mesh::Mesh(const std::string_view t_serial, const math::Vec<3>& t_trans, const math::Vec<3>& t_dir,
+                   double t_spin, const math::Vec<3>& t_scale) :
             Mesh(t_serial, math::create_trans_mat(t_trans, t_dir, t_spin, t_scale))
         {
             assert(t_dir.magnitude() > 0.0);
             assert(t_scale[X] != 0.0);
             assert(t_scale[Y] != 0.0);
             assert(t_scale[Z] != 0.0);
+        }
 
+        /**
+         *  Construct a mesh from a given serialised string and transformation matrix.
+         *
+         *  @param  t_serial    Mesh as a serialised string.
+         *  @param  t_trans_mat Transformation matrix.
+         */
+        Mesh::Mesh(const std::string_view t_serial, const math::Mat<4, 4>& t_trans_mat)
+        {
+            read_wavefront(t_serial, t_trans_mat);
 
             if (m_tri.empty())
             {
@@ -57,179 +81,468 @@ namespace arc
         }
 
         /**
-         *  Construct a mesh from a given serialised string and transformation matrix.
+         *  Construct a mesh from a given list of triangles.
          *
-         *  @param  t_serial    Mesh as a serialised string.
-         *  @param  t_trans_mat Transformation matrix.
+         *  @param  t_tri       List of triangles forming the mesh.
+         *  @param  t_num_vert  Number of vertex positions the triangles were formed from.
+         *  @param  t_num_norm  Number of vertex normals the triangles were formed from.
          */
-        Mesh::Mesh(const std::string& t_serial, const math::Mat<4, 4>& t_trans_mat) :
-            m_num_vert(init_num(t_serial, POS_KEYWORD)),
-            m_num_norm(init_num(t_serial, NORM_KEYWORD)),
-            m_num_tri(init_num(t_serial, FACE_KEYWORD)),
-            m_tri(init_tri(t_serial, t_trans_mat))
+        Mesh::Mesh(std::vector<geom::Triangle>&& t_tri, const size_t t_num_vert, const size_t t_num_norm) :
+            m_num_vert(t_num_vert),
+            m_num_norm(t_num_norm),
+            m_num_tri(t_tri.size()),
+            m_tri(std::move(t_tri))
         {
         }
 
 
-        //  -- Initialisation --
+        //  -- Loading --
         /**
-         *  Determine the number of a given type of data within the wavefront mesh.
+         *  Load a mesh from a given wavefront file and transformations.
+         *  The file is memory mapped and parsed in place.
+         *  When caching is enabled the transformed triangles are stored within a binary file next to the source, named
+         *  after the transformation, and are read back from it while the source file remains unmodified.
+         *
+         *  @param  t_path  Path to the wavefront file.
+         *  @param  t_trans Vector of translation.
+         *  @param  t_dir   Direction to face.
+         *  @param  t_spin  Spin angle.
+         *  @param  t_scale Vector of scaling values.
+         *  @param  t_cache When true, read and write the mesh cache.
          *
-         *  @param  t_serial        Mesh as a serialised string.
-         *  @param  t_type_string   String identifying the type within the wavefront file.
+         *  @pre    t_dir's magnitude must be greater than zero.
+         *  @pre    t_scale elements must all be non-zero.
          *
-         *  @return The number of the type within the wavefront file.
+         *  @return The loaded mesh.
          */
-        size_t Mesh::init_num(const std::string& t_serial, const std::string& t_type_string) const
+        Mesh Mesh::load(const std::string& t_path, const math::Vec<3>& t_trans, const math::Vec<3>& t_dir,
+                        const double t_spin, const math::Vec<3>& t_scale, const bool t_cache)
         {
-            size_t r_num = 0;
+            assert(t_dir.magnitude() > 0.0);
+            assert(t_scale[X] != 0.0);
+            assert(t_scale[Y] != 0.0);
+            assert(t_scale[Z] != 0.0);
 
-            std::stringstream serial_stream(t_serial);
+            const math::Mat<4, 4> trans_mat = math::create_trans_mat(t_trans, t_dir, t_spin, t_scale);
+            const file::Map       source(t_path);
 
-            std::string line;
-            while (std::getline(serial_stream, line))
+            if (!t_cache)
             {
-                std::stringstream line_stream(line);
+                return (Mesh(source.get_contents(), trans_mat));
+            }
 
-                std::string word;
-                line_stream >> word;
+            // Read the cached mesh if it is valid.
+            const std::string cache_path = get_cache_path(source, trans_mat);
+            if (std::optional<Mesh> cached = read_cache(cache_path, source, trans_mat))
+            {
+                VERB("Mesh read from cache: " << cache_path);
 
-                if (word == t_type_string)
-                {
-                    ++r_num;
-                }
+                return (std::move(*cached));
             }
 
-            return (r_num);
+            // Otherwise parse the source and cache the result.
+            Mesh r_mesh(source.get_contents(), trans_mat);
+            r_mesh.write_cache(cache_path, source, trans_mat);
+
+            return (r_mesh);
         }
 
+
+
+        //  == METHODS ==
+        //  -- Parsing --
         /**
-         *  Initialise the vector of triangles forming the mesh from a serialised mesh and transformation matrices.
+         *  Read the vertex positions, vertex normals and faces of a serialised wavefront mesh in a single pass.
+         *  Face indices are collected as they are read, so faces may refer to vertices listed after them.
          *
          *  @param  t_serial    Mesh as a serialised string.
          *  @param  t_trans_mat Transformation matrix.
-         *
-         *  @post   Number of read vertex positions must equal that read initially.
-         *  @post   Number of read vertex normals must equal that read initially.
-         *  @post   Number of read faces must equal that read initially.
-         *
-         *  @return The initialised vector of triangle faces.
          */
-        std::vector<geom::Triangle> Mesh::init_tri(const std::string& t_serial, const math::Mat<4, 4>& t_trans_mat) const
+        void Mesh::read_wavefront(const std::string_view t_serial, const math::Mat<4, 4>& t_trans_mat)
         {
             // Create the transposed inverted transformation matrix.
-            math::Mat<4, 4> trans_inv_mat = math::transpose(math::inverse(t_trans_mat));
-
-            // Create return vector of triangles.
-            std::vector<geom::Triangle> r_tri;
-            r_tri.reserve(m_num_tri);
+            const math::Mat<4, 4> trans_inv_mat = math::transpose(math::inverse(t_trans_mat));
 
-            // Create vectors of vertex positions and normals.
-            std::vector<math::Vec<3>> vert_pos, vert_norm;
-            vert_pos.reserve(m_num_vert);
-            vert_norm.reserve(m_num_norm);
+            // Create vectors of vertex positions, normals and face indices.
+            std::vector<math::Vec<3>>          vert_pos, vert_norm;
+            std::vector<std::array<size_t, 6>> face;
 
-            // Read in the vertex positions and normals.
-            std::stringstream serial_stream(t_serial);
-            std::string(line);
-            while (std::getline(serial_stream, line))
+            // Read each line.
+            const char* const end = t_serial.data() + t_serial.size();
+            for (const char* line = t_serial.data(); line < end;)
             {
-                std::stringstream line_stream(line);
-                std::string       word;
-                line_stream >> word;
+                const size_t remaining = static_cast<size_t>(end - line);
+                const auto*  line_end  = static_cast<const char*>(std::memchr(line, '\n', remaining));
+                if (line_end == nullptr)
+                {
+                    line_end = end;
+                }
+                const std::string_view line_view(line, static_cast<size_t>(line_end - line));
 
-                if (word == POS_KEYWORD)
+                // Read the keyword.
+                const char* cur = line;
+                while ((cur < line_end) && (std::isspace(static_cast<unsigned char>(*cur)) != 0))
+                {
+                    ++cur;
+                }
+                const char* word = cur;
+                while ((cur < line_end) && (std::isspace(static_cast<unsigned char>(*cur)) == 0))
                 {
-                    // Read in the position vector.
-                    math::Vec<4> pos;
-                    line_stream >> pos[X] >> pos[Y] >> pos[Z];
-                    pos[3] = 1.0;
+                    ++cur;
+                }
+                const std::string_view keyword(word, static_cast<size_t>(cur - word));
 
-                    // Transform it using the position transformation matrix.
-                    pos = t_trans_mat * pos;
+                if ((keyword == POS_KEYWORD) || (keyword == NORM_KEYWORD))
+                {
+                    // Read in the vector.
+                    math::Vec<4> vec;
+                    for (size_t i = 0; (i < 3) && (cur != nullptr); ++i)
+                    {
+                        cur = read_value(cur, line_end, vec[i]);
+                    }
+                    if (cur == nullptr)
+                    {
+                        ERROR("Unable to construct geom::Mesh object.",
+                              "Unable to parse serial line: '" << line_view << "'.");
+                    }
+                    vec[3] = 1.0;
+
+                    if (keyword == POS_KEYWORD)
+                    {
+                        // Transform it using the position transformation matrix.
+                        vec = t_trans_mat * vec;
+
+                        // Add the three-dimensional position to the vertex position list.
+                        vert_pos.emplace_back(vec[X], vec[Y], vec[Z]);
+                    }
+                    else
+                    {
+                        // Transform it using the transverse-inverted-transformation matrix.
+                        vec = trans_inv_mat * vec;
+
+                        // Add the three-dimensional normal to the vertex normal list.
+                        vert_norm.emplace_back(math::normalise(math::Vec<3>(vec[X], vec[Y], vec[Z])));
+                    }
+                }
+                else if (keyword == FACE_KEYWORD)
+                {
+                    // Read in the position and normal indices of each vertex.
+                    std::array<size_t, 6> indices{};
+                    for (size_t i = 0; (i < 3) && (cur != nullptr); ++i)
+                    {
+                        cur = read_face_vert(cur, line_end, indices[i], indices[3 + i]);
+                    }
+                    if (cur == nullptr)
+                    {
+                        ERROR("Unable to construct geom::Mesh object.",
+                              "Unable to parse serialised wavefront object line: '" << line_view << "'.");
+                    }
+
+                    // Check nothing but a comment follows.
+                    while ((cur < line_end) && (std::isspace(static_cast<unsigned char>(*cur)) != 0))
+                    {
+                        ++cur;
+                    }
+                    if ((cur < line_end) && (*cur != '#'))
+                    {
+                        ERROR("Unable to construct geom::Mesh object.",
+                              "Non-triangular face located within line: '" << line_view << "'.");
+                    }
 
-                    // Add the three-dimensional position to the vertex position list.
-                    vert_pos.emplace_back(pos[X], pos[Y], pos[Z]);
+                    face.push_back(indices);
                 }
-                else if (word == NORM_KEYWORD)
+
+                line = line_end + 1;
+            }
+
+            // Form the triangles.
+            m_tri.reserve(face.size());
+            for (size_t i = 0; i < face.size(); ++i)
+            {
+                std::array<math::Vec<3>, 3> pos, norm;
+                for (size_t j = 0; j < 3; ++j)
                 {
-                    // Read in the normal vector.
-                    math::Vec<4> norm;
-                    line_stream >> norm[X] >> norm[Y] >> norm[Z];
-                    norm[3] = 1.0;
+                    if ((face[i][j] >= vert_pos.size()) || (face[i][3 + j] >= vert_norm.size()))
+                    {
+                        ERROR("Unable to construct geom::Mesh object.",
+                              "Face: '" << i << "' refers to a vertex which does not exist.");
+                    }
+
+                    pos[j]  = vert_pos[face[i][j]];
+                    norm[j] = vert_norm[face[i][3 + j]];
+                }
+
+                m_tri.emplace_back(pos, norm);
+            }
+
+            m_num_vert = vert_pos.size();
+            m_num_norm = vert_norm.size();
+            m_num_tri  = m_tri.size();
+        }
+
+        /**
+         *  Read a whitespace separated floating point value.
+         *
+         *  @param  t_first Start of the characters to read from.
+         *  @param  t_last  End of the characters to read from.
+         *  @param  t_value Value to read into.
+         *
+         *  @return Position after the value, or nullptr if no value could be read.
+         */
+        const char* Mesh::read_value(const char* t_first, const char* const t_last, double& t_value) const
+        {
+            while ((t_first < t_last) && (std::isspace(static_cast<unsigned char>(*t_first)) != 0))
+            {
+                ++t_first;
+            }
+
+            const std::from_chars_result result = std::from_chars(t_first, t_last, t_value);
 
-                    // Transform it using the transverse-inverted-transformation matrix.
-                    norm = trans_inv_mat * norm;
+            return ((result.ec == std::errc()) ? result.ptr : nullptr);
+        }
 
-                    // Add the three-dimensional normal to the vertex normal list.
-                    vert_norm.emplace_back(math::normalise(math::Vec<3>(norm[X], norm[Y], norm[Z])));
+        /**
+         *  Read the position and normal indices of a whitespace separated face vertex.
+         *  The position index comes before the first slash and the normal index after the last slash.
+         *  When there is no slash the position index is used for both.
+         *
+         *  @param  t_first         Start of the characters to read from.
+         *  @param  t_last          End of the characters to read from.
+         *  @param  t_pos_index     Zero-based position index to read into.
+         *  @param  t_norm_index    Zero-based normal index to read into.
+         *
+         *  @return Position after the face vertex, or nullptr if it could not be read.
+         */
+        const char* Mesh::read_face_vert(const char* t_first, const char* const t_last, size_t& t_pos_index,
+                                         size_t& t_norm_index) const
+        {
+            while ((t_first < t_last) && (std::isspace(static_cast<unsigned char>(*t_first)) != 0))
+            {
+                ++t_first;
+            }
+            const char* end = t_first;
+            while ((end < t_last) && (std::isspace(static_cast<unsigned char>(*end)) == 0))
+            {
+                ++end;
+            }
+
+            // Read the position index.
+            const std::from_chars_result pos = std::from_chars(t_first, end, t_pos_index);
+            if ((pos.ec != std::errc()) || (t_pos_index == 0) || ((pos.ptr != end) && (*pos.ptr != '/')))
+            {
+                return (nullptr);
+            }
+
+            // Read the normal index.
+            const char* norm_first = end;
+            while ((norm_first > pos.ptr) && (*(norm_first - 1) != '/'))
+            {
+                --norm_first;
+            }
+            if (norm_first == pos.ptr)
+            {
+                t_norm_index = t_pos_index;
+            }
+            else
+            {
+                const std::from_chars_result norm = std::from_chars(norm_first, end, t_norm_index);
+                if ((norm.ec != std::errc()) || (t_norm_index == 0) || (norm.ptr != end))
+                {
+                    return (nullptr);
                 }
+            }
 
-                if (line_stream.fail())
+            // Convert to zero-based indices.
+            --t_pos_index;
+            --t_norm_index;
+
+            return (end);
+        }
+
+
+        //  -- Cache --
+        /**
+         *  Determine the path of the cache file of a given source file and transformation.
+         *
+         *  @param  t_source    Mapping of the source wavefront file.
+         *  @param  t_trans_mat Transformation matrix.
+         *
+         *  @return The path of the cache file.
+         */
+        std::string Mesh::get_cache_path(const file::Map& t_source, const math::Mat<4, 4>& t_trans_mat)
+        {
+            std::array<double, 16> elements{};
+            for (size_t i = 0; i < 4; ++i)
+            {
+                for (size_t j = 0; j < 4; ++j)
                 {
-                    ERROR("Unable to construct geom::Mesh object.", "Unable to parse serial line: '" << line << "'.");
+                    elements[(i * 4) + j] = t_trans_mat[i][j];
                 }
             }
 
-            // Check the number of vertex positions and normals equals that expected.
-            assert(vert_pos.size() == m_num_vert);
-            assert(vert_norm.size() == m_num_norm);
+            const size_t key = std::hash<std::string_view>()(
+                std::string_view(reinterpret_cast<const char*>(elements.data()), sizeof(elements)));
+
+            std::stringstream path;
+            path << t_source.get_path() << "." << std::hex << key << CACHE_EXTENSION;
 
-            // Read in the triangular faces.
-            utl::rewind(serial_stream);
-            while (std::getline(serial_stream, line))
+            return (path.str());
+        }
+
+        /**
+         *  Read a mesh from a given cache file, if it is valid for the given source file and transformation.
+         *
+         *  @param  t_cache_path    Path to the cache file.
+         *  @param  t_source        Mapping of the source wavefront file.
+         *  @param  t_trans_mat     Transformation matrix.
+         *
+         *  @return The cached mesh, or nothing if the cache is missing, stale or unreadable.
+         */
+        std::optional<Mesh> Mesh::read_cache(const std::string& t_cache_path, const file::Map& t_source,
+                                             const math::Mat<4, 4>& t_trans_mat)
+        {
+            std::ifstream file(t_cache_path, std::ios::binary);
+            if (!file)
+            {
+                return (std::nullopt);
+            }
+
+            // Check the header matches the source and transformation.
+            unsigned long int magic = 0, version = 0, size = 0;
+            long long int     mod_time = 0;
+            utl::read_binary(file, magic);
+            utl::read_binary(file, version);
+            utl::read_binary(file, size);
+            utl::read_binary(file, mod_time);
+            if (!file || (magic != CACHE_MAGIC) || (version != CACHE_VERSION) || (size != t_source.get_size()) ||
+                (mod_time != t_source.get_mod_time()))
+            {
+                return (std::nullopt);
+            }
+            for (size_t i = 0; i < 4; ++i)
+            {
+                std::array<double, 4> row{};
+                utl::read_binary(file, row);
+                if (!file || (row != t_trans_mat[i]))
+                {
+                    return (std::nullopt);
+                }
+            }
+
+            // Read the properties.
+            unsigned long int num_vert = 0, num_norm = 0, num_tri = 0;
+            utl::read_binary(file, num_vert);
+            utl::read_binary(file, num_norm);
+            utl::read_binary(file, num_tri);
+            if (!file || (num_tri == 0))
             {
-                std::stringstream line_stream(line);
-                std::string       word;
-                line_stream >> word;
+                return (std::nullopt);
+            }
 
-                if (word == FACE_KEYWORD)
+            // Read the triangle vertex positions and normals a block at a time, forming the triangles.
+            std::vector<geom::Triangle> tri;
+            tri.reserve(num_tri);
+            std::vector<double> block(CACHE_BLOCK * CACHE_TRI_SIZE);
+            while (tri.size() < num_tri)
+            {
+                const size_t num_block = std::min(CACHE_BLOCK, num_tri - tri.size());
+                file.read(reinterpret_cast<char*>(block.data()),
+                          static_cast<std::streamsize>(num_block * CACHE_TRI_SIZE * sizeof(double)));
+                if (!file)
                 {
-                    std::array<std::string, 3> face;
-                    line_stream >> face[ALPHA] >> face[BETA] >> face[GAMMA];
+                    return (std::nullopt);
+                }
 
-                    if (line_stream.rdbuf()->in_avail() != 0)
+                for (size_t i = 0; i < num_block; ++i)
+                {
+                    const double*               v = &block[i * CACHE_TRI_SIZE];
+                    std::array<math::Vec<3>, 3> pos, norm;
+                    for (size_t j = 0; j < 3; ++j)
                     {
-                        ERROR("Unable to construct geom::Mesh object.",
-                              "Non-triangular face located within line: '" << line << "'.");
+                        pos[j]  = math::Vec<3>(v[3 * j], v[(3 * j) + 1], v[(3 * j) + 2]);
+                        norm[j] = math::Vec<3>(v[9 + (3 * j)], v[10 + (3 * j)], v[11 + (3 * j)]);
                     }
 
-                    std::array<size_t, 3> pos_index{}, norm_index{};
-                    for (size_t           i = 0; i < 3; ++i)
+                    tri.emplace_back(pos, norm);
+                }
+            }
+
+            return (Mesh(std::move(tri), num_vert, num_norm));
+        }
+
+        /**
+         *  Write the mesh to a given cache file, tagged with the source file and transformation it was formed from.
+         *  The file is written under a temporary name and then renamed, so an interrupted write is never read.
+         *  The temporary name holds the process id, so processes writing the same cache at once never share a file.
+         *
+         *  @param  t_cache_path    Path to the cache file.
+         *  @param  t_source        Mapping of the source wavefront file.
+         *  @param  t_trans_mat     Transformation matrix.
+         */
+        void Mesh::write_cache(const std::string& t_cache_path, const file::Map& t_source,
+                               const math::Mat<4, 4>& t_trans_mat) const
+        {
+            // Write the file.
+            const std::string tmp_path = t_cache_path + "." + std::to_string(getpid()) + ".tmp";
+            {
+                std::ofstream file(tmp_path, std::ios::binary);
+
+                // Write the header.
+                utl::write_binary(file, CACHE_MAGIC);
+                utl::write_binary(file, CACHE_VERSION);
+                utl::write_binary(file, static_cast<unsigned long int>(t_source.get_size()));
+                utl::write_binary(file, t_source.get_mod_time());
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    utl::write_binary(file, t_trans_mat[i]);
+                }
+                utl::write_binary(file, static_cast<unsigned long int>(m_num_vert));
+                utl::write_binary(file, static_cast<unsigned long int>(m_num_norm));
+                utl::write_binary(file, static_cast<unsigned long int>(m_num_tri));
+
+                // Write the triangle vertex positions and normals a block at a time.
+                std::vector<double> block;
+                block.reserve(CACHE_BLOCK * CACHE_TRI_SIZE);
+                for (size_t i = 0; i < m_tri.size(); ++i)
+                {
+                    for (size_t j = 0; j < 3; ++j)
                     {
-                        const size_t first_slash = face[i].find_first_of('/');
-                        const size_t last_slash  = face[i].find_last_of('/');
-
-                        std::stringstream pos(face[i].substr(0, first_slash));
-                        pos >> pos_index[i];
-                        --pos_index[i];
-
-                        std::stringstream norm(face[i].substr(last_slash + 1));
-                        norm >> norm_index[i];
-                        --norm_index[i];
-
-                        if (pos.fail() || norm.fail())
-                        {
-                            ERROR("Unable to construct geom::Mesh object.",
-                                  "Unable to parse serialised wavefront object line: '" << line << "'.");
-                        }
+                        const math::Vec<3>& pos = m_tri[i].get_pos(j);
+                        block.insert(block.end(), {pos[X], pos[Y], pos[Z]});
+                    }
+                    for (size_t j = 0; j < 3; ++j)
+                    {
+                        const math::Vec<3>& norm = m_tri[i].get_norm(j);
+                        block.insert(block.end(), {norm[X], norm[Y], norm[Z]});
                     }
 
-                    r_tri.push_back(
-                        Triangle({{vert_pos[pos_index[ALPHA]], vert_pos[pos_index[BETA]], vert_pos[pos_index[GAMMA]]}},
-                                 {{vert_norm[norm_index[ALPHA]], vert_norm[norm_index[BETA]], vert_norm[norm_index[GAMMA]]}}));
+                    if ((block.size() == (CACHE_BLOCK * CACHE_TRI_SIZE)) || ((i + 1) == m_tri.size()))
+                    {
+                        file.write(reinterpret_cast<const char*>(block.data()),
+                                   static_cast<std::streamsize>(block.size() * sizeof(double)));
+                        block.clear();
+                    }
                 }
 
-                if (line_stream.fail())
+                if (!file)
                 {
-                    ERROR("Unable to construct geom::Mesh object.", "Unable to parse serial line: '" << line << "'.");
+                    WARN("Unable to write mesh cache.", "Unable to write file: '" << tmp_path << "'.");
+                    file.close();
+                    std::remove(tmp_path.c_str());
+
+                    return;
                 }
             }
 
-            // Check the number of faces equals that expected.
-            assert(r_tri.size() == m_num_tri);
+            if (std::rename(tmp_path.c_str(), t_cache_path.c_str()) != 0)
+            {
+                WARN("Unable to write mesh cache.", "Unable to rename file: '" << tmp_path << "'.");
+                std::remove(tmp_path.c_str());
+
+                return;
+            }
 
-            return (r_tri);
+            VERB("Mesh written to cache: " << t_cache_path);
         }
 
 
@@ -15,10 +15,16 @@
 
 //  == INCLUDES ==
 //  -- System --
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 //  -- Classes --
+#include "cls/file/map.hpp"
 #include "cls/geom/triangle.hpp"
+#include "cls/math/mat.hpp"
 #include "cls/math/vec.hpp"
 
 
@@ -37,39 +43,58 @@ namespace arc
         constexpr const char* NORM_KEYWORD = "vn";  //! Wavefront file keyword identifying vertex normals.
         constexpr const char* FACE_KEYWORD = "f";   //! Wavefront file keyword identifying a face.
 
+        //  -- Cache --
+        constexpr const char*             CACHE_EXTENSION = ".arcmesh";         //! Extension of mesh cache files.
+        constexpr const unsigned long int CACHE_MAGIC     = 0x4152434D45534821; //! Tag beginning each mesh cache file.
+        constexpr const unsigned long int CACHE_VERSION   = 1;                  //! Version of the mesh cache layout.
+        constexpr const size_t            CACHE_BLOCK     = 4096;               //! Triangles read or written at a time.
+        constexpr const size_t            CACHE_TRI_SIZE  = 18;                 //! Values stored for each triangle.
+
 
 
         //  == CLASS ==
         /**
          *  Triangular mesh class used to form the boundary of objects.
+         *  Meshes may hold very many triangles, so they may be moved but not copied.
          */
         class Mesh
         {
             //  == FIELDS ==
           private:
             //  -- Properties --
-            const size_t m_num_vert;    //! Number of vertex positions.
-            const size_t m_num_norm;    //! Number of vertex normals.
-            const size_t m_num_tri;     //! Number of triangle faces.
+            size_t m_num_vert = 0;  //! Number of vertex positions.
+            size_t m_num_norm = 0;  //! Number of vertex normals.
+            size_t m_num_tri  = 0;  //! Number of triangle faces.
 
             //  -- Triangle Data --
-            const std::vector<geom::Triangle> m_tri;  //! List of triangles forming the mesh.
+            std::vector<geom::Triangle> m_tri;  //! List of triangles forming the mesh.
 
 
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            explicit Mesh(const std::string& t_serial, const math::Vec<3>& t_trans = math::Vec<3>(0.0, 0.0, 0.0),
+            Mesh(const Mesh& /*unused*/) = delete;
+            Mesh(Mesh&& /*unused*/) = default;
+            explicit Mesh(std::string_view t_serial, const math::Vec<3>& t_trans = math::Vec<3>(0.0, 0.0, 0.0),
                           const math::Vec<3>& t_dir = math::Vec<3>(0.0, 0.0, 1.0), double t_spin = 0.0,
                           const math::Vec<3>& t_scale = math::Vec<3>(1.0, 1.0, 1.0));
 
+            //  -- Loading --
+            static Mesh load(const std::string& t_path, const math::Vec<3>& t_trans = math::Vec<3>(0.0, 0.0, 0.0),
+                             const math::Vec<3>& t_dir = math::Vec<3>(0.0, 0.0, 1.0), double t_spin = 0.0,
+                             const math::Vec<3>& t_scale = math::Vec<3>(1.0, 1.0, 1.0), bool t_cache = false);
+
           private:
             //  -- Constructors --
-            Mesh(const std::string& t_serial, const math::Mat<4, 4>& t_trans_mat);
+            Mesh(std::string_view t_serial, const math::Mat<4, 4>& t_trans_mat);
+            Mesh(std::vector<geom::Triangle>&& t_tri, size_t t_num_vert, size_t t_num_norm);
+
 
-            //  -- Initialisation --
-            size_t init_num(const std::string& t_serial, const std::string& t_type_string) const;
-            std::vector<geom::Triangle> init_tri(const std::string& t_serial, const math::Mat<4, 4>& t_trans_mat) const;
+            //  == OPERATORS ==
+          public:
+            //  -- Copy --
+            Mesh& operator=(const Mesh& /*unused*/) = delete;
+            Mesh& operator=(Mesh&& /*unused*/) = default;
 
 
             //  == METHODS ==
@@ -79,6 +104,20 @@ namespace arc
             size_t get_num_norm() const { return (m_num_norm); }
             size_t get_num_tri() const { return (m_num_tri); }
             const Triangle& get_tri(const size_t t_index) const { return (m_tri[t_index]); }
+
+          private:
+            //  -- Parsing --
+            void read_wavefront(std::string_view t_serial, const math::Mat<4, 4>& t_trans_mat);
+            const char* read_value(const char* t_first, const char* t_last, double& t_value) const;
+            const char* read_face_vert(const char* t_first, const char* t_last, size_t& t_pos_index,
+                                       size_t& t_norm_index) const;
+
+            //  -- Cache --
+            static std::string get_cache_path(const file::Map& t_source, const math::Mat<4, 4>& t_trans_mat);
+            static std::optional<Mesh> read_cache(const std::string& t_cache_path, const file::Map& t_source,
+                                                  const math::Mat<4, 4>& t_trans_mat);
+            void write_cache(const std::string& t_cache_path, const file::Map& t_source,
+                             const math::Mat<4, 4>& t_trans_mat) const;
         };
 
 
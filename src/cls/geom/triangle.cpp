@@ -256,13 +256,15 @@ namespace arc
          *  Generate a random position on the triangle's surface and determine the associated normal.
          *  Position and normal are stored together in an array.
          *
+         *  @param  t_rng   Random number generator to draw from.
+         *
          *  @return A random position and associated normal on the triangle's surface.
          */
-        std::pair<math::Vec<3>, math::Vec<3>> Triangle::gen_random_pos_and_norm() const
+        std::pair<math::Vec<3>, math::Vec<3>> Triangle::gen_random_pos_and_norm(random::Generator& t_rng) const
         {
             // Generate a pair of random barycentric coordinates.
-            double a = rng::random();
-            double b = rng::random();
+            double a = t_rng.gen_value();
+            double b = t_rng.gen_value();
 
             // If the generated coordinate falls beyond the triangle, mirror it back inside.
             if ((a + b) > 1.0)
@@ -20,6 +20,9 @@
 //  -- General --
 #include "gen/math.hpp"
 
+//  -- Classes --
+#include "cls/random/generator.hpp"
+
 
 
 //  == NAMESPACE ==
@@ -61,6 +64,7 @@ namespace arc
           public:
             //  -- Getters --
             double get_area() const { return (m_area); }
+            const math::Vec<3>& get_plane_norm() const { return (m_plane_norm); }
             const math::Vec<3>& get_pos(const size_t t_index) const { return (m_pos[t_index]); }
             const math::Vec<3>& get_norm(const size_t t_index) const { return (m_norm[t_index]); }
 
@@ -73,7 +77,7 @@ namespace arc
             math::Vec<3> get_norm(const math::Vec<3>& t_pos) const;
 
             //  -- Generation --
-            std::pair<math::Vec<3>, math::Vec<3>> gen_random_pos_and_norm() const;
+            std::pair<math::Vec<3>, math::Vec<3>> gen_random_pos_and_norm(random::Generator& t_rng) const;
         };
 
 
@@ -100,9 +100,9 @@ namespace arc
         {
             assert((t_val >= m_min_bound) && (t_val <= m_max_bound));
 
-            m_last_index = utl::lower_index(m_x, t_val, m_last_index);
+            const size_t lower_index = utl::lower_index(m_x, t_val);
 
-            return (m_y[m_last_index] + ((t_val - m_x[m_last_index]) * m_grad[m_last_index]));
+            return (m_y[lower_index] + ((t_val - m_x[lower_index]) * m_grad[lower_index]));
         }
 
 
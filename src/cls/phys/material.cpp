@@ -13,6 +13,13 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <cmath>
+
+//  -- General --
+#include "gen/log.hpp"
+
 //  -- Utility --
 #include "utl/vector.hpp"
 
@@ -55,10 +62,9 @@ namespace arc
                            const std::vector<double>& t_anisotropy) :
             m_min_bound(t_wavelength.front()),
             m_max_bound(t_wavelength.back()),
-            m_ref_index(t_wavelength, t_ref_index),
-            m_albedo(init_albedo(t_wavelength, t_abs_coef, t_scat_coef)),
-            m_interaction(init_interation(t_wavelength, t_abs_coef, t_scat_coef)),
-            m_anisotropy(t_wavelength, t_anisotropy)
+            m_table_size(init_table_size(t_wavelength)),
+            m_table_scale(m_table_size / (m_max_bound - m_min_bound)),
+            m_table(init_table(t_wavelength, t_ref_index, t_abs_coef, t_scat_coef, t_anisotropy))
         {
             assert(utl::is_ascending(t_wavelength));
             assert(t_wavelength.size() == t_ref_index.size());
@@ -108,6 +114,98 @@ namespace arc
 
 
         //  -- Initialisation --
+        /**
+         *  Determine the number of uniform wavelength steps of the optical property table.
+         *  The step is chosen to be no larger than the smallest spacing between wavelength nodes.
+         *
+         *  @param  t_wavelength    Vector of wavelength values.
+         *
+         *  @pre    t_wavelength must be in ascending order.
+         *
+         *  @post   r_size must be greater than zero.
+         *
+         *  @return The number of steps of the optical property table.
+         */
+        size_t Material::init_table_size(const std::vector<double>& t_wavelength) const
+        {
+            assert(utl::is_ascending(t_wavelength));
+
+            // Find the smallest spacing between nodes.
+            double min_spacing = t_wavelength.back() - t_wavelength.front();
+            for (size_t i = 1; i < t_wavelength.size(); ++i)
+            {
+                min_spacing = std::min(min_spacing, t_wavelength[i] - t_wavelength[i - 1]);
+            }
+
+            // Round the number of steps, only rounding up when the nodes are not uniform to within tolerance.
+            const double steps   = (t_wavelength.back() - t_wavelength.front()) / min_spacing;
+            const double rounded = std::round(steps);
+            const double r_steps = (std::fabs(steps - rounded) < (1.0E-6 * steps)) ? rounded : std::ceil(steps);
+
+            if (r_steps > MAX_MATERIAL_TABLE_SIZE)
+            {
+                WARN("Material node spacing is finer than the table resolution.",
+                     "Properties will be resampled onto " << MAX_MATERIAL_TABLE_SIZE << " steps.");
+
+                return (MAX_MATERIAL_TABLE_SIZE);
+            }
+
+            const auto r_size = std::max(static_cast<size_t>(1), static_cast<size_t>(r_steps));
+
+            assert(r_size > 0);
+
+            return (r_size);
+        }
+
+        /**
+         *  Initialise the packed optical property table by sampling the interpolated properties on a uniform grid.
+         *
+         *  @param  t_wavelength    Vector of wavelength values.
+         *  @param  t_ref_index     Vector of corresponding refractive indices.
+         *  @param  t_abs_coef      Vector of corresponding absorption coefficients.
+         *  @param  t_scat_coef     Vector of corresponding scattering coefficients.
+         *  @param  t_anisotropy    Vector of corresponding anisotropy values.
+         *
+         *  @pre    m_table_size must be greater than zero.
+         *
+         *  @return The initialised optical property table.
+         */
+        std::vector<Material::Row> Material::init_table(const std::vector<double>& t_wavelength,
+                                                        const std::vector<double>& t_ref_index,
+                                                        const std::vector<double>& t_abs_coef,
+                                                        const std::vector<double>& t_scat_coef,
+                                                        const std::vector<double>& t_anisotropy) const
+        {
+            assert(m_table_size > 0);
+
+            // Create the interpolators to sample.
+            const interpolator::Linear ref_index(t_wavelength, t_ref_index);
+            const interpolator::Linear albedo(init_albedo(t_wavelength, t_abs_coef, t_scat_coef));
+            const interpolator::Linear interaction(init_interation(t_wavelength, t_abs_coef, t_scat_coef));
+            const interpolator::Linear anisotropy(t_wavelength, t_anisotropy);
+
+            // Sample the properties at each grid node.
+            std::vector<Optics> node(m_table_size + 1);
+            for (size_t         i = 0; i <= m_table_size; ++i)
+            {
+                const double wavelength = (i == m_table_size) ? m_max_bound : (m_min_bound + (i / m_table_scale));
+
+                node[i] = {ref_index(wavelength), albedo(wavelength), interaction(wavelength), anisotropy(wavelength)};
+            }
+
+            // Pack the start of each step and the change across it into a row.
+            std::vector<Row> r_table(m_table_size);
+            for (size_t      i = 0; i < m_table_size; ++i)
+            {
+                r_table[i].value = node[i];
+                r_table[i].delta = {node[i + 1].ref_index - node[i].ref_index, node[i + 1].albedo - node[i].albedo,
+                                    node[i + 1].interaction - node[i].interaction,
+                                    node[i + 1].anisotropy - node[i].anisotropy};
+            }
+
+            return (r_table);
+        }
+
         /**
          *  Construct the interaction interpolator by calculating the interaction coefficients from the absorption and
          *  scattering length coefficients.
@@ -175,6 +273,33 @@ namespace arc
 
         //  == METHODS ==
         //  -- Getters --
+        /**
+         *  Get the full set of optical properties of the material for the given wavelength.
+         *
+         *  @param  t_wavelength    Wavelength to determine the optical properties for.
+         *
+         *  @pre    t_wavelength must be greater than, or equal to, the m_min_bound.
+         *  @pre    t_wavelength must be less than, or equal to, the m_max_bound.
+         *
+         *  @return The optical properties for the given wavelength.
+         */
+        Material::Optics Material::get_optics(const double t_wavelength) const
+        {
+            assert(t_wavelength >= m_min_bound);
+            assert(t_wavelength <= m_max_bound);
+
+            // Locate the table row and the fraction of the way across its step.
+            const double pos   = (t_wavelength - m_min_bound) * m_table_scale;
+            const size_t index = std::min(static_cast<size_t>(pos), m_table_size - 1);
+            const double frac  = pos - index;
+
+            const Row& row = m_table[index];
+
+            return (Optics{row.value.ref_index + (frac * row.delta.ref_index), row.value.albedo + (frac * row.delta.albedo),
+                           row.value.interaction + (frac * row.delta.interaction),
+                           row.value.anisotropy + (frac * row.delta.anisotropy)});
+        }
+
         /**
          *  Get the refractive index of the material for the given wavelength.
          *
@@ -187,10 +312,7 @@ namespace arc
          */
         double Material::get_ref_index(const double t_wavelength) const
         {
-            assert(t_wavelength >= m_min_bound);
-            assert(t_wavelength <= m_max_bound);
-
-            return (m_ref_index(t_wavelength));
+            return (get_optics(t_wavelength).ref_index);
         }
 
         /**
@@ -205,10 +327,7 @@ namespace arc
          */
         double Material::get_albedo(const double t_wavelength) const
         {
-            assert(t_wavelength >= m_min_bound);
-            assert(t_wavelength <= m_max_bound);
-
-            return (m_albedo(t_wavelength));
+            return (get_optics(t_wavelength).albedo);
         }
 
         /**
@@ -223,10 +342,7 @@ namespace arc
          */
         double Material::get_interaction(const double t_wavelength) const
         {
-            assert(t_wavelength >= m_min_bound);
-            assert(t_wavelength <= m_max_bound);
-
-            return (m_interaction(t_wavelength));
+            return (get_optics(t_wavelength).interaction);
         }
 
         /**
@@ -241,10 +357,7 @@ namespace arc
          */
         double Material::get_anisotropy(const double t_wavelength) const
         {
-            assert(t_wavelength >= m_min_bound);
-            assert(t_wavelength <= m_max_bound);
-
-            return (m_anisotropy(t_wavelength));
+            return (get_optics(t_wavelength).anisotropy);
         }
 
 
@@ -14,6 +14,9 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <vector>
+
 //  -- Classes --
 #include "cls/data/table.hpp"
 #include "cls/interpolator/linear.hpp"
@@ -28,9 +31,18 @@ namespace arc
 
 
 
+        //  == SETTINGS ==
+        //  -- Tables --
+        constexpr const size_t MAX_MATERIAL_TABLE_SIZE = 65536;     //! Maximum number of steps of a material table.
+
+
+
         //  == CLASS ==
         /**
          *  Material class used to store optical properties.
+         *  Properties are resampled onto a packed table on a uniform wavelength grid when the material is constructed.
+         *  The grid step is the smallest node spacing of the input data, so uniformly sampled data is held exactly.
+         *  Lookups are a single index calculation and hold no mutable state, so a material may be shared by threads.
          */
         class Material
         {
@@ -50,6 +62,34 @@ namespace arc
             };
 
 
+            //  == STRUCTURES ==
+          public:
+            //  -- Properties --
+            /**
+             *  Set of optical properties of the material at a single wavelength.
+             */
+            struct Optics
+            {
+                double ref_index;   //! Refractive index.
+                double albedo;      //! Single scattering albedo.
+                double interaction; //! Interaction coefficient.
+                double anisotropy;  //! Anisotropy factor.
+            };
+
+          private:
+            //  -- Table --
+            /**
+             *  Row of the optical property table holding the properties at the start of a wavelength step and their
+             *  change across it.
+             *  Rows fill exactly one cache line so a lookup touches a single line.
+             */
+            struct alignas(64) Row
+            {
+                Optics value;   //! Properties at the start of the step.
+                Optics delta;   //! Change in the properties across the step.
+            };
+
+
             //  == FIELDS ==
           private:
             //  -- Bounds --
@@ -57,10 +97,9 @@ namespace arc
             const double m_max_bound;   //! Maximum wavelength bound of the interpolation range.
 
             //  -- Optical Properties --
-            const interpolator::Linear m_ref_index;     //! Refractive index.
-            const interpolator::Linear m_albedo;        //! Single scattering albedo. a = mu_a / mu_t.
-            const interpolator::Linear m_interaction;   //! Interaction coefficient. mu_t = mu_a + mu_s.
-            const interpolator::Linear m_anisotropy;    //! Anisotropy factor.
+            const size_t           m_table_size;    //! Number of uniform wavelength steps of the table.
+            const double           m_table_scale;   //! Number of table steps per unit of wavelength.
+            const std::vector<Row> m_table;         //! Packed optical properties on a uniform wavelength grid.
 
 
             //  == INSTANTIATION ==
@@ -74,6 +113,10 @@ namespace arc
 
           private:
             //  -- Initialisation --
+            size_t init_table_size(const std::vector<double>& t_wavelength) const;
+            std::vector<Row> init_table(const std::vector<double>& t_wavelength, const std::vector<double>& t_ref_index,
+                                        const std::vector<double>& t_abs_coef, const std::vector<double>& t_scat_coef,
+                                        const std::vector<double>& t_anisotropy) const;
             interpolator::Linear init_albedo(const std::vector<double>& t_wavelength, const std::vector<double>& t_abs_coef,
                                              const std::vector<double>& t_scat_coef) const;
             interpolator::Linear init_interation(const std::vector<double>& t_wavelength, const std::vector<double>& t_abs_coef,
@@ -85,6 +128,8 @@ namespace arc
             //  -- Getters --
             double get_min_bound() const { return (m_min_bound); }
             double get_max_bound() const { return (m_max_bound); }
+            size_t get_table_size() const { return (m_table_size); }
+            Optics get_optics(double t_wavelength) const;
             double get_ref_index(double t_wavelength) const;
             double get_albedo(double t_wavelength) const;
             double get_interaction(double t_wavelength) const;
@@ -16,6 +16,7 @@
 //  -- General --
 #include "gen/constants.hpp"
 #include "gen/math.hpp"
+#include "gen/rng.hpp"
 
 
 
@@ -39,8 +40,7 @@ namespace arc
          */
         Photon::Photon(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, const double t_wavelength,
                        const phys::Material& t_mat) :
-            Photon(t_pos, t_dir, t_wavelength, t_mat.get_ref_index(t_wavelength), t_mat.get_albedo(t_wavelength),
-                   t_mat.get_interaction(t_wavelength), t_mat.get_anisotropy(t_wavelength))
+            Photon(t_pos, t_dir, t_wavelength, t_mat.get_optics(t_wavelength))
         {
         }
 
@@ -50,10 +50,7 @@ namespace arc
          *  @param  t_pos           Initial position of the photon.
          *  @param  t_dir           Initial direction of the photon.
          *  @param  t_wavelength    Wavelength of the photon packet.
-         *  @param  t_ref_index     Refractive index of the current medium.
-         *  @param  t_albedo        Single scattering albedo of the current medium.
-         *  @param  t_interaction   Interaction coefficient of the current medium.
-         *  @param  t_anisotropy    Anisotropy value of the current medium.
+         *  @param  t_optics        Optical properties of the current medium.
          *
          *  @post   m_dir must be normalised.
          *  @post   m_time must be non-negative.
@@ -63,20 +60,24 @@ namespace arc
          *  @post   m_albedo must be non-negative.
          *  @post   m_interaction must be positive.
          *  @post   m_anisotropy must be between minus one and one.
-         *  @post   m_entity_index must be of size one.
+         *  @post   m_entity_depth must be one.
          */
         Photon::Photon(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, const double t_wavelength,
-                       const double t_ref_index, const double t_albedo, const double t_interaction, const double t_anisotropy) :
+                       const phys::Material::Optics& t_optics) :
             m_pos(t_pos),
             m_dir(t_dir),
             m_weight(1.0),
+            m_interaction(t_optics.interaction),
+            m_albedo(t_optics.albedo),
+            m_anisotropy(t_optics.anisotropy),
+            m_hg_sum(1.0),
+            m_hg_diff(1.0),
+            m_hg_inv_2g(0.0),
+            m_ref_index(t_optics.ref_index),
             m_wavelength(t_wavelength),
-            m_ref_index(t_ref_index),
-            m_albedo(t_albedo),
-            m_interaction(t_interaction),
-            m_anisotropy(t_anisotropy),
+            m_time(0.0),
             m_entity_index({-1}),
-            m_time(0.0)
+            m_entity_depth(1)
         {
             assert(m_dir.is_normalised());
             assert(m_time >= 0.0);
@@ -86,7 +87,10 @@ namespace arc
             assert(m_albedo >= 0.0);
             assert(m_interaction > 0.0);
             assert((m_anisotropy >= -1.0) && (m_anisotropy <= 1.0));
-            assert(m_entity_index.size() == 1);
+            assert(m_entity_depth == 1);
+
+            // Precompute the phase function constants.
+            set_phase_constants();
 
 #ifdef ENABLE_PHOTON_PATHS
             // Record the initial position of the photon.
@@ -98,6 +102,31 @@ namespace arc
 
         //  == METHODS ==
         //  -- Setters --
+        /**
+         *  Record that the photon has entered the entity of the given index.
+         *  The record has a fixed capacity, so entering an entity beyond the maximum nesting depth is refused.
+         *
+         *  @param  t_index Index of the entity being entered.
+         *
+         *  @pre    t_index must not be the index of the entity the photon is currently within.
+         *
+         *  @return True if the entity index was recorded, false if the maximum nesting depth has been reached.
+         */
+        bool Photon::push_entity_index(const int t_index)
+        {
+            assert(t_index != get_entity_index());
+
+            if (m_entity_depth == m_entity_index.size())
+            {
+                return (false);
+            }
+
+            m_entity_index[m_entity_depth] = t_index;
+            ++m_entity_depth;
+
+            return (true);
+        }
+
         /**
          *  Set the direction of the photon.
          *
@@ -149,33 +178,50 @@ namespace arc
          *  @param  t_dec   Declination angle away from current direction vector.
          *  @param  t_azi   Azimuthal rotation around current direction vector.
          *
-         *  @pre    n_dir must be normalised.
          *  @pre    t_dec must be between zero and pi.
+         */
+        void Photon::rotate(const double t_dec, const double t_azi)
+        {
+            assert((t_dec >= 0.0) && (t_dec <= M_PI));
+
+            rotate_cos(std::cos(t_dec), t_azi);
+        }
+
+        /**
+         *  Rotate the particle by a declination of given cosine and then a given azimuthal rotation.
+         *  The sine of the declination is recovered from its cosine, so no inverse trigonometry is required.
+         *
+         *  @param  t_cos_dec   Cosine of the declination angle away from current direction vector.
+         *  @param  t_azi       Azimuthal rotation around current direction vector.
+         *
+         *  @pre    m_dir must be normalised.
+         *  @pre    t_cos_dec must be between minus one and one.
          *  @pre    t_azi must be between zero and two pi.
          *
-         *  @post   n_dir must be normalised.
+         *  @post   m_dir must be normalised.
          */
-        void Photon::rotate(const double t_dec, const double t_azi)
+        void Photon::rotate_cos(const double t_cos_dec, const double t_azi)
         {
             assert(m_dir.is_normalised());
-            assert((t_dec >= 0.0) && (t_dec <= M_PI));
+            assert((t_cos_dec >= -1.0) && (t_cos_dec <= 1.0));
             assert((t_azi >= 0.0) && (t_azi <= 2.0 * M_PI));
 
+            const double sin_theta = std::sqrt(1.0 - math::square(t_cos_dec));
+            const double cos_theta = t_cos_dec;
+            const double sin_phi   = std::sin(t_azi);
+            const double cos_phi   = std::cos(t_azi);
+
             if (std::fabs(1.0 - std::fabs(m_dir[Z])) < 1E-10)
             {
-                m_dir[X] = std::sin(t_dec) * std::cos(t_azi);
-                m_dir[Y] = std::sin(t_dec) * std::sin(t_azi);
-                m_dir[Z] = math::sign(m_dir[Z]) * std::cos(t_dec);
+                m_dir[X] = sin_theta * cos_phi;
+                m_dir[Y] = sin_theta * sin_phi;
+                m_dir[Z] = math::sign(m_dir[Z]) * cos_theta;
             }
             else
             {
                 const math::Vec<3> prev_dir = m_dir;
 
-                const double a         = std::sqrt(1.0 - math::square(prev_dir[Z]));
-                const double sin_theta = std::sin(t_dec);
-                const double cos_theta = std::cos(t_dec);
-                const double sin_phi   = std::sin(t_azi);
-                const double cos_phi   = std::cos(t_azi);
+                const double a = std::sqrt(1.0 - math::square(prev_dir[Z]));
 
                 m_dir[X] = ((sin_theta / a) * ((prev_dir[X] * prev_dir[Z] * cos_phi) - (prev_dir[Y] * sin_phi))) + (prev_dir[X] * cos_theta);
                 m_dir[Y] = ((sin_theta / a) * ((prev_dir[Y] * prev_dir[Z] * cos_phi) + (prev_dir[X] * sin_phi))) + (prev_dir[Y] * cos_theta);
@@ -187,6 +233,20 @@ namespace arc
             assert(m_dir.is_normalised());
         }
 
+        /**
+         *  Scatter the particle into a new direction drawn from the henyey-greenstein phase function.
+         *  The cosine of the declination is drawn first, followed by the azimuthal angle.
+         *
+         *  @param  t_rng   Random number generator to draw from.
+         */
+        void Photon::scatter(random::Generator& t_rng)
+        {
+            const double cos_dec = rng::henyey_greenstein_cos(m_anisotropy, m_hg_sum, m_hg_diff, m_hg_inv_2g, t_rng);
+            const double azi     = t_rng.gen_value(0.0, 2.0 * M_PI);
+
+            rotate_cos(cos_dec, azi);
+        }
+
         /**
          *  Multiply the photon's current statistical weight by a given value.
          *
@@ -216,16 +276,31 @@ namespace arc
         {
             assert((m_wavelength >= t_mat.get_min_bound()) && (m_wavelength <= t_mat.get_max_bound()));
 
-            // Set optical properties.
-            m_ref_index   = t_mat.get_ref_index(m_wavelength);
-            m_albedo      = t_mat.get_albedo(m_wavelength);
-            m_interaction = t_mat.get_interaction(m_wavelength);
-            m_anisotropy  = t_mat.get_anisotropy(m_wavelength);
+            // Set optical properties from a single table lookup.
+            const phys::Material::Optics optics = t_mat.get_optics(m_wavelength);
+            m_ref_index   = optics.ref_index;
+            m_albedo      = optics.albedo;
+            m_interaction = optics.interaction;
+            m_anisotropy  = optics.anisotropy;
 
             assert(m_ref_index > 0.0);
             assert(m_albedo >= 0.0);
             assert(m_interaction > 0.0);
             assert((m_anisotropy >= -1.0) && (m_anisotropy <= 1.0));
+
+            // Precompute the phase function constants.
+            set_phase_constants();
+        }
+
+        /**
+         *  Precompute the henyey-greenstein constants of the current anisotropy value.
+         *  These are only recalculated when the photon's optical properties change, rather than at every scattering.
+         */
+        void Photon::set_phase_constants()
+        {
+            m_hg_sum    = 1.0 + math::square(m_anisotropy);
+            m_hg_diff   = 1.0 - math::square(m_anisotropy);
+            m_hg_inv_2g = (m_anisotropy == 0.0) ? 0.0 : (1.0 / (2.0 * m_anisotropy));
         }
 
 
@@ -15,11 +15,15 @@
 
 //  == INCLUDES ==
 //  -- System --
-#include <stack>
+#include <array>
+
+//  -- General --
+#include "gen/config.hpp"
 
 //  -- Classes --
 #include "cls/graphical/point/photon.hpp"
 #include "cls/math/vec.hpp"
+#include "cls/random/generator.hpp"
 #include "material.hpp"
 
 
@@ -35,8 +39,11 @@ namespace arc
         //  == CLASS ==
         /**
          *  Photon packet class.
+         *  Fields are ordered so that those used by every transport step fill the first two cache lines.
+         *  The entity nesting record is held inline, so constructing a photon makes no heap allocation unless paths
+         *  are being recorded.
          */
-        class Photon
+        class alignas(64) Photon
         {
             //  == FIELDS ==
           private:
@@ -46,15 +53,21 @@ namespace arc
             double       m_weight;  //! Statistical weight of the particle.
 
             //  -- Optical --
-            const double    m_wavelength;   //! Wavelength of the photon packet.
-            double          m_ref_index;    //! Current refractive index.
-            double          m_albedo;       //! Current albedo.
-            double          m_interaction;  //! Current interaction coefficient.
-            double          m_anisotropy;   //! Current anisotropy value.
-            std::stack<int> m_entity_index; //! A record of the entity index which the photon is currently inside of.
+            double       m_interaction; //! Current interaction coefficient.
+            double       m_albedo;      //! Current albedo.
+            double       m_anisotropy;  //! Current anisotropy value.
+            double       m_hg_sum;      //! Current henyey-greenstein constant of one plus anisotropy squared.
+            double       m_hg_diff;     //! Current henyey-greenstein constant of one minus anisotropy squared.
+            double       m_hg_inv_2g;   //! Current henyey-greenstein reciprocal of twice the anisotropy.
+            double       m_ref_index;   //! Current refractive index.
+            const double m_wavelength;  //! Wavelength of the photon packet.
 
             //  -- Data --
             double m_time;   //! Emission time plus current age of the particle.
+
+            //  -- Nesting --
+            std::array<int, config::MAX_NESTING_DEPTH + 1> m_entity_index;  //! Entity indices the photon is inside of.
+            size_t                                        m_entity_depth;  //! Number of entity indices held.
 #ifdef ENABLE_PHOTON_PATHS
             std::vector<graphical::point::Photon> m_path;   //! Path data of the photon.
 #endif
@@ -67,8 +80,8 @@ namespace arc
 
           private:
             //  -- Constructors --
-            Photon(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, double t_wavelength, double t_ref_index,
-                   double t_albedo, double t_interaction, double t_anisotropy);
+            Photon(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, double t_wavelength,
+                   const phys::Material::Optics& t_optics);
 
 
             //  == METHODS ==
@@ -87,37 +100,37 @@ namespace arc
             double get_anisotropy() const { return (m_anisotropy); }
             int get_entity_index() const
             {
-                assert(!m_entity_index.empty());
+                assert(m_entity_depth >= 1);
 
-                return (m_entity_index.top());
+                return (m_entity_index[m_entity_depth - 1]);
             }
-            int get_prev_entity_index()
+            int get_prev_entity_index() const
             {
-                assert(m_entity_index.size() >= 2);
-
-                const int hold = m_entity_index.top();
-                m_entity_index.pop();
+                assert(m_entity_depth >= 2);
 
-                const int r_index = m_entity_index.top();
-                m_entity_index.push(hold);
-                return (r_index);
+                return (m_entity_index[m_entity_depth - 2]);
             }
 
             //  -- Setters --
-            void pop_entity_index() { m_entity_index.pop(); }
-            void push_entity_index(const int t_index)
+            void pop_entity_index()
             {
-                assert(t_index != m_entity_index.top());
+                assert(m_entity_depth >= 2);
 
-                m_entity_index.push(t_index);
+                --m_entity_depth;
             }
+            bool push_entity_index(int t_index);
             void set_dir(const math::Vec<3>& t_dir);
             void move(double t_dist);
             void rotate(double t_dec, double t_azi);
+            void rotate_cos(double t_cos_dec, double t_azi);
+            void scatter(random::Generator& t_rng);
             void multiply_weight(double t_mult);
             void set_opt(const phys::Material& t_mat);
 
           private:
+            //  -- Setters --
+            void set_phase_constants();
+
             //  -- Data --
 #ifdef ENABLE_PHOTON_PATHS
             void record_path();
@@ -33,13 +33,15 @@ namespace arc
          *
          *  @param  t_wavelength    Vector of wavelength values.
          *  @param  t_prob          Vector of corresponding probabilities.
+         *  @param  t_table_size    Number of steps of the inverse cdf sampling table, zero to sample exactly.
          *
          *  @post   t_wavelength vector must be in ascending order.
          *  @post   t_wavelength vector must be the same size as t_prob vector.
          *  @post   t_prop vector must always be greater than zero.
          */
-        Spectrum::Spectrum(const std::vector<double>& t_wavelength, const std::vector<double>& t_prob) :
-            m_dist(t_wavelength, t_prob)
+        Spectrum::Spectrum(const std::vector<double>& t_wavelength, const std::vector<double>& t_prob,
+                           const size_t t_table_size) :
+            m_dist(t_wavelength, t_prob, t_table_size)
         {
             assert(utl::is_ascending(t_wavelength));
             assert(t_wavelength.size() == t_prob.size());
@@ -49,13 +51,14 @@ namespace arc
         /**
          *  Construct a spectrum from a set of a table of spectral data.
          *
-         *  @param  t_tab   Table of spectral data.
+         *  @param  t_tab           Table of spectral data.
+         *  @param  t_table_size    Number of steps of the inverse cdf sampling table, zero to sample exactly.
          *
          *  @post   WAVELENGTH index column must have the correct title.
          *  @post   PROBABILITY index column must have the correct title.
          */
-        Spectrum::Spectrum(const data::Table& t_tab) :
-            Spectrum(t_tab[WAVELENGTH].get_data(), t_tab[PROBABILITY].get_data())
+        Spectrum::Spectrum(const data::Table& t_tab, const size_t t_table_size) :
+            Spectrum(t_tab[WAVELENGTH].get_data(), t_tab[PROBABILITY].get_data(), t_table_size)
         {
             assert(t_tab[WAVELENGTH].get_title() == "w");
             assert(t_tab[PROBABILITY].get_title() == "p");
@@ -64,10 +67,11 @@ namespace arc
         /**
          *  Construct a spectrum from a serialised spectrum object.
          *
-         *  @param  t_serial    Serialised form of a spectrum object.
+         *  @param  t_serial        Serialised form of a spectrum object.
+         *  @param  t_table_size    Number of steps of the inverse cdf sampling table, zero to sample exactly.
          */
-        Spectrum::Spectrum(const std::string& t_serial) :
-            Spectrum(data::Table(t_serial))
+        Spectrum::Spectrum(const std::string& t_serial, const size_t t_table_size) :
+            Spectrum(data::Table(t_serial), t_table_size)
         {
         }
 
@@ -56,9 +56,9 @@ namespace arc
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            Spectrum(const std::vector<double>& t_wavelength, const std::vector<double>& t_prob);
-            explicit Spectrum(const data::Table& t_tab);
-            explicit Spectrum(const std::string& t_serial);
+            Spectrum(const std::vector<double>& t_wavelength, const std::vector<double>& t_prob, size_t t_table_size = 0);
+            explicit Spectrum(const data::Table& t_tab, size_t t_table_size = 0);
+            explicit Spectrum(const std::string& t_serial, size_t t_table_size = 0);
 
 
             //  == METHODS ==
@@ -66,9 +66,10 @@ namespace arc
             //  -- Getters --
             double get_min_bound() const { return (m_dist.get_min_bound()); }
             double get_max_bound() const { return (m_dist.get_max_bound()); }
+            size_t get_table_size() const { return (m_dist.get_table_size()); }
 
             //  -- Generation --
-            double gen_wavelength() const { return (m_dist.gen_value()); }
+            double gen_wavelength(random::Generator& t_rng) const { return (m_dist.gen_value(t_rng)); }
         };
 
 
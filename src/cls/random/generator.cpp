@@ -0,0 +1,42 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/random/generator.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace random
+    {
+
+
+
+        //  == INSTANTIATION ==
+        //  -- Constructors --
+        /**
+         *  Construct a random number generator for a given stream of a given seed.
+         *  The seed forms the key, and the stream index fills the upper half of the counter.
+         *
+         *  @param  t_seed      Seed shared by all streams of a run.
+         *  @param  t_stream    Index of the stream to generate, such as the index of a photon.
+         */
+        Generator::Generator(const base t_seed, const base t_stream) :
+            m_key({{static_cast<uint32_t>(t_seed), static_cast<uint32_t>(t_seed >> 32)}}),
+            m_ctr({{0, 0, static_cast<uint32_t>(t_stream), static_cast<uint32_t>(t_stream >> 32)}}),
+            m_block({{0, 0, 0, 0}})
+        {
+        }
+
+
+
+    } // namespace random
+} // namespace arc
@@ -0,0 +1,159 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_RANDOM_GENERATOR_HPP
+#define ARCTORUS_SRC_CLS_RANDOM_GENERATOR_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace random
+    {
+
+
+
+        //  == SETTINGS ==
+        //  -- Philox --
+        constexpr const size_t   PHILOX_ROUNDS  = 10;                           //! Number of rounds forming each block.
+        constexpr const uint32_t PHILOX_MULT_0  = 0xD2511F53;                   //! Multiplier of the first counter word.
+        constexpr const uint32_t PHILOX_MULT_1  = 0xCD9E8D57;                   //! Multiplier of the third counter word.
+        constexpr const uint32_t PHILOX_WEYL_0  = 0x9E3779B9;                   //! Round increment of the first key word.
+        constexpr const uint32_t PHILOX_WEYL_1  = 0xBB67AE85;                   //! Round increment of the second key word.
+        constexpr const double   PHILOX_TO_UNIT = 1.0 / 9007199254740992.0;     //! Scale from 53-bit integers to unity.
+
+
+
+        //  == CLASS ==
+        /**
+         *  Counter-based sudo-random number generator implementing Philox4x32-10.
+         *  Each generator is keyed on a seed and a stream index, and its output is a pure function of those and the
+         *  number of values drawn.
+         *  Giving each photon its own stream therefore makes its history independent of the thread it runs on.
+         */
+        class Generator
+        {
+            //  == TYPE DEFINITIONS ==
+          public:
+            //  -- Generation --
+            using base = uint64_t;  //! Type of the seed and stream index.
+
+
+            //  == FIELDS ==
+          private:
+            //  -- Key --
+            const std::array<uint32_t, 2> m_key;    //! Key formed from the seed.
+
+            //  -- Counter --
+            std::array<uint32_t, 4> m_ctr;  //! Counter formed from the block index and the stream index.
+
+            //  -- Output --
+            std::array<uint32_t, 4> m_block;            //! Most recently generated block of random words.
+            size_t                  m_block_index = 4;  //! Index of the next unused word within the block.
+
+
+            //  == INSTANTIATION ==
+          public:
+            //  -- Constructors --
+            Generator(base t_seed, base t_stream);
+
+
+            //  == METHODS ==
+          public:
+            //  -- Generation --
+            inline double gen_value(double t_min = 0.0, double t_max = 1.0);
+
+          private:
+            //  -- Generation --
+            inline void gen_block();
+        };
+
+
+
+        //  == METHODS ==
+        //  -- Generation --
+        /**
+         *  Generate a random double value between the given minimum and maximum bound.
+         *  Values are formed from 53 random bits and never fall exactly on either bound.
+         *
+         *  @param  t_min   Minimum bound for the generated value.
+         *  @param  t_max   Maximum bound for the generated value.
+         *
+         *  @pre    t_min must be less than t_max.
+         *
+         *  @return A random double between the given bounds.
+         */
+        inline double Generator::gen_value(const double t_min, const double t_max)
+        {
+            assert(t_min < t_max);
+
+            // Generate a new block if this one has been used up.
+            if (m_block_index >= 4)
+            {
+                gen_block();
+            }
+
+            // Combine two words into 53 random bits.
+            const base bits = ((static_cast<base>(m_block[m_block_index]) << 32) | m_block[m_block_index + 1]) >> 11;
+            m_block_index += 2;
+
+            return (t_min + ((t_max - t_min) * ((static_cast<double>(bits) + 0.5) * PHILOX_TO_UNIT)));
+        }
+
+        /**
+         *  Generate the block of random words for the current counter, then increment the counter.
+         */
+        inline void Generator::gen_block()
+        {
+            std::array<uint32_t, 4> ctr = m_ctr;
+            std::array<uint32_t, 2> key = m_key;
+
+            // Apply the rounds.
+            for (size_t i = 0; i < PHILOX_ROUNDS; ++i)
+            {
+                const base prod_0 = static_cast<base>(PHILOX_MULT_0) * ctr[0];
+                const base prod_1 = static_cast<base>(PHILOX_MULT_1) * ctr[2];
+
+                ctr = {{static_cast<uint32_t>(prod_1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(prod_1),
+                        static_cast<uint32_t>(prod_0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(prod_0)}};
+
+                key[0] += PHILOX_WEYL_0;
+                key[1] += PHILOX_WEYL_1;
+            }
+
+            m_block       = ctr;
+            m_block_index = 0;
+
+            // Increment the block index held in the lower half of the counter.
+            if (++m_ctr[0] == 0)
+            {
+                ++m_ctr[1];
+            }
+        }
+
+
+
+    } // namespace random
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_RANDOM_GENERATOR_HPP
@@ -15,7 +15,6 @@
 //  == INCLUDES ==
 //  -- General --
 #include "gen/log.hpp"
-#include "gen/rng.hpp"
 
 
 
@@ -32,13 +31,16 @@ namespace arc
         /**
          *  Construct a index generator from a given probability distribution.
          *
-         *  @param  t_p Vector of index probabilities.
+         *  @param  t_p         Vector of index probabilities.
+         *  @param  t_method    Method used to draw indices.
          *
          *  @post   m_p data must always be non-negative.
          */
-        Index::Index(const std::vector<double>& t_p) :
+        Index::Index(const std::vector<double>& t_p, const method t_method) :
             m_max_bound(t_p.size() - 1),
-            m_cdf(init_cdf(t_p))
+            m_method(t_method),
+            m_cdf(init_cdf(t_p)),
+            m_alias(init_alias(t_p))
         {
             assert(utl::is_always_greater_than_or_equal_to(t_p, 0.0));
         }
@@ -81,18 +83,108 @@ namespace arc
             return (r_cdf);
         }
 
+        /**
+         *  Initialise the alias table of the probability data using Vose's method.
+         *  Entries with less than the average probability are paired with an entry with more, which donates the
+         *  remainder of the slot, until every slot holds exactly the average probability.
+         *  The table is left empty unless the alias method is used.
+         *
+         *  @param  t_p Vector of corresponding probabilities.
+         *
+         *  @pre    m_p data must always be non-negative.
+         *
+         *  @return The initialised alias table.
+         */
+        std::vector<Index::Alias> Index::init_alias(const std::vector<double>& t_p) const
+        {
+            assert(utl::is_always_greater_than_or_equal_to(t_p, 0.0));
+
+            // Only the alias method requires the table.
+            if (m_method != method::ALIAS)
+            {
+                return (std::vector<Alias>());
+            }
+
+            // Scale the probabilities so that their average is unity.
+            double total = 0.0;
+            for (size_t i = 0; i < t_p.size(); ++i)
+            {
+                total += t_p[i];
+            }
+            std::vector<double> scaled(t_p.size());
+            for (size_t i = 0; i < t_p.size(); ++i)
+            {
+                scaled[i] = (t_p[i] * t_p.size()) / total;
+            }
+
+            // Sort the entries into those below and above the average.
+            std::vector<size_t> small, large;
+            for (size_t i = 0; i < scaled.size(); ++i)
+            {
+                if (scaled[i] < 1.0)
+                {
+                    small.push_back(i);
+                }
+                else
+                {
+                    large.push_back(i);
+                }
+            }
+
+            // Fill each small entry's slot from a large entry.
+            std::vector<Alias> r_alias(t_p.size(), Alias({1.0, 0}));
+            for (size_t i = 0; i < r_alias.size(); ++i)
+            {
+                r_alias[i].alias = i;
+            }
+            while (!small.empty() && !large.empty())
+            {
+                const size_t less = small.back();
+                const size_t more = large.back();
+                small.pop_back();
+
+                r_alias[less].prob  = scaled[less];
+                r_alias[less].alias = more;
+
+                // The large entry donates the remainder of the small entry's slot.
+                scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+                if (scaled[more] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(more);
+                }
+            }
+
+            // Any entries remaining differ from the average only by rounding, so keep their own index.
+            return (r_alias);
+        }
+
 
 
         //  == METHODS ==
         //  -- Generation --
         /**
          *  Generate a random index from the step probability distribution.
+         *  A single random value is drawn with either method.
+         *  With the alias method its integer part picks a slot and its fractional part decides between the slot and its
+         *  alias.
+         *
+         *  @param  t_rng   Random number generator to draw from.
          *
          *  @return A randomly generated value from the step probability distribution.
          */
-        size_t Index::gen_index() const
+        size_t Index::gen_index(Generator& t_rng) const
         {
-            return (utl::lower_index(m_cdf, rng::random()));
+            if (m_method == method::SEARCH)
+            {
+                return (utl::lower_index(m_cdf, t_rng.gen_value()));
+            }
+
+            // Split the random value into a slot and a fraction.
+            const double scaled = t_rng.gen_value() * m_alias.size();
+            const size_t slot   = std::min(static_cast<size_t>(scaled), m_alias.size() - 1);
+
+            return (((scaled - slot) < m_alias[slot].prob) ? slot : m_alias[slot].alias);
         }
 
 
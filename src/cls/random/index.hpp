@@ -18,6 +18,9 @@
 #include <cstddef>
 #include <vector>
 
+//  -- Classes --
+#include "cls/random/generator.hpp"
+
 
 
 //  == NAMESPACE ==
@@ -31,27 +34,58 @@ namespace arc
         //  == CLASS ==
         /**
          *  A generator class which generates random indices according to a given step probability distribution.
+         *  Indices may be drawn by searching the cumulative distribution, or in constant time from a Vose alias table.
          */
         class Index
         {
+            //  == ENUMERATIONS ==
+          public:
+            /**
+             *  Enumeration of the methods of drawing an index.
+             */
+            enum class method
+            {
+                SEARCH, //! Search the cumulative distribution, taking logarithmic time.
+                ALIAS   //! Look up a Vose alias table, taking constant time.
+            };
+
+
+            //  == STRUCTURES ==
+          private:
+            /**
+             *  Entry of the alias table.
+             *  The entry's own index is kept with the given probability, otherwise its alias is returned.
+             */
+            struct Alias
+            {
+                double prob;    //! Probability of keeping the entry's own index.
+                size_t alias;   //! Index returned when the entry's own index is not kept.
+            };
+
+
             //  == FIELDS ==
           private:
             //  -- Bounds --
             const size_t m_min_bound = 0;   //! Minimum index of the generation range.
             const size_t m_max_bound;       //! Maximum index of the generation range.
 
+            //  -- Settings --
+            const method m_method;  //! Method used to draw indices.
+
             //  -- Data --
             const std::vector<double> m_cdf;    //! The normalised cumulative distribution of the probabilities.
+            const std::vector<Alias>  m_alias;  //! Alias table of the probabilities, only used by the alias method.
 
 
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            explicit Index(const std::vector<double>& t_p);
+            explicit Index(const std::vector<double>& t_p, method t_method = method::SEARCH);
 
           private:
             //  -- Initialisation --
             std::vector<double> init_cdf(const std::vector<double>& t_p) const;
+            std::vector<Alias> init_alias(const std::vector<double>& t_p) const;
 
 
             //  == METHODS ==
@@ -61,7 +95,7 @@ namespace arc
             size_t get_max_bound() const { return (m_max_bound); }
 
             //  -- Generation --
-            size_t gen_index() const;
+            size_t gen_index(Generator& t_rng) const;
         };
 
 
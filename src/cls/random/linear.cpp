@@ -13,10 +13,12 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+
 //  -- General --
 #include "gen/log.hpp"
 #include "gen/math.hpp"
-#include "gen/rng.hpp"
 
 
 
@@ -33,13 +35,17 @@ namespace arc
         /**
          *  Construct a linear random number generator from a given probability distribution.
          *
-         *  @param  t_x Vector of X positions.
-         *  @param  t_p Vector of corresponding probabilities.
+         *  When a table size is given the inverse cumulative distribution is tabulated at that many uniform steps in
+         *  probability, and values are generated by a single table lookup and linear interpolation.
+         *
+         *  @param  t_x             Vector of X positions.
+         *  @param  t_p             Vector of corresponding probabilities.
+         *  @param  t_table_size    Number of steps of the inverse cumulative distribution table, zero to sample exactly.
          *
          *  @post   t_x must be sorted into ascending order.
          *  @post   t_min_bound must be less than m_max_bound.
          */
-        Linear::Linear(const std::vector<double>& t_x, const std::vector<double>& t_p) :
+        Linear::Linear(const std::vector<double>& t_x, const std::vector<double>& t_p, const size_t t_table_size) :
             m_min_bound(t_x.front()),
             m_max_bound(t_x.back()),
             m_x(t_x),
@@ -47,7 +53,8 @@ namespace arc
             m_grad(init_grad()),
             m_inter(init_inter()),
             m_cdf(init_cdf()),
-            m_frac(init_frac())
+            m_frac(init_frac()),
+            m_table(init_table(t_table_size))
         {
             assert(utl::is_ascending(t_x));
             assert(m_min_bound < m_max_bound);
@@ -185,6 +192,39 @@ namespace arc
             return (r_frac);
         }
 
+        /**
+         *  Initialise the inverse cumulative distribution table.
+         *  Entry i holds the value at which the cdf reaches i / t_table_size.
+         *
+         *  @param  t_table_size    Number of steps of the table.
+         *
+         *  @post   r_table must be in ascending order.
+         *
+         *  @return The initialised inverse cumulative distribution table, empty when no table is requested.
+         */
+        std::vector<double> Linear::init_table(const size_t t_table_size) const
+        {
+            if (t_table_size == 0)
+            {
+                return (std::vector<double>());
+            }
+
+            // Create the return vector.
+            std::vector<double> r_table(t_table_size + 1);
+
+            // Invert the cdf at each uniform step in probability.
+            r_table.front() = m_min_bound;
+            for (size_t i = 1; i < t_table_size; ++i)
+            {
+                r_table[i] = get_inverse_cdf(static_cast<double>(i) / static_cast<double>(t_table_size));
+            }
+            r_table.back() = m_max_bound;
+
+            assert(utl::is_ascending(r_table));
+
+            return (r_table);
+        }
+
 
 
         //  == METHODS ==
@@ -192,29 +232,40 @@ namespace arc
         /**
          *  Generate a random number from the probability distribution.
          *
+         *  @param  t_rng   Random number generator to draw from.
+         *
          *  @return A randomly generated value from the probability distribution.
          */
-        double Linear::gen_value() const
+        double Linear::gen_value(Generator& t_rng) const
         {
             // Generate a random double between zero and one.
-            const double r = rng::random();
+            const double r = t_rng.gen_value();
+
+            // Interpolate the inverse cdf table when one has been built.
+            if (!m_table.empty())
+            {
+                const size_t table_size = m_table.size() - 1;
+                const double scaled     = r * table_size;
+                const size_t index      = std::min(static_cast<size_t>(scaled), table_size - 1);
+
+                return (m_table[index] + ((scaled - index) * (m_table[index + 1] - m_table[index])));
+            }
 
             // Determine the lower index of the cdf where the value is found.
-            static size_t lower_index = 0;
-            lower_index = utl::lower_index(m_cdf, r, lower_index);
+            const size_t lower_index = utl::lower_index(m_cdf, r);
 
             // Generate a value by interpolating the probabilities.
-            const double f = rng::random();
+            const double f = t_rng.gen_value();
             if (f <= m_frac[lower_index])
             {
                 if (m_p[lower_index] < m_p[lower_index + 1])
                 {
-                    return (m_x[lower_index] + (std::sqrt(rng::random()) * (m_x[lower_index + 1] - m_x[lower_index])));
+                    return (m_x[lower_index] + (std::sqrt(t_rng.gen_value()) * (m_x[lower_index + 1] - m_x[lower_index])));
                 }
-                return (m_x[lower_index + 1] - (std::sqrt(rng::random()) * (m_x[lower_index + 1] - m_x[lower_index])));
+                return (m_x[lower_index + 1] - (std::sqrt(t_rng.gen_value()) * (m_x[lower_index + 1] - m_x[lower_index])));
             }
 
-            return (m_x[lower_index] + (rng::random() * (m_x[lower_index + 1] - m_x[lower_index])));
+            return (m_x[lower_index] + (t_rng.gen_value() * (m_x[lower_index + 1] - m_x[lower_index])));
         }
 
         /**
@@ -222,6 +273,7 @@ namespace arc
          *
          *  @param  t_min   Minimum value that may be returned.
          *  @param  t_max   Maximum value that may be returned.
+         *  @param  t_rng   Random number generator to draw from.
          *
          *  @pre    t_min must be greater than, or equal to, m_min_bound and less than m_max_bound.
          *  @pre    t_max must be greater than m_min_bound and less than, or equal to, the m_max_bound.
@@ -230,31 +282,30 @@ namespace arc
          *
          *  @return A randomly generated value from the probability distribution between the limits.
          */
-        double Linear::gen_value(const double t_min, const double t_max) const
+        double Linear::gen_value(const double t_min, const double t_max, Generator& t_rng) const
         {
             assert((t_min >= m_min_bound) && (t_min < m_max_bound));
             assert((t_max > m_min_bound) && (t_min <= m_max_bound));
 
             // Generate a random double between the interpolated cdf values.
-            const double r = rng::random(get_cdf(t_min), get_cdf(t_max));
+            const double r = t_rng.gen_value(get_cdf(t_min), get_cdf(t_max));
 
             // Determine the lower index of the cdf where the value is found.
-            static size_t lower_index = 0;
-            lower_index = utl::lower_index(m_cdf, r, lower_index);
+            const size_t lower_index = utl::lower_index(m_cdf, r);
 
             // Generate a value by interpolating the probabilities.
-            const double f = rng::random();
+            const double f = t_rng.gen_value();
             if (f <= m_frac[lower_index])
             {
                 if (m_p[lower_index] < m_p[lower_index + 1])
                 {
-                    return (m_x[lower_index] + (std::sqrt(rng::random()) * (m_x[lower_index + 1] - m_x[lower_index])));
+                    return (m_x[lower_index] + (std::sqrt(t_rng.gen_value()) * (m_x[lower_index + 1] - m_x[lower_index])));
                 }
-                return (m_x[lower_index + 1] - (std::sqrt(rng::random()) * (m_x[lower_index + 1] - m_x[lower_index])));
+                return (m_x[lower_index + 1] - (std::sqrt(t_rng.gen_value()) * (m_x[lower_index + 1] - m_x[lower_index])));
             }
 
             // Calculate the generated value.
-            const double r_val = m_x[lower_index] + (rng::random() * (m_x[lower_index + 1] - m_x[lower_index]));
+            const double r_val = m_x[lower_index] + (t_rng.gen_value() * (m_x[lower_index + 1] - m_x[lower_index]));
 
             assert((r_val >= t_min) && (r_val <= t_max));
 
@@ -297,6 +348,39 @@ namespace arc
             return (r_cdf);
         }
 
+        /**
+         *  Calculate the value of x at which the cdf reaches the given value.
+         *  The cdf is quadratic within each interval, and the root is taken in a form which remains stable as the
+         *  probability gradient tends to zero.
+         *
+         *  @param  t_cdf   Value of the cdf to invert.
+         *
+         *  @pre    t_cdf must be between zero and one.
+         *
+         *  @post   r_x must fall within the bounds.
+         *
+         *  @return The value of x at which the cdf reaches the given value.
+         */
+        double Linear::get_inverse_cdf(const double t_cdf) const
+        {
+            assert((t_cdf >= 0.0) && (t_cdf <= 1.0));
+
+            const size_t lower_index = std::min(utl::lower_index(m_cdf, t_cdf), m_cdf.size() - 2);
+
+            // Solve the quadratic cdf of the interval for the offset from its lower x position.
+            const double area  = t_cdf - m_cdf[lower_index];
+            const double p     = m_p[lower_index];
+            const double root  = std::sqrt(std::max(0.0, math::square(p) + (2.0 * m_grad[lower_index] * area)));
+            const double width = m_x[lower_index + 1] - m_x[lower_index];
+            const double dx    = ((p + root) > 0.0) ? ((2.0 * area) / (p + root)) : 0.0;
+
+            const double r_x = m_x[lower_index] + std::clamp(dx, 0.0, width);
+
+            assert((r_x >= m_min_bound) && (r_x <= m_max_bound));
+
+            return (r_x);
+        }
+
 
 
     } // namespace random
@@ -17,6 +17,9 @@
 //  -- System --
 #include <vector>
 
+//  -- Classes --
+#include "cls/random/generator.hpp"
+
 
 
 //  == NAMESPACE ==
@@ -47,11 +50,14 @@ namespace arc
             const std::vector<double> m_cdf;    //! The normalised cumulative distribution of the probabilities.
             const std::vector<double> m_frac;   //! Vector of the fractions of the triangular interpolation range.
 
+            //  -- Table --
+            const std::vector<double> m_table;  //! Inverse cumulative distribution tabulated at uniform probabilities.
+
 
             //  == INSTANTIATION ==
           public:
             //  -- Constructors --
-            Linear(const std::vector<double>& t_x, const std::vector<double>& t_p);
+            Linear(const std::vector<double>& t_x, const std::vector<double>& t_p, size_t t_table_size = 0);
 
           private:
             //  -- Initialisation --
@@ -60,6 +66,7 @@ namespace arc
             std::vector<double> init_inter() const;
             std::vector<double> init_cdf() const;
             std::vector<double> init_frac() const;
+            std::vector<double> init_table(size_t t_table_size) const;
 
 
             //  == METHODS ==
@@ -67,14 +74,16 @@ namespace arc
             //  -- Getters --
             double get_min_bound() const { return (m_min_bound); }
             double get_max_bound() const { return (m_max_bound); }
+            size_t get_table_size() const { return (m_table.empty() ? 0 : (m_table.size() - 1)); }
 
             //  -- Generation --
-            double gen_value() const;
-            double gen_value(double t_min, double t_max) const;
+            double gen_value(Generator& t_rng) const;
+            double gen_value(double t_min, double t_max, Generator& t_rng) const;
 
           private:
             //  -- Interpolation --
             double get_cdf(double t_x) const;
+            double get_inverse_cdf(double t_cdf) const;
         };
 
 
@@ -13,6 +13,14 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <sys/resource.h>
+
 //  -- General --
 #include "gen/optics.hpp"
 #include "gen/rng.hpp"
@@ -20,9 +28,12 @@
 //  -- Utility --
 #include "utl/colourmap.hpp"
 #include "utl/file.hpp"
+#include "utl/stream.hpp"
+#include "utl/string.hpp"
 
 //  -- Classes --
 #include "cls/graphical/scene.hpp"
+#include "cls/setup/tallies.hpp"
 
 
 
@@ -42,27 +53,46 @@ namespace arc
          *  @param  t_json Json setup file.
          */
         Sim::Sim(const data::Json& t_json) :
+            m_num_phot(t_json["simulation"].parse_child<unsigned long int>("num_phot")),
+            m_chunk_size(t_json["system"].parse_child<unsigned long int>("chunk_size", 1000)),
+            m_max_threads(std::max(1u, std::min(std::thread::hardware_concurrency(),
+                                                t_json["system"].parse_child<unsigned int>("max_threads", 1)))),
+            m_first_phot(0),
+            m_last_phot(m_num_phot),
             m_loop_limit(t_json["optimisation"].parse_child<unsigned long int>("loop_limit")),
             m_roulette_weight(t_json["optimisation"]["roulette"].parse_child<double>("weight")),
             m_roulette_chambers(t_json["optimisation"]["roulette"].parse_child<double>("chambers")),
+            m_mesh_cache(t_json["system"].parse_child<bool>("mesh_cache", false)),
             m_aether(init_aether(t_json["simulation"]["aether"])),
             m_entity(init_entity(t_json["simulation"]["entities"])),
             m_light(init_light(t_json["simulation"]["lights"])),
             m_ccd(init_ccd(t_json["simulation"]["ccds"])),
             m_spectrometer(init_spectrometer(t_json["simulation"]["spectrometers"])),
             m_light_select(init_light_select()),
-            m_root(std::make_unique<tree::Cell>(t_json["tree"].parse_child<unsigned int>("min_depth"),
-                                                t_json["tree"].parse_child<unsigned int>("max_depth"),
-                                                t_json["tree"].parse_child<unsigned int>("max_tri"),
-                                                t_json["tree"].parse_child<math::Vec<3>>("min_bound"),
-                                                t_json["tree"].parse_child<math::Vec<3>>("max_bound"), m_entity, m_light, m_ccd,
-                                                m_spectrometer)),
-            m_scatters(0.0, 100.0, 100, true),
-            m_exit_weight(0.0, 1.0, 100, true),
+            m_seed(t_json["system"].parse_child("seed", static_cast<random::Generator::base>(time(nullptr)))),
+            m_features(init_features()),
+            m_kernel(init_kernel()),
+            m_root(init_root(t_json["tree"])),
+            m_layout(*m_root),
+            m_scatters(0.0, SCATTER_HIST_MAX, PHOT_HIST_BINS, true),
+            m_exit_weight(0.0, EXIT_WEIGHT_HIST_MAX, PHOT_HIST_BINS, true),
             m_log_update_period(t_json["system"].parse_child<double>("log_update_period")),
-            m_uniform_dist(0.0, 1.0)
+            m_image_format(data::Image::get_format(t_json["system"].parse_child<std::string>("image_format", "ppm_ascii"))),
+            m_hist_format(data::Histogram::get_format(t_json["system"].parse_child<std::string>("hist_format", "text"))),
+            m_save_volume(t_json["tree"].parse_child<bool>("save_volume", false)),
+            m_checkpoint_period(t_json["system"].parse_child<double>("checkpoint_period", 0.0)),
+            m_total(m_scatters, m_exit_weight, m_layout.get_total_leaves())
         {
             // Validate settings.
+            if (m_chunk_size == 0)
+            {
+                ERROR("Value of m_chunk_size is invalid.", "Value of m_chunk_size must be positive, but is: '0'.");
+            }
+            if (m_checkpoint_period < 0.0)
+            {
+                ERROR("Value of m_checkpoint_period is invalid.",
+                      "Value of m_checkpoint_period must be non-negative, but is: '" << m_checkpoint_period << "'.");
+            }
             if (m_roulette_weight < 0.0)
             {
                 ERROR("Value of m_roulette_weight is invalid.",
@@ -111,6 +141,14 @@ namespace arc
                                                                   << mat_min_bound << "' - '" << mat_max_bound << "'.");
             }
 
+            // Log the seed from which each photon's random number stream is formed.
+            LOG("Simulation seed    : " << m_seed);
+
+            // Log the features the transport kernel has been specialised on.
+            LOG("Kernel features    : " << ((m_features & HAS_ENTITIES) ? "entities " : "") << ((m_features & HAS_CCDS) ? "ccds " : "")
+                                        << ((m_features & HAS_SPECTROMETERS) ? "spectrometers " : "")
+                                        << ((m_features & HAS_ROULETTE) ? "roulette" : ""));
+
             // Log tree properties.
             LOG("Total tree cells   : " << m_root->get_total_cells());
             LOG("Max leaf triangles : " << m_root->get_max_tri());
@@ -188,8 +226,8 @@ namespace arc
                 VERB(entity_name[i] << " scale   : " << scale);
 
                 // Construct the entity object an add it to the vector of entities.
-                r_entity.emplace_back(equip::Entity(geom::Mesh(utl::read(mesh_path), trans, dir, rot, scale),
-                                                    phys::Material(utl::read(mat_path))));
+                r_entity.emplace_back(geom::Mesh::load(mesh_path, trans, dir, rot, scale, m_mesh_cache),
+                                      phys::Material(utl::read(mat_path)));
             }
 
             return (r_entity);
@@ -225,7 +263,8 @@ namespace arc
                 const auto   scale = json_light.parse_child<math::Vec<3>>("scale", math::Vec<3>(1.0, 1.0, 1.0));
 
                 // Get light properties.
-                const auto power = json_light.parse_child<double>("power");
+                const auto power      = json_light.parse_child<double>("power");
+                const auto table_size = json_light.parse_child<size_t>("spec_table_size", 0);
 
                 // Get file paths.
                 const std::string mesh_path = json_light.parse_child<std::string>("mesh");
@@ -235,15 +274,15 @@ namespace arc
                 VERB(light_name[i] << " material: " << utl::strip_extension(utl::strip_path(spec_path)));
                 VERB(light_name[i] << " tree    : " << utl::strip_extension(utl::strip_path(mesh_path)));
                 VERB(light_name[i] << " power   : " << power);
+                VERB(light_name[i] << " table   : " << table_size);
                 VERB(light_name[i] << " trans   : " << trans);
                 VERB(light_name[i] << " dir     : " << dir);
                 VERB(light_name[i] << " rot     : " << rot);
                 VERB(light_name[i] << " scale   : " << scale);
 
                 // Construct the light object an add it to the vector of lights.
-                r_light.emplace_back(
-                    equip::Light(geom::Mesh(utl::read(mesh_path), trans, dir, rot, scale), phys::Spectrum(utl::read(spec_path)),
-                                 power));
+                r_light.emplace_back(geom::Mesh::load(mesh_path, trans, dir, rot, scale, m_mesh_cache),
+                                     phys::Spectrum(utl::read(spec_path), table_size), power);
             }
 
             return (r_light);
@@ -343,14 +382,46 @@ namespace arc
                 VERB(spectrometer_name[i] << " bins    : " << bins);
 
                 // Construct the spectrometer object an add it to the vector of spectrometers.
-                r_spectrometer
-                    .emplace_back(spectrometer_name[i], geom::Mesh(utl::read(mesh_path), trans, dir, rot, scale), range[0],
-                                  range[1], bins);
+                r_spectrometer.emplace_back(spectrometer_name[i],
+                                            geom::Mesh::load(mesh_path, trans, dir, rot, scale, m_mesh_cache), range[0],
+                                            range[1], bins);
             }
 
             return (r_spectrometer);
         }
 
+        /**
+         *  Initialise the cell tree, building subtrees in parallel with up to the maximum number of threads.
+         *  The time taken and the peak memory of the process once built are logged.
+         *
+         *  @param  t_json  Json tree setup.
+         *
+         *  @return The initialised root cell of the tree.
+         */
+        std::unique_ptr<tree::Cell> Sim::init_root(const data::Json& t_json) const
+        {
+            // Get start time of the build.
+            const std::chrono::steady_clock::time_point build_start_time = std::chrono::steady_clock::now();
+
+            std::unique_ptr<tree::Cell> r_root = std::make_unique<tree::Cell>(
+                t_json.parse_child<unsigned int>("min_depth"), t_json.parse_child<unsigned int>("max_depth"),
+                t_json.parse_child<unsigned int>("max_tri"), t_json.parse_child<math::Vec<3>>("min_bound"),
+                t_json.parse_child<math::Vec<3>>("max_bound"), m_entity, m_light, m_ccd, m_spectrometer, m_max_threads);
+
+            const double build_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+                std::chrono::steady_clock::now() - build_start_time).count();
+
+            // Peak resident memory is reported by the system in kibibytes.
+            struct rusage usage{};
+            getrusage(RUSAGE_SELF, &usage);
+
+            LOG("Tree build threads : " << m_max_threads);
+            LOG("Tree build time    : " << utl::create_time_string(build_time));
+            LOG("Peak memory        : " << (usage.ru_maxrss / 1024) << " MiB");
+
+            return (r_root);
+        }
+
         /**
          *  Construct the light index selector object.
          *
@@ -368,6 +439,61 @@ namespace arc
             return (random::Index(power));
         }
 
+        /**
+         *  Initialise the mask of features present within the simulation.
+         *
+         *  @return The initialised mask of features present.
+         */
+        unsigned int Sim::init_features() const
+        {
+            unsigned int r_features = 0;
+
+            if (!m_entity.empty())
+            {
+                r_features |= HAS_ENTITIES;
+            }
+            if (!m_ccd.empty())
+            {
+                r_features |= HAS_CCDS;
+            }
+            if (!m_spectrometer.empty())
+            {
+                r_features |= HAS_SPECTROMETERS;
+            }
+            if (m_roulette_weight > 0.0)
+            {
+                r_features |= HAS_ROULETTE;
+            }
+
+            return (r_features);
+        }
+
+        /**
+         *  Initialise the transport kernel by selecting the instantiation specialised on the features present.
+         *  Each call checks one feature set and recurses on to the next, so every feature set is instantiated.
+         *
+         *  @tparam FEATURES    Feature set to check.
+         *
+         *  @pre    m_features must be less than NUM_FEATURE_SETS.
+         *
+         *  @return The transport kernel specialised on the features present.
+         */
+        template <unsigned int FEATURES>
+        Sim::kernel Sim::init_kernel() const
+        {
+            assert(m_features < NUM_FEATURE_SETS);
+
+            if constexpr (FEATURES + 1 < NUM_FEATURE_SETS)
+            {
+                if (m_features != FEATURES)
+                {
+                    return (init_kernel<FEATURES + 1>());
+                }
+            }
+
+            return (&Sim::run_kernel<FEATURES>);
+        }
+
 
 
         //  == METHODS ==
@@ -378,12 +504,13 @@ namespace arc
         void Sim::get_error_report() const
         {
             // Calculate total error.
-            const double total_error = m_error_loop + m_error_prox;
+            const double total_error = m_error_loop + m_error_prox + m_error_nest;
 
             if (total_error > 0.0)
             {
                 WARN("Photon weight was lost.", "Total weight lost to proximity errors : " << m_error_prox);
                 WARN("Photon weight was lost.", "Total weight lost to exceeding set loop limit : " << m_error_loop);
+                WARN("Photon weight was lost.", "Total weight lost to exceeding nesting depth : " << m_error_nest);
             }
             else
             {
@@ -394,7 +521,11 @@ namespace arc
 
         //  -- Setters --
         /**
-         *  Set the number of threads by initialising the thread progress vector.
+         *  Set the number of threads by creating a worker, holding the per-thread run state, for each thread.
+         *  Each chunk of photons is tallied separately, so enough chunk tallies are created for every thread to hold
+         *  one, along with spares to hold chunks finished ahead of those still running.
+         *  Also resets the photon scheduler, so must be called before the threads are started.
+         *  Data loaded from a checkpoint is retained.
          *
          *  @param  t_num_threads   Number of simulation threads.
          *
@@ -403,615 +534,1213 @@ namespace arc
         void Sim::set_num_threads(const unsigned int t_num_threads)
         {
             assert(t_num_threads != 0);
-            m_thread_progress = std::vector<double>(t_num_threads, 0.0);
 
-            // Random number generator initialisation.
-            const auto seed = static_cast<size_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-            LOG("Simulation seed: " << seed);
+            // Reset the scheduler, and the merge, to the start of the shard.
+            m_next_phot  = m_first_phot;
+            m_next_merge = m_first_phot;
+
+            // Give each thread its own worker.
+            m_worker.clear();
+            for (size_t i = 0; i < t_num_threads; ++i)
+            {
+                m_worker.push_back(std::make_unique<Worker>());
+            }
+
+            // Give each thread its own chunk tally, with histograms copied from the still empty simulation histograms.
+            m_chunk_tally.clear();
+            m_done_chunk.clear();
             for (size_t i = 0; i < t_num_threads; ++i)
             {
-                m_rng_engine.emplace_back(seed + i);
+                m_chunk_tally.push_back(std::make_unique<Tally>(m_scatters, m_exit_weight, m_layout.get_total_leaves(), i));
+            }
+
+            // Give each chunk tally its own detector data, with a final slot holding the merged data.
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                m_ccd[i].set_num_slots(t_num_threads + 1);
+            }
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                m_spectrometer[i].set_num_slots(t_num_threads + 1);
             }
         }
 
+        /**
+         *  Restrict the run to a single shard of the photons, so the simulation may be spread across several processes.
+         *  Photons are split into contiguous shards of as even a size as possible.
+         *  Each photon draws from its own random number stream, so shards run with the same seed sum to a single run.
+         *  Must be called before the number of threads is set.
+         *
+         *  @param  t_shard_index   Index of the shard to run.
+         *  @param  t_num_shards    Total number of shards the photons are split into.
+         */
+        void Sim::set_shard(const unsigned long int t_shard_index, const unsigned long int t_num_shards)
+        {
+            if (t_shard_index >= t_num_shards)
+            {
+                ERROR("Unable to set simulation shard.",
+                      "Shard index: '" << t_shard_index << "', must be less than the number of shards: '" << t_num_shards
+                                       << "'.");
+            }
+
+            // Split the photons evenly, handing any remainder to the first shards.
+            const unsigned long int shard_size = m_num_phot / t_num_shards;
+            const unsigned long int remainder  = m_num_phot % t_num_shards;
+
+            m_first_phot = (t_shard_index * shard_size) + std::min(t_shard_index, remainder);
+            m_last_phot  = m_first_phot + shard_size + ((t_shard_index < remainder) ? 1 : 0);
+
+            LOG("Shard photons      : " << m_first_phot << " - " << m_last_phot);
+        }
+
 
         //  -- Saving --
         /**
-         *  Save the tree images.
+         *  Save all simulation data, each type of data within its own sub-directory.
+         *  The data merged from the chunks is saved by a setup::Tallies object, so a simulation saves its data exactly as
+         *  merged tally files are saved.
          *
-         *  @param  t_output_dir    Directory to write the images to.
-         *  @param  t_level         Level of depth resolution to save images with.
+         *  @param  t_output_dir    Directory to write the data to.
+         *  @param  t_image_res     Level of depth resolution to save tree images with.
          */
-        void Sim::save_tree_images(const std::string& t_output_dir, const size_t t_level) const
+        void Sim::save_data(const std::string& t_output_dir, const size_t t_image_res) const
         {
-            // Form the data cube.
-            std::vector<std::vector<std::vector<double>>> data_cube = m_root->get_data_cube(t_level);
+            Tallies(*this).save_data(t_output_dir, t_image_res);
+        }
+
 
-            // Normalise the data cube.
-            double      max = 0.0;
-            size_t      res = data_cube.size();
-            for (size_t i   = 0; i < res; ++i)
+        //  -- Rendering --
+        /**
+         *  Render a scene of the current simulation.
+         */
+        void Sim::render() const
+        {
+#ifdef ENABLE_GRAPHICS
+            // Create a graphical scene.
+            graphical::Scene scene;
+
+            // Add objects to the scene.
+            scene.add_light_vector(m_light);
+            scene.add_entity_vector(m_entity);
+            scene.add_ccd_vector(m_ccd);
+            scene.add_spectrometer_vector(m_spectrometer);
+#ifdef ENABLE_PHOTON_PATHS
+            scene.add_photon_vector(m_path);
+#endif
+            scene.add_tree(m_root);
+
+            // Render the scene.
+            while (!scene.should_close())
+            {
+                scene.handle_input();
+                scene.render();
+            }
+#else
+            WARN("Unable to render scene.", "GRAPHICS compile-time option has been set to off.");
+#endif
+        }
+
+
+        //  -- Tallies --
+        /**
+         *  Add the data tallied within a tally file, written by save_tallies, to the simulation.
+         *  Files are read a section at a time and added straight into the simulation totals, so any number of shard
+         *  files may be merged in turn.
+         *
+         *  @param  t_path  Path to the tally file.
+         */
+        void Sim::merge_tallies(const std::string& t_path)
+        {
+            // Open the file.
+            std::ifstream file(t_path, std::ios::binary);
+            if (!file)
+            {
+                ERROR("Unable to read tally file.", "Unable to open file: '" << t_path << "'.");
+            }
+
+            // Check the header.
+            unsigned long int magic   = 0;
+            unsigned long int version = 0;
+            utl::read_binary(file, magic);
+            utl::read_binary(file, version);
+            if (!file || (magic != TALLY_MAGIC) || (version != TALLY_VERSION))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is not a tally file of this version.");
+            }
+
+            // Check the file was written by a matching simulation.
+            random::Generator::base seed = 0;
+            utl::read_binary(file, seed);
+            if (seed != m_seed)
             {
-                for (size_t j = 0; j < res; ++j)
+                ERROR("Unable to read tally file.",
+                      "File seed: '" << seed << "', does not match the simulation seed: '" << m_seed << "'.");
+            }
+            tree::Layout layout;
+            layout.read_binary(file);
+            if (!(layout == m_layout))
+            {
+                ERROR("Unable to read tally file.", "File tree does not match that of the simulation.");
+            }
+
+            // Check the detectors match those of the simulation.
+            unsigned long int num_ccd = 0;
+            utl::read_binary(file, num_ccd);
+            if (num_ccd != m_ccd.size())
+            {
+                ERROR("Unable to read tally file.", "File ccds do not match those of the simulation.");
+            }
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                std::string       name;
+                unsigned long int width  = 0;
+                unsigned long int height = 0;
+                utl::read_binary(file, name);
+                utl::read_binary(file, width);
+                utl::read_binary(file, height);
+                if ((name != m_ccd[i].get_name()) || (width != m_ccd[i].get_width()) || (height != m_ccd[i].get_height()))
                 {
-                    for (size_t k = 0; k < res; ++k)
-                    {
-                        if (data_cube[i][j][k] > max)
-                        {
-                            max = data_cube[i][j][k];
-                        }
-                    }
+                    ERROR("Unable to read tally file.", "File ccds do not match those of the simulation.");
                 }
             }
-            assert(max > 0.0);
-            for (size_t i = 0; i < res; ++i)
+            unsigned long int num_spectrometer = 0;
+            utl::read_binary(file, num_spectrometer);
+            if (num_spectrometer != m_spectrometer.size())
+            {
+                ERROR("Unable to read tally file.", "File spectrometers do not match those of the simulation.");
+            }
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
             {
-                for (size_t j = 0; j < res; ++j)
+                std::string       name;
+                double            min_bound = 0.0;
+                double            max_bound = 0.0;
+                unsigned long int num_bin   = 0;
+                utl::read_binary(file, name);
+                utl::read_binary(file, min_bound);
+                utl::read_binary(file, max_bound);
+                utl::read_binary(file, num_bin);
+                if ((name != m_spectrometer[i].get_name()) || (min_bound != m_spectrometer[i].get_min_bound())
+                    || (max_bound != m_spectrometer[i].get_max_bound()) || (num_bin != m_spectrometer[i].get_num_bin()))
                 {
-                    for (size_t k = 0; k < res; ++k)
-                    {
-                        data_cube[i][j][k] /= max;
-                    }
+                    ERROR("Unable to read tally file.", "File spectrometers do not match those of the simulation.");
                 }
             }
+            if (!file)
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+            }
+
+            // Read the error counters.
+            Tally tally(m_scatters, m_exit_weight, 0);
+            utl::read_binary(file, tally.error_loop);
+            utl::read_binary(file, tally.error_prox);
+            utl::read_binary(file, tally.error_nest);
+            m_total.error_loop += tally.error_loop;
+            m_total.error_prox += tally.error_prox;
+            m_total.error_nest += tally.error_nest;
+
+            // Read the histograms.
+            tally.scatters.read_binary(file);
+            tally.exit_weight.read_binary(file);
+            m_total.scatters += tally.scatters;
+            m_total.exit_weight += tally.exit_weight;
+
+            // Read the cell energy tallies.
+            utl::read_binary(file, tally.cell_energy);
+            if (!file || (tally.cell_energy.size() != m_total.cell_energy.size()))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+            }
+            for (size_t i = 0; i < tally.cell_energy.size(); ++i)
+            {
+                m_total.cell_energy[i] += tally.cell_energy[i];
+            }
 
-            // Save slices of the data cube.
-            save_slices(t_output_dir, X, data_cube);
-            save_slices(t_output_dir, Y, data_cube);
-            save_slices(t_output_dir, Z, data_cube);
+            // Read the ranges of photons tallied.
+            utl::read_binary(file, tally.phot_range);
+            for (size_t i = 0; i < tally.phot_range.size(); ++i)
+            {
+                if ((tally.phot_range[i][0] >= tally.phot_range[i][1]) || (tally.phot_range[i][1] > m_num_phot))
+                {
+                    ERROR("Unable to read tally file.",
+                          "File: '" << t_path << "' holds photons beyond the number of photons to run: '" << m_num_phot
+                                    << "'.");
+                }
+            }
+            if (!m_total.add_ranges(tally.phot_range))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' holds photons which have already been tallied.");
+            }
+
+            // Read the detector data.
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                m_ccd[i].read_binary(file);
+            }
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                m_spectrometer[i].read_binary(file);
+            }
+            if (!file)
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+            }
         }
 
         /**
-         *  Save the slices of one dimension of the tree.
+         *  Save the raw, un-normalised, data tallied so far to a binary tally file.
+         *  The file begins with the layout of the leaf cells and a description of each detector, so it may be merged by
+         *  a setup::Tallies object without building the simulation.
+         *  Must not be called while the simulation threads are running, use checkpoint instead.
          *
-         *  @param  t_output_dir    Directory to write the images to.
-         *  @param  t_dimension     Dimension to be sliced.
-         *  @param  t_data          Data to be sliced into images.
+         *  @param  t_path  Path to write the tally file to.
          *
-         *  @pre    t_dimension must be less than three.
+         *  @return True if the file was written successfully.
          */
-        void Sim::save_slices(const std::string& t_output_dir, const size_t t_dimension,
-                              const std::vector<std::vector<std::vector<double>>>& t_data) const
+        bool Sim::save_tallies(const std::string& t_path) const
         {
-            assert(t_dimension < 3);
+            // Gather the merged detector data.
+            std::vector<data::Image> ccd_image;
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                ccd_image.push_back(m_ccd[i].get_merged_image());
+            }
+            std::vector<data::Histogram> spectrometer_data;
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                spectrometer_data.push_back(m_spectrometer[i].get_merged_data());
+            }
 
-            // Determine image resolution.
-            size_t res = t_data.size();
+            return (write_tallies(t_path, m_total, ccd_image, spectrometer_data));
+        }
 
-            // Set dimensions.
-            size_t      width, height, slice;
-            std::string dim_name;
-            switch (t_dimension)
+        /**
+         *  Write given tallied data to a binary tally file.
+         *  The file begins with the layout of the leaf cells and a description of each detector, so it may be merged by
+         *  a setup::Tallies object without building the simulation.
+         *  The file is written to a temporary path, then renamed, so an existing file is never left incomplete.
+         *
+         *  @param  t_path              Path to write the tally file to.
+         *  @param  t_total             Data merged from chunks.
+         *  @param  t_ccd_image         Image merged by each ccd.
+         *  @param  t_spectrometer_data Histogram merged by each spectrometer.
+         *
+         *  @return True if the file was written successfully.
+         */
+        bool Sim::write_tallies(const std::string& t_path, const Tally& t_total,
+                                const std::vector<data::Image>& t_ccd_image,
+                                const std::vector<data::Histogram>& t_spectrometer_data) const
+        {
+            // Write the header.
+            const std::string tmp_path = t_path + ".tmp";
+            std::ofstream     file(tmp_path, std::ios::binary);
+            utl::write_binary(file, TALLY_MAGIC);
+            utl::write_binary(file, TALLY_VERSION);
+            utl::write_binary(file, m_seed);
+
+            // Write the leaf geometry and detector descriptions, so the file may be merged without the simulation.
+            m_layout.write_binary(file);
+            utl::write_binary(file, static_cast<unsigned long int>(m_ccd.size()));
+            for (size_t i = 0; i < m_ccd.size(); ++i)
             {
-                case X:
-                    width    = Y;
-                    height   = Z;
-                    slice    = X;
-                    dim_name = "X";
-                    break;
-                case Y:
-                    width    = X;
-                    height   = Z;
-                    slice    = Y;
-                    dim_name = "Y";
-                    break;
-                case Z:
-                    width    = X;
-                    height   = Y;
-                    slice    = Z;
-                    dim_name = "Z";
-                    break;
-                default: ERROR("Unable to save tree slice images.",
-                               "The given slice dimension: '" << t_dimension << "' is invalid.");
+                utl::write_binary(file, m_ccd[i].get_name());
+                utl::write_binary(file, static_cast<unsigned long int>(m_ccd[i].get_width()));
+                utl::write_binary(file, static_cast<unsigned long int>(m_ccd[i].get_height()));
+            }
+            utl::write_binary(file, static_cast<unsigned long int>(m_spectrometer.size()));
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                utl::write_binary(file, m_spectrometer[i].get_name());
+                utl::write_binary(file, m_spectrometer[i].get_min_bound());
+                utl::write_binary(file, m_spectrometer[i].get_max_bound());
+                utl::write_binary(file, static_cast<unsigned long int>(m_spectrometer[i].get_num_bin()));
             }
 
-            // Create sub-directory.
-            const std::string sub_dir = t_output_dir + "tree_" + dim_name + "_slices/";
-            utl::create_directory(sub_dir);
+            // Write the tallied data.
+            utl::write_binary(file, t_total.error_loop);
+            utl::write_binary(file, t_total.error_prox);
+            utl::write_binary(file, t_total.error_nest);
+            t_total.scatters.write_binary(file);
+            t_total.exit_weight.write_binary(file);
+            utl::write_binary(file, t_total.cell_energy);
+            utl::write_binary(file, t_total.phot_range);
+            for (size_t i = 0; i < t_ccd_image.size(); ++i)
+            {
+                t_ccd_image[i].write_binary(file);
+            }
+            for (size_t i = 0; i < t_spectrometer_data.size(); ++i)
+            {
+                t_spectrometer_data[i].write_binary(file);
+            }
+            file.close();
 
-            // Write the images.
-            for (size_t i = 0; i < res; ++i)
+            // Replace the previous file.
+            if (!file || (std::rename(tmp_path.c_str(), t_path.c_str()) != 0))
             {
-                TEMP("Saving " + dim_name + " slices", 100.0 * i / res);
+                WARN("Unable to save tally file.", "Unable to write file: '" << t_path << "'.");
 
-                // Create the image.
-                data::Image img(res, res);
+                return (false);
+            }
+
+            return (true);
+        }
+
+
+        //  -- Checkpointing --
+        /**
+         *  Load the data tallied by a previous run from a checkpoint file.
+         *  Photons completed by the previous run are skipped, so the simulation continues on to the requested number of
+         *  photons.
+         *  Must be called after any shard has been set, and before the threads are started.
+         *
+         *  @param  t_path  Path to the checkpoint file.
+         */
+        void Sim::load_checkpoint(const std::string& t_path)
+        {
+            merge_tallies(t_path);
 
-                // Write each pixel.
-                for (size_t j = 0; j < res; ++j)
+            // Record the photons already completed.
+            m_resumed      = m_total.phot_range;
+            m_resumed_phot = 0;
+            for (size_t i = 0; i < m_resumed.size(); ++i)
+            {
+                if ((m_resumed[i][0] < m_first_phot) || (m_resumed[i][1] > m_last_phot))
                 {
-                    for (size_t k = 0; k < res; ++k)
-                    {
-                        switch (t_dimension)
-                        {
-                            case X:
-                                img.add_to_pixel(j, k, utl::colourmap::transform_rainbow(t_data[i][j][k]));
-                                break;
-                            case Y:
-                                img.add_to_pixel(j, k, utl::colourmap::transform_rainbow(t_data[j][i][k]));
-                                break;
-                            case Z:
-                                img.add_to_pixel(j, k, utl::colourmap::transform_rainbow(t_data[j][k][i]));
-                                break;
-                            default: ERROR("Unable to save tree slice images.",
-                                           "The given slice dimension: '" << t_dimension << "' is invalid.");
-                        }
-                    }
+                    ERROR("Unable to load checkpoint.",
+                          "Checkpoint holds photons outside of the photons of this run: '" << m_first_phot << "' - '"
+                                                                                           << m_last_phot << "'.");
                 }
 
-                // Save the image.
-                img.save(sub_dir + dim_name + "_" + std::to_string(i) + ".ppm");
+                m_resumed_phot += m_resumed[i][1] - m_resumed[i][0];
             }
 
-            LOG("Grid " << dim_name << " slice image saving complete.");
+            LOG("Resumed photons    : " << m_resumed_phot);
         }
 
         /**
-         *  Save the ccd images.
+         *  Write checkpoints periodically until stop_checkpoints is called.
+         *  Should be run on its own thread alongside the simulation threads.
          *
-         *  @param  t_output_dir    Directory to write the images to.
+         *  @param  t_path  Path to write the checkpoint file to.
          */
-        void Sim::save_ccd_images(const std::string& t_output_dir) const
+        void Sim::run_checkpoints(const std::string& t_path)
         {
-            // Get the maximum rgb values.
-            double      max = 0.0;
-            for (size_t i   = 0; i < m_ccd.size(); ++i)
+            std::unique_lock<std::mutex> lock(m_checkpoint_mutex);
+            while (!m_checkpoint_cv.wait_for(lock, std::chrono::duration<double>(m_checkpoint_period),
+                                             [this]() { return (m_checkpoint_stop); }))
             {
-                std::array<double, 3> ccd_max = m_ccd[i].get_max_value();
-                for (size_t           j       = 0; j < 3; ++j)
-                {
-                    if (ccd_max[j] > max)
-                    {
-                        max = ccd_max[j];
-                    }
-                }
+                checkpoint(t_path);
             }
+        }
 
-            // Check maximum was not zero.
-            if ((!m_ccd.empty()) && (max <= 0.0))
+        /**
+         *  Stop the thread running checkpoints, waiting for any checkpoint underway to be written first.
+         */
+        void Sim::stop_checkpoints()
+        {
             {
-                WARN("Unable to save ccd images.", "Maximum pixel value was less than, or equal to, zero.");
-
-                return;
+                std::lock_guard<std::mutex> lock(m_checkpoint_mutex);
+                m_checkpoint_stop = true;
             }
 
-            // Save each ccd image.
+            m_checkpoint_cv.notify_one();
+        }
+
+        /**
+         *  Write a checkpoint of the photons merged into the total so far.
+         *  Chunks are merged in order, so the checkpoint always holds an unbroken run of chunks, and a run resumed from
+         *  it tallies exactly as a run which was never stopped.
+         *  The merged data is copied under the lock, and written once the lock is released, so threads merging chunks
+         *  wait only for the copy and never for the file.
+         *
+         *  @param  t_path  Path to write the checkpoint file to.
+         */
+        void Sim::checkpoint(const std::string& t_path)
+        {
+            // Copy the merged data.
+            std::unique_lock<std::mutex> lock(m_tally_mutex);
+            const Tally                  total = m_total;
+            std::vector<data::Image>     ccd_image;
             for (size_t i = 0; i < m_ccd.size(); ++i)
             {
-                m_ccd[i].save(t_output_dir, max);
+                ccd_image.push_back(m_ccd[i].get_merged_image());
             }
+            std::vector<data::Histogram> spectrometer_data;
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                spectrometer_data.push_back(m_spectrometer[i].get_merged_data());
+            }
+            lock.unlock();
 
-            LOG("CCD image saving complete.");
+            // Write the copy.
+            if (write_tallies(t_path, total, ccd_image, spectrometer_data))
+            {
+                VERB("Checkpoint written : " << total.get_num_phot() << " photons complete.");
+            }
         }
 
         /**
-         *  Save the spectrometer data.
+         *  Merge a finished chunk into the total.
+         *  Only the leaf cells, pixels and bins given weight are visited.
          *
-         *  @param  t_output_dir    Directory to write the images to.
+         *  @param  t_chunk Chunk to merge.
          */
-        void Sim::save_spectrometer_data(const std::string& t_output_dir) const
+        void Sim::retire_chunk(const Chunk& t_chunk)
         {
-            // Save each spectrometer's data.
+            // Chunks holding no photons hold no data.
+            if (t_chunk.phot_range.empty())
+            {
+                return;
+            }
+
+            // Add the error counters.
+            m_total.error_loop += t_chunk.error_loop;
+            m_total.error_prox += t_chunk.error_prox;
+            m_total.error_nest += t_chunk.error_nest;
+
+            // Add the histograms.
+            m_total.scatters += t_chunk.scatters;
+            m_total.exit_weight += t_chunk.exit_weight;
+
+            // Add the cell energy tallies.
+            for (size_t i = 0; i < t_chunk.cell_energy.size(); ++i)
+            {
+                m_total.cell_energy[t_chunk.cell_energy[i].first] += t_chunk.cell_energy[i].second;
+            }
+
+            // Add the detector data.
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                m_ccd[i].add_pixels(t_chunk.ccd[i]);
+            }
             for (size_t i = 0; i < m_spectrometer.size(); ++i)
             {
-                m_spectrometer[i].save(t_output_dir);
+                m_spectrometer[i].add_bins(t_chunk.spectrometer[i]);
             }
 
-            LOG("Spectrometer data saving complete.");
+            // Add the photon ranges.
+            if (!m_total.add_ranges(t_chunk.phot_range))
+            {
+                ERROR("Unable to merge tally.", "Photons have been tallied more than once.");
+            }
         }
 
         /**
-         *  Save the histogram data.
+         *  Add ranges of photon indices to those of the tally.
+         *  The ranges are kept sorted, with touching ranges joined.
          *
-         *  @param  t_output_dir    Directory to write the histograms to.
+         *  @param  t_range Ranges of photon indices to add.
+         *
+         *  @return False if any of the added photons had already been tallied.
          */
-        void Sim::save_histogram_data(const std::string& t_output_dir) const
+        bool Sim::Tally::add_ranges(const std::vector<std::array<unsigned long int, 2>>& t_range)
         {
-            // Save the scattering data.
-            m_scatters.save(t_output_dir + "scatters.dat");
+            phot_range.insert(phot_range.end(), t_range.begin(), t_range.end());
+            std::sort(phot_range.begin(), phot_range.end());
 
-            // Save the exit weight data.
-            m_exit_weight.save(t_output_dir + "weight.dat");
-        }
+            bool   disjoint  = true;
+            size_t num_range = 0;
+            for (size_t i = 0; i < phot_range.size(); ++i)
+            {
+                if ((num_range > 0) && (phot_range[num_range - 1][1] >= phot_range[i][0]))
+                {
+                    disjoint = disjoint && (phot_range[num_range - 1][1] == phot_range[i][0]);
+
+                    phot_range[num_range - 1][1] = std::max(phot_range[num_range - 1][1], phot_range[i][1]);
+                }
+                else
+                {
+                    phot_range[num_range++] = phot_range[i];
+                }
+            }
+            phot_range.resize(num_range);
 
+            return (disjoint);
+        }
 
-        //  -- Rendering --
         /**
-         *  Render a scene of the current simulation.
+         *  Count the photons tallied.
+         *
+         *  @return The total number of photons within the photon ranges.
          */
-        void Sim::render() const
+        unsigned long int Sim::Tally::get_num_phot() const
         {
-#ifdef ENABLE_GRAPHICS
-            // Create a graphical scene.
-            graphical::Scene scene;
-
-            // Add objects to the scene.
-            scene.add_light_vector(m_light);
-            scene.add_entity_vector(m_entity);
-            scene.add_ccd_vector(m_ccd);
-            scene.add_spectrometer_vector(m_spectrometer);
-#ifdef ENABLE_PHOTON_PATHS
-            scene.add_photon_vector(m_path);
-#endif
-            scene.add_tree(m_root);
+            unsigned long int r_num_phot = 0;
 
-            // Render the scene.
-            while (!scene.should_close())
+            for (size_t i = 0; i < phot_range.size(); ++i)
             {
-                scene.handle_input();
-                scene.render();
+                r_num_phot += phot_range[i][1] - phot_range[i][0];
             }
-#else
-            WARN("Unable to render scene.", "GRAPHICS compile-time option has been set to off.");
-#endif
+
+            return (r_num_phot);
         }
 
 
         //  -- Simulation --
         /**
-         *  Run a number of photons through the simulation.
+         *  Run photons through the simulation until all photons have been handed out.
+         *  The transport kernel specialised on the features of the simulation is run.
          *
-         *  @param  t_num_phot      The number of photons to run.
-         *  @param  t_thread_index  Index of the thread running this batch of photons.
+         *  @param  t_thread_index  Index of the thread running the photons.
          */
-        void Sim::run_photons(const unsigned long int t_num_phot, const size_t t_thread_index)
+        void Sim::run_photons(const size_t t_thread_index)
         {
-            // Run each photon through the simulation.
-            for (unsigned long int i = 0; i < t_num_phot; ++i)
-            {
-                // Set loop progress.
-                m_thread_progress[t_thread_index] = (100.0 * i) / t_num_phot;
-
-                // Print loop progress.
-                log_progress();
-
-                // Emit a new photon.
-                phys::Photon phot = m_light[m_light_select.gen_index()].gen_photon(m_aether);
+            (this->*m_kernel)(t_thread_index);
+        }
 
-                // Initialise tracked properties.
-                tree::Cell* cell = nullptr;             //! Pointer to current cell containing the photon.
-                double            cell_energy = 0.0;    //! Energy to be added to cell total when exiting cell.
-                unsigned long int loops       = 0;      //! Number of loops made of the while loop.
-                unsigned long int num_scat    = 0;      //! Number of photon scatterings made.
+        /**
+         *  Run photons through the simulation until all photons have been handed out, using only the features given.
+         *  Chunks of consecutive photon indices are taken from a shared atomic counter, so threads which draw cheap
+         *  photons simply take more chunks rather than sitting idle while others finish.
+         *  Each chunk is tallied separately, and merged into the total in chunk order, so the data tallied does not
+         *  depend upon the number of threads or upon which thread ran each chunk.
+         *
+         *  @tparam FEATURES    Features present within the simulation.
+         *
+         *  @param  t_thread_index  Index of the thread running the photons.
+         */
+        template <unsigned int FEATURES>
+        void Sim::run_kernel(const size_t t_thread_index)
+        {
+            // Get the run state of this thread.
+            Worker& worker = *m_worker[t_thread_index];
 
-                // Check if photon is within a tree cell.
-                if (!m_root->is_within(phot.get_pos()))
+            // Take chunks of photons until none remain.
+            Tally& tally = *m_chunk_tally[t_thread_index];
+            while (true)
+            {
+                const unsigned long int first_phot = m_next_phot.fetch_add(m_chunk_size);
+                if (first_phot >= m_last_phot)
                 {
-                    WARN("Unable to simulate photon.", "Photon does not begin with the tree.");
-                    goto kill_photon;
+                    break;
                 }
-                else
+                const unsigned long int last_phot = std::min(first_phot + m_chunk_size, m_last_phot);
+
+                // Run each photon of the chunk through the simulation, skipping those completed before resuming.
+                unsigned long int num_run = 0;
+                for (unsigned long int i = next_pending(first_phot); i < last_phot; i = next_pending(i + 1))
                 {
-                    cell = m_root->get_leaf(phot.get_pos());
-                    assert(cell != nullptr);
+                    run_photon<FEATURES>(i, tally);
+                    ++num_run;
                 }
+                merge_chunk(first_phot, take_chunk(tally));
 
-                // Loop until exit condition is met.
-                while (true)
-                {
-                    // Increment loop counter.
-                    ++loops;
+                // Update and print loop progress.
+                worker.progress += num_run;
+                log_progress();
+            }
+        }
 
-                    // Kill if photon is stuck.
-                    if (loops > m_loop_limit)
-                    {
-                        m_counter_mutex.lock();
-                        m_error_loop += phot.get_weight();
-                        m_counter_mutex.unlock();
+        /**
+         *  Run a single photon through the simulation.
+         *  The photon draws from its own random number stream, keyed on the simulation seed and the photon index, so its
+         *  history does not depend upon which thread runs it, or upon any other photon.
+         *
+         *  @tparam FEATURES    Features present within the simulation.
+         *
+         *  @param  t_phot_index    Index of the photon to run.
+         *  @param  t_tally         Tally of the chunk holding the photon.
+         */
+        template <unsigned int FEATURES>
+        void Sim::run_photon(const unsigned long int t_phot_index, Tally& t_tally)
+        {
+            // Record the photon within the tally.
+            t_tally.add_phot(t_phot_index);
 
-                        goto kill_photon;
-                    }
+            // Create the random number stream of this photon.
+            random::Generator rng(m_seed, t_phot_index);
+
+            // Emit a new photon.
+            phys::Photon phot = m_light[m_light_select.gen_index(rng)].gen_photon(m_aether, rng);
+
+            // Initialise tracked properties.
+            tree::Cell* cell = nullptr;             //! Pointer to current cell containing the photon.
+            double            cell_energy = 0.0;    //! Energy to be added to cell total when exiting cell.
+            unsigned long int loops       = 0;      //! Number of loops made of the while loop.
+            unsigned long int num_scat    = 0;      //! Number of photon scatterings made.
+
+            // Check if photon is within a tree cell.
+            bool alive = m_root->is_within(phot.get_pos());
+            if (alive)
+            {
+                cell = m_root->get_leaf(phot.get_pos());
+                assert(cell != nullptr);
+            }
+            else
+            {
+                WARN("Unable to simulate photon.", "Photon does not begin with the tree.");
+            }
 
-                    // Roulette optimisation.
-                    if (phot.get_weight() <= m_roulette_weight)
+            // Loop until exit condition is met.
+            while (alive && check_photon<FEATURES>(phot, loops, rng, t_tally))
+            {
+                // Determine event distances.
+                event  event_type;              //! Event type.
+                double dist;                    //! Distance to the event.
+                size_t equip_index, tri_index;  //! Indices of hit equipment and triangle if hit at all.
+                std::tie(event_type, dist, equip_index, tri_index) = determine_event<FEATURES>(phot, cell, rng);
+
+                // Track properties.
+                cell_energy += dist * phot.get_weight();
+
+                // Perform the event.
+                alive = run_event<FEATURES>(event_type, phot, dist, equip_index, tri_index, cell, cell_energy, num_scat,
+                                            rng, t_tally);
+            }
+
+            // Record the dead photon.
+            finish_photon(phot, num_scat, t_tally);
+        }
+
+        /**
+         *  Perform an event upon a photon.
+         *  Events involving features absent from the simulation are compiled out.
+         *
+         *  @tparam FEATURES    Features present within the simulation.
+         *
+         *  @param  t_event         Type of event to perform.
+         *  @param  t_phot          Photon undergoing the event.
+         *  @param  t_dist          Distance to the event.
+         *  @param  t_equip_index   Index of the equipment involved, or the face crossed for a cell crossing.
+         *  @param  t_tri_index     Index of the triangle involved.
+         *  @param  t_cell          Leaf cell containing the photon, updated when crossing cells.
+         *  @param  t_cell_energy   Energy to add to the cell when exiting.
+         *  @param  t_num_scat      Number of scatterings made by the photon.
+         *  @param  t_rng           Random number stream of the photon.
+         *  @param  t_tally         Tally the photon is recorded within.
+         *
+         *  @return True if the photon survives the event.
+         */
+        template <unsigned int FEATURES>
+        bool Sim::run_event(const event t_event, phys::Photon& t_phot, const double t_dist, const size_t t_equip_index,
+                            const size_t t_tri_index, tree::Cell*& t_cell, double& t_cell_energy,
+                            unsigned long int& t_num_scat, random::Generator& t_rng, Tally& t_tally)
+        {
+            switch (t_event)
+            {
+                case event::SCATTER:
+                    ++t_num_scat;
+                    return (scatter_photon(t_phot, t_dist, t_rng));
+                case event::CELL_CROSS:
+                    return (cross_cell(t_phot, t_dist, t_equip_index, t_cell, t_cell_energy, t_tally));
+                case event::ENTITY_HIT:
+                    if constexpr ((FEATURES & HAS_ENTITIES) != 0)
+                    {
+                        return (hit_entity(t_phot, t_dist, t_equip_index, t_tri_index, t_rng, t_tally));
+                    }
+                    break;
+                case event::CCD_HIT:
+                    if constexpr ((FEATURES & HAS_CCDS) != 0)
                     {
-                        if (m_uniform_dist(m_rng_engine[t_thread_index]) <= (1.0 / m_roulette_chambers))
-                        {
-                            phot.multiply_weight(m_roulette_chambers);
-                        }
-                        else
-                        {
-                            goto kill_photon;
-                        }
+                        return (hit_ccd(t_phot, t_dist, t_equip_index, t_tri_index, t_tally));
                     }
+                    break;
+                case event::SPECTROMETER_HIT:
+                    if constexpr ((FEATURES & HAS_SPECTROMETERS) != 0)
+                    {
+                        return (hit_spectrometer(t_phot, t_dist, t_equip_index, t_tri_index, t_tally));
+                    }
+                    break;
+            }
+
+            ERROR("Unable to simulate photon.", "Code should be unreachable.");
+        }
 
-                    // Determine event distances.
-                    event  event_type;              //! Event type.
-                    double dist;                    //! Distance to the event.
-                    size_t equip_index, tri_index;  //! Indices of hit equipment and triangle if hit at all.
-                    std::tie(event_type, dist, equip_index, tri_index) = determine_event(phot, cell, t_thread_index);
+        /**
+         *  Check whether a photon survives to make another loop.
+         *  Photons making too many loops are removed, and low weight photons are put through roulette.
+         *
+         *  @tparam FEATURES    Features present within the simulation.
+         *
+         *  @param  t_phot      Photon to check.
+         *  @param  t_loops     Number of loops made by the photon, incremented by this loop.
+         *  @param  t_rng       Random number stream of the photon.
+         *  @param  t_tally     Tally the photon is recorded within.
+         *
+         *  @return True if the photon survives.
+         */
+        template <unsigned int FEATURES>
+        bool Sim::check_photon(phys::Photon& t_phot, unsigned long int& t_loops, random::Generator& t_rng,
+                               Tally& t_tally) const
+        {
+            // Kill if photon is stuck.
+            if (++t_loops > m_loop_limit)
+            {
+                t_tally.error_loop += t_phot.get_weight();
 
-                    // Track properties.
-                    cell_energy += dist * phot.get_weight();
+                return (false);
+            }
 
-                    // Perform the event.
-                    switch (event_type)
+            // Roulette optimisation.
+            if constexpr ((FEATURES & HAS_ROULETTE) != 0)
+            {
+                if (t_phot.get_weight() <= m_roulette_weight)
+                {
+                    if (t_rng.gen_value() > (1.0 / m_roulette_chambers))
                     {
-                        // Scattering event.
-                        case event::SCATTER:
-                        {
-                            ++num_scat;
-
-                            // Move to the scattering point.
-                            phot.move(dist);
-
-                            // Scatter.
-                            phot.rotate(rng::henyey_greenstein(phot.get_anisotropy()),
-                                        m_uniform_dist(m_rng_engine[t_thread_index]) * 2.0 * M_PI);
-
-                            // Reduce weight by the albedo.
-                            phot.multiply_weight(phot.get_albedo());
-
-                            // Check that the photon still has statistical weight.
-                            if (phot.get_weight() <= 0.0)
-                            {
-                                goto kill_photon;
-                            }
-
-                            break;
-                        }
-
-                            // Cell boundary crossing.
-                        case event::CELL_CROSS:
-                        {
-                            // Increment cell-tracked properties.
-                            m_cell_mutex.lock();
-                            cell->add_energy(cell_energy);
-                            m_cell_mutex.unlock();
-                            cell_energy = 0.0;
-
-                            // Move just past the cell boundary point.
-                            phot.move(dist + SMOOTHING_LENGTH);
-
-                            // Check if photon has now exited the tree.
-                            if (!m_root->is_within(phot.get_pos()))
-                            {
-                                goto kill_photon;
-                            }
-
-                            // Get new cell pointer if still within the tree.
-                            cell = m_root->get_leaf(phot.get_pos());
-
-                            break;
-                        }
-
-                            // Entity collision.
-                        case event::ENTITY_HIT:
-                        {
-                            // Check for close-collision.
-                            if (dist < SMOOTHING_LENGTH)
-                            {
-                                m_counter_mutex.lock();
-                                m_error_prox += phot.get_weight();
-                                m_counter_mutex.unlock();
-
-                                goto kill_photon;
-                            }
-
-                            // Get the normal of the hit location.
-                            math::Vec<3> norm = m_entity[equip_index].get_mesh().get_tri(tri_index)
-                                                                     .get_norm(phot.get_pos() + (phot.get_dir() * dist));
-
-                            // If entity normal is facing away, multiply it by -1.
-                            if ((phot.get_dir() * norm) > 0.0)
-                            {
-                                norm *= -1.0;
-                            }
-                            assert(norm.is_normalised());
-
-                            // Determine the material indices.
-                            int  index_i, index_t;
-                            bool exiting      = phot.get_entity_index() == static_cast<int>(equip_index);
-                            if (exiting)    // Exiting the current entity.
-                            {
-                                index_i = static_cast<int>(equip_index);
-                                index_t = phot.get_prev_entity_index();
-                            }
-                            else            // Entering a new entity.
-                            {
-                                index_i = phot.get_entity_index();
-                                index_t = static_cast<int>(equip_index);
-                            }
-                            assert(index_i != index_t);
-
-                            // Get references to the materials.
-                            const phys::Material& mat_i = (index_i == -1) ? m_aether : m_entity[static_cast<size_t>(index_i)]
-                                .get_mat();
-                            const phys::Material& mat_t = (index_t == -1) ? m_aether : m_entity[static_cast<size_t>(index_t)]
-                                .get_mat();
-
-                            // Get refractive indices of the materials.
-                            const double n_i = mat_i.get_ref_index(phot.get_wavelength());
-                            const double n_t = mat_t.get_ref_index(phot.get_wavelength());
-
-                            // Calculate angle of incidence.
-                            const double a_i = std::acos(-phot.get_dir() * norm);
-                            assert((a_i >= 0.0) && (a_i < (M_PI / 2.0)));
-
-                            // Calculate reflectance probability.
-                            double reflectance;
-                            if (std::sin(a_i) >= (n_t / n_i))   // Total internal reflectance.
-                            {
-                                reflectance = 1.0;
-                            }
-                            else                                // Specular reflectance.
-                            {
-                                reflectance = optics::reflection_prob(a_i, n_i, n_t);
-                            }
-                            assert((reflectance >= 0.0) && (reflectance <= 1.0));
-
-                            if (m_uniform_dist(m_rng_engine[t_thread_index]) <= reflectance)   // Reflect.
-                            {
-                                // Move to just before the entity boundary.
-                                phot.move(dist - SMOOTHING_LENGTH);
-
-                                // Reflect the photon.
-                                phot.set_dir(optics::reflection_dir(phot.get_dir(), norm));
-                            }
-                            else                                // Refract.
-                            {
-                                // Move to just past the entity boundary.
-                                phot.move(dist + SMOOTHING_LENGTH);
-
-                                // Refract the photon.
-                                phot.set_dir(optics::refraction_dir(phot.get_dir(), norm, n_i / n_t));
-
-                                // Determine new optical properties.
-                                if (exiting)                    // Exiting material.
-                                {
-                                    phot.pop_entity_index();
-                                }
-                                else                            // Entering material.
-                                {
-                                    phot.push_entity_index(index_t);
-                                }
-                                phot.set_opt(index_t == -1 ? m_aether : m_entity[static_cast<size_t>(index_t)].get_mat());
-                            }
-
-                            break;
-                        }
-
-                            // Ccd detector hit.
-                        case event::CCD_HIT:
-                        {
-                            // Move to the hit location.
-                            phot.move(dist);
-
-                            // Get normal of the hit location.
-                            const math::Vec<3> norm = m_ccd[equip_index].get_mesh().get_tri(tri_index).get_norm(phot.get_pos());
-
-                            // Check if photon hits the front of the detector.
-                            if ((phot.get_dir() * norm) < 0.0)
-                            {
-                                m_ccd_mutex.lock();
-                                m_ccd[equip_index].add_hit(phot.get_pos(), phot.get_weight(), phot.get_wavelength());
-                                m_ccd_mutex.unlock();
-                            }
-
-                            // Kill the absorbed photon.
-                            goto kill_photon;
-                        }
-
-                            // Spectrometer detector hit.
-                        case event::SPECTROMETER_HIT:
-                        {
-                            // Move to the hit location.
-                            phot.move(dist);
-
-                            // Get normal of the hit location.
-                            const math::Vec<3> norm = m_spectrometer[equip_index].get_mesh().get_tri(tri_index)
-                                                                                 .get_norm(phot.get_pos());
-
-                            // Check if photon hits the front of the detector.
-                            if ((phot.get_dir() * norm) < 0.0)
-                            {
-                                m_spectrometer_mutex.lock();
-                                m_spectrometer[equip_index].add_hit(phot.get_wavelength(), phot.get_weight());
-                                m_spectrometer_mutex.unlock();
-                            }
-
-                            // Kill the absorbed photon.
-                            goto kill_photon;
-                        }
+                        return (false);
                     }
+
+                    t_phot.multiply_weight(m_roulette_chambers);
                 }
+            }
 
-                // Photon death label.
-                kill_photon:;
+            return (true);
+        }
 
-                // Add photon data to histograms.
-                m_hist_mutex.lock();
-                m_scatters.bin_value(num_scat, phot.get_weight());
-                m_exit_weight.bin_value(phot.get_weight());
-                m_hist_mutex.unlock();
+        /**
+         *  Move a photon to its scattering point and scatter it.
+         *
+         *  @param  t_phot  Photon to scatter.
+         *  @param  t_dist  Distance to the scattering point.
+         *  @param  t_rng   Random number stream of the photon.
+         *
+         *  @return True if the photon still has statistical weight.
+         */
+        bool Sim::scatter_photon(phys::Photon& t_phot, const double t_dist, random::Generator& t_rng) const
+        {
+            // Move to the scattering point.
+            t_phot.move(t_dist);
+
+            // Scatter.
+            t_phot.scatter(t_rng);
+
+            // Reduce weight by the albedo.
+            t_phot.multiply_weight(t_phot.get_albedo());
+
+            // Check that the photon still has statistical weight.
+            return (t_phot.get_weight() > 0.0);
+        }
+
+        /**
+         *  Move a photon across a cell wall into the neighbouring leaf cell.
+         *  The energy tracked within the cell being left is added to the thread's tally.
+         *
+         *  @param  t_phot          Photon crossing the wall.
+         *  @param  t_dist          Distance to the wall.
+         *  @param  t_face          Face of the cell being crossed.
+         *  @param  t_cell          Cell being left, which is updated to the cell being entered.
+         *  @param  t_cell_energy   Energy tracked within the cell being left, which is reset.
+         *  @param  t_tally         Tally the photon is recorded within.
+         *
+         *  @return True if the photon is still within the tree.
+         */
+        bool Sim::cross_cell(phys::Photon& t_phot, const double t_dist, const size_t t_face, tree::Cell*& t_cell,
+                             double& t_cell_energy, Tally& t_tally) const
+        {
+            // Increment cell-tracked properties.
+            t_tally.add_energy(t_cell->get_leaf_index(), t_cell_energy);
+            t_cell_energy = 0.0;
+
+            // Move just past the cell boundary point.
+            t_phot.move(t_dist + SMOOTHING_LENGTH);
+
+            // Step to the neighbouring cell across the crossed face.
+            t_cell = m_root->get_next_leaf(t_cell, t_face, t_phot.get_pos());
+
+            // Check if photon has now exited the tree.
+            return (t_cell != nullptr);
+        }
+
+        /**
+         *  Reflect or refract a photon at an entity boundary.
+         *
+         *  @param  t_phot          Photon hitting the entity.
+         *  @param  t_dist          Distance to the hit.
+         *  @param  t_entity_index  Index of the hit entity.
+         *  @param  t_tri_index     Index of the hit triangle within the entity mesh.
+         *  @param  t_rng           Random number stream of the photon.
+         *  @param  t_tally         Tally the photon is recorded within.
+         *
+         *  @return True if the photon was not too close to the boundary to be handled, and was not nested too deeply.
+         */
+        bool Sim::hit_entity(phys::Photon& t_phot, const double t_dist, const size_t t_entity_index,
+                             const size_t t_tri_index, random::Generator& t_rng, Tally& t_tally) const
+        {
+            // Check for close-collision.
+            if (t_dist < SMOOTHING_LENGTH)
+            {
+                t_tally.error_prox += t_phot.get_weight();
+
+                return (false);
+            }
+
+            // Get the normal of the hit location.
+            const geom::Triangle& tri  = m_entity[t_entity_index].get_mesh().get_tri(t_tri_index);
+            math::Vec<3>          norm = tri.get_norm(t_phot.get_pos() + (t_phot.get_dir() * t_dist));
+
+            // If entity normal is facing away, multiply it by -1.
+            if ((t_phot.get_dir() * norm) > 0.0)
+            {
+                norm *= -1.0;
+            }
+            assert(norm.is_normalised());
+
+            // Determine the material indices.
+            int  index_i, index_t;
+            bool exiting      = t_phot.get_entity_index() == static_cast<int>(t_entity_index);
+            if (exiting)    // Exiting the current entity.
+            {
+                index_i = static_cast<int>(t_entity_index);
+                index_t = t_phot.get_prev_entity_index();
+            }
+            else            // Entering a new entity.
+            {
+                index_i = t_phot.get_entity_index();
+                index_t = static_cast<int>(t_entity_index);
+            }
+            assert(index_i != index_t);
+
+            // Get references to the materials.
+            const phys::Material& mat_i = (index_i == -1) ? m_aether : m_entity[static_cast<size_t>(index_i)].get_mat();
+            const phys::Material& mat_t = (index_t == -1) ? m_aether : m_entity[static_cast<size_t>(index_t)].get_mat();
+
+            // Get refractive indices of the materials.
+            const double n_i = mat_i.get_ref_index(t_phot.get_wavelength());
+            const double n_t = mat_t.get_ref_index(t_phot.get_wavelength());
+
+            // Calculate angle of incidence.
+            const double a_i = std::acos(-t_phot.get_dir() * norm);
+            assert((a_i >= 0.0) && (a_i < (M_PI / 2.0)));
+
+            // Calculate reflectance probability.
+            double reflectance;
+            if (std::sin(a_i) >= (n_t / n_i))   // Total internal reflectance.
+            {
+                reflectance = 1.0;
+            }
+            else                                // Specular reflectance.
+            {
+                reflectance = optics::reflection_prob(a_i, n_i, n_t);
+            }
+            assert((reflectance >= 0.0) && (reflectance <= 1.0));
+
+            // Record which side of the triangle plane the photon arrives from.
+            const double in_side   = t_phot.get_dir() * tri.get_plane_norm();
+            const bool   reflected = t_rng.gen_value() <= reflectance;
+
+            if (reflected)                          // Reflect.
+            {
+                // Move to just before the entity boundary.
+                t_phot.move(t_dist - SMOOTHING_LENGTH);
+
+                // Reflect the photon.
+                t_phot.set_dir(optics::reflection_dir(t_phot.get_dir(), norm));
+            }
+            else                                    // Refract.
+            {
+                // Move to just past the entity boundary.
+                t_phot.move(t_dist + SMOOTHING_LENGTH);
+
+                // Refract the photon.
+                t_phot.set_dir(optics::refraction_dir(t_phot.get_dir(), norm, n_i / n_t));
+
+                // Determine new optical properties.
+                if (exiting)                        // Exiting material.
+                {
+                    t_phot.pop_entity_index();
+                }
+                else if (!t_phot.push_entity_index(index_t))    // Entering material, unless nested too deeply.
+                {
+                    t_tally.error_nest += t_phot.get_weight();
+
+                    return (false);
+                }
+                t_phot.set_opt(index_t == -1 ? m_aether : m_entity[static_cast<size_t>(index_t)].get_mat());
+            }
+
+            // The interpolated normal may turn the photon back through the flat triangle, which it would then hit again
+            // within the smoothing length and be lost, so mirror such directions back across the triangle plane.
+            const double out_side = t_phot.get_dir() * tri.get_plane_norm();
+            if (reflected ? ((in_side * out_side) > 0.0) : ((in_side * out_side) < 0.0))
+            {
+                t_phot.set_dir(math::normalise(t_phot.get_dir() - (tri.get_plane_norm() * (2.0 * out_side))));
+            }
+
+            return (true);
+        }
+
+        /**
+         *  Absorb a photon at a ccd, recording it if it hits the front of the detector.
+         *
+         *  @param  t_phot          Photon hitting the ccd.
+         *  @param  t_dist          Distance to the hit.
+         *  @param  t_ccd_index     Index of the hit ccd.
+         *  @param  t_tri_index     Index of the hit triangle within the ccd mesh.
+         *  @param  t_tally         Tally the photon is recorded within.
+         *
+         *  @return False, as the photon is always absorbed.
+         */
+        bool Sim::hit_ccd(phys::Photon& t_phot, const double t_dist, const size_t t_ccd_index, const size_t t_tri_index,
+                          const Tally& t_tally)
+        {
+            // Move to the hit location.
+            t_phot.move(t_dist);
+
+            // Get normal of the hit location.
+            const math::Vec<3> norm = m_ccd[t_ccd_index].get_mesh().get_tri(t_tri_index).get_norm(t_phot.get_pos());
+
+            // Check if photon hits the front of the detector.
+            if ((t_phot.get_dir() * norm) < 0.0)
+            {
+                m_ccd[t_ccd_index].add_hit(t_phot.get_pos(), t_phot.get_weight(), t_phot.get_wavelength(), t_tally.slot);
+            }
+
+            return (false);
+        }
+
+        /**
+         *  Absorb a photon at a spectrometer, recording it if it hits the front of the detector.
+         *
+         *  @param  t_phot                  Photon hitting the spectrometer.
+         *  @param  t_dist                  Distance to the hit.
+         *  @param  t_spectrometer_index    Index of the hit spectrometer.
+         *  @param  t_tri_index             Index of the hit triangle within the spectrometer mesh.
+         *  @param  t_tally                 Tally the photon is recorded within.
+         *
+         *  @return False, as the photon is always absorbed.
+         */
+        bool Sim::hit_spectrometer(phys::Photon& t_phot, const double t_dist, const size_t t_spectrometer_index,
+                                   const size_t t_tri_index, const Tally& t_tally)
+        {
+            // Move to the hit location.
+            t_phot.move(t_dist);
+
+            // Get normal of the hit location.
+            const math::Vec<3> norm = m_spectrometer[t_spectrometer_index].get_mesh().get_tri(t_tri_index)
+                                                                          .get_norm(t_phot.get_pos());
+
+            // Check if photon hits the front of the detector.
+            if ((t_phot.get_dir() * norm) < 0.0)
+            {
+                m_spectrometer[t_spectrometer_index].add_hit(t_phot.get_wavelength(), t_phot.get_weight(), t_tally.slot);
+            }
+
+            return (false);
+        }
+
+        /**
+         *  Record the data of a photon which has died.
+         *
+         *  @param  t_phot      Dead photon.
+         *  @param  t_num_scat  Number of times the photon scattered.
+         *  @param  t_tally     Tally the photon is recorded within.
+         */
+        void Sim::finish_photon(const phys::Photon& t_phot, const unsigned long int t_num_scat, Tally& t_tally)
+        {
+            // Add photon data to histograms.
+            t_tally.scatters.bin_value(t_num_scat, t_phot.get_weight());
+            t_tally.exit_weight.bin_value(t_phot.get_weight());
 
 #ifdef ENABLE_PHOTON_PATHS
-                // Add the photon path.
-                m_path_mutex.lock();
-                m_path.push_back(phot.get_path());
-                m_path_mutex.unlock();
+            // Add the photon path.
+            m_path_mutex.lock();
+            m_path.push_back(t_phot.get_path());
+            m_path_mutex.unlock();
 #endif
+        }
+
+        /**
+         *  Reduce the data tallied into the simulation data.
+         *  Every chunk has already been merged into the total, along with any data loaded from a checkpoint.
+         *  Must only be called once all threads running photons have finished.
+         */
+        void Sim::reduce_thread_data()
+        {
+            assert(m_done_chunk.empty());
+
+            // Free the per-thread run state.
+            m_worker.clear();
+            m_chunk_tally.clear();
+
+            // Add the error counters.
+            m_error_loop += m_total.error_loop;
+            m_error_prox += m_total.error_prox;
+            m_error_nest += m_total.error_nest;
+
+            // Add the histograms.
+            m_scatters += m_total.scatters;
+            m_exit_weight += m_total.exit_weight;
+
+            // Add the cell energy tallies to the tree.
+            m_root->add_energy(m_total.cell_energy);
+        }
+
+        /**
+         *  Find the first photon index, at or beyond a given index, which was not completed before resuming.
+         *
+         *  @param  t_phot_index    Photon index to begin searching from.
+         *
+         *  @return The index of the first photon still to be run.
+         */
+        unsigned long int Sim::next_pending(const unsigned long int t_phot_index) const
+        {
+            // Find the last completed range beginning at or before the photon index.
+            const auto range = std::upper_bound(m_resumed.begin(), m_resumed.end(), t_phot_index,
+                                                [](const unsigned long int t_index,
+                                                   const std::array<unsigned long int, 2>& t_range)
+                                                {
+                                                    return (t_index < t_range[0]);
+                                                });
+
+            // Skip to the end of the range if it holds the photon index.
+            if ((range != m_resumed.begin()) && (t_phot_index < (range - 1)->at(1)))
+            {
+                return ((range - 1)->at(1));
+            }
+
+            return (t_phot_index);
+        }
+
+        /**
+         *  Compact the data tallied from a finished chunk into a list of the entries given weight, and empty the tally
+         *  ready for the next chunk.
+         *  Only the leaf cells, pixels and bins given weight are visited, and no lock is held.
+         *
+         *  @param  t_tally Tally of the chunk.
+         *
+         *  @return The data tallied from the chunk.
+         */
+        Sim::Chunk Sim::take_chunk(Tally& t_tally)
+        {
+            // Create the return chunk, holding the error counters, histograms and photon ranges.
+            Chunk r_chunk(t_tally);
+            t_tally.error_loop = 0.0;
+            t_tally.error_prox = 0.0;
+            t_tally.error_nest = 0.0;
+            t_tally.scatters.clear();
+            t_tally.exit_weight.clear();
+            t_tally.phot_range.clear();
+
+            // Take the cell energy tallies.
+            r_chunk.cell_energy.reserve(t_tally.touched.size());
+            for (size_t i = 0; i < t_tally.touched.size(); ++i)
+            {
+                const size_t leaf_index = t_tally.touched[i];
+
+                r_chunk.cell_energy.emplace_back(leaf_index, t_tally.cell_energy[leaf_index]);
+                t_tally.cell_energy[leaf_index] = 0.0;
+            }
+            t_tally.touched.clear();
+
+            // Take the detector data.
+            r_chunk.ccd.reserve(m_ccd.size());
+            for (size_t i = 0; i < m_ccd.size(); ++i)
+            {
+                r_chunk.ccd.push_back(m_ccd[i].take_slot(t_tally.slot));
+            }
+            r_chunk.spectrometer.reserve(m_spectrometer.size());
+            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            {
+                r_chunk.spectrometer.push_back(m_spectrometer[i].take_slot(t_tally.slot));
+            }
+
+            return (r_chunk);
+        }
+
+        /**
+         *  Hand over a finished chunk, merging every finished chunk which follows on from those already merged into the
+         *  total.
+         *  Chunks are always merged in order, so the sums formed do not depend upon the order the chunks finished in.
+         *  Finished chunks hold only the entries given weight, so any number may wait for an earlier chunk, and the
+         *  thread never waits for anything beyond the lock.
+         *
+         *  @param  t_first_phot    Index of the first photon of the chunk.
+         *  @param  t_chunk         Data tallied from the chunk.
+         */
+        void Sim::merge_chunk(const unsigned long int t_first_phot, Chunk&& t_chunk)
+        {
+            std::lock_guard<std::mutex> lock(m_tally_mutex);
+            m_done_chunk.emplace(t_first_phot, std::move(t_chunk));
+
+            for (auto chunk = m_done_chunk.begin(); (chunk != m_done_chunk.end()) && (chunk->first == m_next_merge);
+                 chunk = m_done_chunk.erase(chunk))
+            {
+                retire_chunk(chunk->second);
+                m_next_merge += m_chunk_size;
             }
         }
 
         /**
          *  Determine the next event a photon will undergo.
+         *  Surface queries are skipped entirely when the simulation contains no surfaces.
+         *
+         *  @tparam FEATURES    Features present within the simulation.
          *
          *  @param  t_phot          Photon whose event will be determined.
          *  @param  t_cell          Cell the photon is currently within.
-         *  @param  t_thread_index  Index of the thread running this batch of photons.
+         *  @param  t_rng           Random number stream of the photon.
          *
          *  @post   Return distance must be positive.
-         *  @post   Equipment index must not be a NaN if not a scattering or cell crossing event.
+         *  @post   Equipment index must not be a NaN if not a scattering event, and holds the face crossed for a cell crossing.
          *  @post   Equipment triangle index must not be a NaN if not a scattering or cell crossing event.
          *
          *  @return A tuple containing, the type of event, distance to event, indices of equipment and triangle involved.
          */
+        template <unsigned int FEATURES>
         std::tuple<Sim::event, double, size_t, size_t> Sim::determine_event(const phys::Photon& t_phot,
                                                                             const tree::Cell* t_cell,
-                                                                            const size_t t_thread_index)
+                                                                            random::Generator& t_rng) const
         {
             // Determine scatter distance.
-            const double scat_dist = -std::log(m_uniform_dist(m_rng_engine[t_thread_index]) / t_phot.get_interaction());
+            const double scat_dist = -std::log(t_rng.gen_value()) / t_phot.get_interaction();
             assert(scat_dist > 0.0);
 
             // Determine the cell distance.
-            const double cell_dist = t_cell->get_dist_to_wall(t_phot.get_pos(), t_phot.get_dir());
+            double cell_dist;
+            size_t cell_face;
+            std::tie(cell_dist, cell_face) = t_cell->get_dist_to_wall(t_phot.get_pos(), t_phot.get_dir());
 //            assert(cell_dist > SMOOTHING_LENGTH);
 
-            // Check for entity collision.
-            bool   entity_hit;
-            double entity_dist;
-            size_t entity_index, entity_tri_index;
-            std::tie(entity_hit, entity_dist, entity_index, entity_tri_index) = t_cell
-                ->entity_dist(t_phot.get_pos(), t_phot.get_dir());
-
-            // Check for ccd collision.
-            bool   ccd_hit;
-            double ccd_dist;
-            size_t ccd_index, ccd_tri_index;
-            std::tie(ccd_hit, ccd_dist, ccd_index, ccd_tri_index) = t_cell->ccd_dist(t_phot.get_pos(), t_phot.get_dir());
-
-            // Check for spectrometer collision.
-            bool   spectrometer_hit;
-            double spectrometer_dist;
-            size_t spectrometer_index, spectrometer_tri_index;
-            std::tie(spectrometer_hit, spectrometer_dist, spectrometer_index, spectrometer_tri_index) = t_cell
-                ->spectrometer_dist(t_phot.get_pos(), t_phot.get_dir());
-
-            // Determine which distance is shortest.
-            std::array<double, 5> dist({{scat_dist, cell_dist, entity_dist, ccd_dist, spectrometer_dist}});
-            switch (std::distance(std::begin(dist), std::min_element(std::begin(dist), std::end(dist))))
-            {
-                case 0:
-                    assert(scat_dist > 0.0);
+            // Check for a surface collision before the photon scatters or leaves the cell.
+            tree::Cell::Hit hit{tree::Cell::surface::NONE, 0, 0, std::min(scat_dist, cell_dist)};
+            if constexpr ((FEATURES & (HAS_ENTITIES | HAS_CCDS | HAS_SPECTROMETERS)) != 0)
+            {
+                hit = t_cell->surface_dist(t_phot.get_pos(), t_phot.get_dir(), std::min(scat_dist, cell_dist));
+            }
+
+            // If no surface is hit, determine which distance is shortest, preferring scattering to cell crossing.
+            if (hit.kind == tree::Cell::surface::NONE)
+            {
+                if (scat_dist <= cell_dist)
+                {
                     return (std::tuple<event, double, size_t, size_t>(event::SCATTER, scat_dist,
                                                                       std::numeric_limits<size_t>::signaling_NaN(),
                                                                       std::numeric_limits<size_t>::signaling_NaN()));
-                case 1:
-                    assert(cell_dist > 0.0);
-                    return (std::tuple<event, double, size_t, size_t>(event::CELL_CROSS, cell_dist,
-                                                                      std::numeric_limits<size_t>::signaling_NaN(),
-                                                                      std::numeric_limits<size_t>::signaling_NaN()));
-                case 2:
-                    assert(entity_dist > 0.0);
-                    assert(!std::isnan(entity_index));
-                    assert(!std::isnan(entity_tri_index));
-                    return (std::tuple<event, double, size_t, size_t>(event::ENTITY_HIT, entity_dist, entity_index,
-                                                                      entity_tri_index));
-                case 3:
-                    assert(ccd_dist > 0.0);
-                    assert(!std::isnan(ccd_index));
-                    assert(!std::isnan(ccd_tri_index));
-                    return (std::tuple<event, double, size_t, size_t>(event::CCD_HIT, ccd_dist, ccd_index, ccd_tri_index));
-                case 4:
-                    assert(spectrometer_dist > 0.0);
-                    assert(!std::isnan(spectrometer_index));
-                    assert(!std::isnan(spectrometer_tri_index));
-                    return (std::tuple<event, double, size_t, size_t>(event::SPECTROMETER_HIT, spectrometer_dist,
-                                                                      spectrometer_index, spectrometer_tri_index));
-                default: ERROR("Unable to simulate photon.", "Code should be unreachable.");
+                }
+
+                assert(cell_dist > 0.0);
+                return (std::tuple<event, double, size_t, size_t>(event::CELL_CROSS, cell_dist, cell_face,
+                                                                  std::numeric_limits<size_t>::signaling_NaN()));
             }
+
+            assert(hit.dist > 0.0);
+            switch (hit.kind)
+            {
+                case tree::Cell::surface::ENTITY:
+                    if constexpr ((FEATURES & HAS_ENTITIES) != 0)
+                    {
+                        return (std::tuple<event, double, size_t, size_t>(event::ENTITY_HIT, hit.dist, hit.owner,
+                                                                          hit.tri));
+                    }
+                    break;
+                case tree::Cell::surface::CCD:
+                    if constexpr ((FEATURES & HAS_CCDS) != 0)
+                    {
+                        return (std::tuple<event, double, size_t, size_t>(event::CCD_HIT, hit.dist, hit.owner, hit.tri));
+                    }
+                    break;
+                case tree::Cell::surface::SPECTROMETER:
+                    if constexpr ((FEATURES & HAS_SPECTROMETERS) != 0)
+                    {
+                        return (std::tuple<event, double, size_t, size_t>(event::SPECTROMETER_HIT, hit.dist, hit.owner,
+                                                                          hit.tri));
+                    }
+                    break;
+                default: break;
+            }
+
+            ERROR("Unable to simulate photon.", "Code should be unreachable.");
         }
 
         /**
@@ -1029,13 +1758,19 @@ namespace arc
             }
             last_update                   = cur_time;
 
-            // Log the progress of all loops.
+            // Log the total progress, followed by the number of photons completed by each thread.
             std::stringstream progress;
-            static const auto print_width = static_cast<int>(term::TEXT_WIDTH / m_thread_progress.size());
-            assert(print_width > 2);
-            for (size_t i = 0; i < m_thread_progress.size(); ++i)
+            unsigned long int total       = m_resumed_phot;
+            for (size_t       i           = 0; i < m_worker.size(); ++i)
+            {
+                total += m_worker[i]->progress;
+            }
+            progress << std::setw(6) << ((100.0 * total) / (m_last_phot - m_first_phot)) << "% :";
+            static const auto print_width = static_cast<int>((term::TEXT_WIDTH - 9) / m_worker.size());
+            assert(print_width > 1);
+            for (size_t i = 0; i < m_worker.size(); ++i)
             {
-                progress << std::setw(print_width - 2) << m_thread_progress[i] << "% ";
+                progress << std::setw(print_width) << m_worker[i]->progress;
             }
 
             // Print the progress string.
@@ -15,9 +15,13 @@
 
 //  == INCLUDES ==
 //  -- System --
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <mutex>
-#include <random>
 #include <thread>
+#include <utility>
 
 //  -- Classes --
 #include "cls/data/json.hpp"
@@ -25,7 +29,9 @@
 #include "cls/detector/spectrometer.hpp"
 #include "cls/equip/entity.hpp"
 #include "cls/equip/light.hpp"
+#include "cls/random/generator.hpp"
 #include "cls/tree/cell.hpp"
+#include "cls/tree/layout.hpp"
 
 
 
@@ -41,6 +47,18 @@ namespace arc
         //  -- Numerical Simulation --
         constexpr const double SMOOTHING_LENGTH = 1E-12; //! Smoothing length applied to stop photons getting stuck.
 
+        //  -- Threads --
+        constexpr const size_t CACHE_LINE_SIZE = 64;    //! Size of a cache line in bytes.
+
+        //  -- Histograms --
+        constexpr const size_t PHOT_HIST_BINS       = 100;      //! Number of bins of the photon histograms.
+        constexpr const double SCATTER_HIST_MAX     = 100.0;    //! Initial maximum bound of the scatter histogram.
+        constexpr const double EXIT_WEIGHT_HIST_MAX = 1.0;      //! Initial maximum bound of the exit weight histogram.
+
+        //  -- Tallies --
+        constexpr const unsigned long int TALLY_MAGIC       = 0x41524354544C4C59;  //! Identifier beginning each tally file.
+        constexpr const unsigned long int TALLY_VERSION     = 3;                   //! Version of the tally file layout.
+
 
 
         //  == CLASS ==
@@ -62,14 +80,138 @@ namespace arc
                 SPECTROMETER_HIT    //! Spectrometer triangle hit.
             };
 
+            /**
+             *  Bit flags of the scene features which the transport kernels are specialised on.
+             *  Photon path recording is already a compile-time option, so is not included.
+             */
+            enum feature : unsigned int
+            {
+                HAS_ENTITIES      = 1u << 0u,   //! Scene contains entities.
+                HAS_CCDS          = 1u << 1u,   //! Scene contains ccds.
+                HAS_SPECTROMETERS = 1u << 2u,   //! Scene contains spectrometers.
+                HAS_ROULETTE      = 1u << 3u,   //! Roulette can remove low weight photons.
+                NUM_FEATURE_SETS  = 1u << 4u    //! Number of distinct combinations of features.
+            };
+
+
+            //  == TYPES ==
+            //  -- Kernels --
+            using kernel = void (Sim::*)(size_t);   //! Transport loop specialised on a set of features.
+
+
+            //  == STRUCTURES ==
+            //  -- Tallies --
+          public:
+            /**
+             *  Data tallied from a set of photons, along with the ranges of photon indices it was tallied from.
+             *  Ranges of photon indices are half-open, and are recorded as photons are emitted.
+             *  The leaf cells given energy are listed, so a tally of a few photons may be merged without visiting every
+             *  leaf of the tree.
+             */
+            struct Tally
+            {
+                double                                        error_loop = 0.0; //! Weight removed due to running beyond the loop limit.
+                double                                        error_prox = 0.0; //! Weight removed due to proximity errors.
+                double                                        error_nest = 0.0; //! Weight removed due to exceeding the nesting depth.
+                data::Histogram                               scatters;         //! Histogram of photon total scatterings.
+                data::Histogram                               exit_weight;      //! Histogram of photon exit weights.
+                std::vector<double>                           cell_energy;      //! Energy tallied by leaf cell index.
+                std::vector<size_t>                           touched;          //! Leaf cell indices given energy.
+                std::vector<std::array<unsigned long int, 2>> phot_range;       //! Ranges of photon indices tallied.
+                const size_t                                  slot;             //! Detector slot hits are recorded within.
+
+                Tally(const data::Histogram& t_scatters, const data::Histogram& t_exit_weight, size_t t_num_leaves,
+                      size_t t_slot = 0) :
+                    scatters(t_scatters),
+                    exit_weight(t_exit_weight),
+                    cell_energy(t_num_leaves, 0.0),
+                    slot(t_slot)
+                {
+                }
+
+                bool add_ranges(const std::vector<std::array<unsigned long int, 2>>& t_range);
+                unsigned long int get_num_phot() const;
+
+                void add_energy(const size_t t_leaf_index, const double t_energy)
+                {
+                    if (cell_energy[t_leaf_index] == 0.0)
+                    {
+                        touched.push_back(t_leaf_index);
+                    }
+                    cell_energy[t_leaf_index] += t_energy;
+                }
+
+                void add_phot(const unsigned long int t_phot_index)
+                {
+                    if (!phot_range.empty() && (phot_range.back()[1] == t_phot_index))
+                    {
+                        ++phot_range.back()[1];
+                    }
+                    else
+                    {
+                        phot_range.push_back({{t_phot_index, t_phot_index + 1}});
+                    }
+                }
+            };
+
+          private:
+            /**
+             *  Data tallied from a finished chunk of photons, holding only the entries which were given weight.
+             *  Chunks are compacted from the tally of the thread which ran them, so any number may wait to be merged in
+             *  order without each holding every leaf cell and detector pixel.
+             */
+            struct Chunk
+            {
+                double                                        error_loop;       //! Weight removed due to running beyond the loop limit.
+                double                                        error_prox;       //! Weight removed due to proximity errors.
+                double                                        error_nest;       //! Weight removed due to exceeding the nesting depth.
+                data::Histogram                               scatters;         //! Histogram of photon total scatterings.
+                data::Histogram                               exit_weight;      //! Histogram of photon exit weights.
+                std::vector<std::pair<size_t, double>>        cell_energy;      //! Leaf cell indices and the energy tallied.
+                std::vector<detector::Ccd::pixels>            ccd;              //! Pixels given weight on each ccd.
+                std::vector<detector::Spectrometer::bins>     spectrometer;     //! Bins given weight on each spectrometer.
+                std::vector<std::array<unsigned long int, 2>> phot_range;       //! Ranges of photon indices tallied.
+
+                explicit Chunk(const Tally& t_tally) :
+                    error_loop(t_tally.error_loop),
+                    error_prox(t_tally.error_prox),
+                    error_nest(t_tally.error_nest),
+                    scatters(t_tally.scatters),
+                    exit_weight(t_tally.exit_weight),
+                    phot_range(t_tally.phot_range)
+                {
+                }
+            };
+
+            //  -- Workers --
+          private:
+            /**
+             *  Mutable run state owned by a single simulation thread.
+             *  Workers are aligned to, and padded out to, whole cache lines so no two threads ever write to the same line.
+             */
+            struct alignas(CACHE_LINE_SIZE) Worker
+            {
+                std::atomic<unsigned long int> progress{0}; //! Number of photons completed.
+            };
+
 
             //  == FIELDS ==
           private:
+            //  -- Run --
+            const unsigned long int m_num_phot;     //! Total number of photons to run.
+            const unsigned long int m_chunk_size;   //! Number of consecutive photons handed to a thread at a time.
+            const unsigned int      m_max_threads;  //! Number of threads to build and rasterise the tree with.
+            unsigned long int       m_first_phot;   //! Index of the first photon of this run's shard.
+            unsigned long int       m_last_phot;    //! Index one beyond the last photon of this run's shard.
+
             //  -- Optimisations --
             const unsigned long int m_loop_limit;           //! Maximum number of loops a photon may make.
             const double            m_roulette_weight;      //! Roulette threshold.
             const double            m_roulette_chambers;    //! Number of roulette chambers.
 
+            //  -- Loading --
+            const bool m_mesh_cache;    //! If true, read and write transformed meshes through binary cache files.
+
             //  -- Equipment --
             const phys::Material                m_aether;       //! Aether material.
             const std::vector<equip::Entity>    m_entity;       //! Vector of entity objects.
@@ -78,10 +220,16 @@ namespace arc
             std::vector<detector::Spectrometer> m_spectrometer; //! Vector of spectrometer objects.
 
             //  -- Tools --
-            const random::Index m_light_select; //! Light selector.
+            const random::Index           m_light_select;   //! Light selector.
+            const random::Generator::base m_seed;           //! Seed of the random number stream of every photon.
+
+            //  -- Kernels --
+            const unsigned int m_features;  //! Features present within the simulation.
+            const kernel       m_kernel;    //! Transport loop specialised on the features present.
 
             //  -- Tree --
             std::unique_ptr<tree::Cell> m_root;         //! Simulation cell tree.
+            const tree::Layout          m_layout;       //! Layout of the leaf cells of the tree.
             data::Histogram             m_scatters;     //! Histogram of photon total scatterings.
             data::Histogram             m_exit_weight;  //! Histogram of photon total scatterings.
 
@@ -94,19 +242,32 @@ namespace arc
             //  -- Counters --
             double m_error_loop = 0.0;  //! Total weight of photons removed from sim due to running beyond max loop limit.
             double m_error_prox = 0.0;  //! Total weight of photons removed from sim due to proximity errors.
+            double m_error_nest = 0.0;  //! Total weight of photons removed from sim due to exceeding the nesting depth.
 
             //  -- Threads --
-            std::mutex          m_ccd_mutex;            //! Protects the ccd objects data.
-            std::mutex          m_spectrometer_mutex;   //! Protects the spectrometer objects data.
-            std::mutex          m_cell_mutex;           //! Protects the cell data.
-            std::mutex          m_counter_mutex;        //! Protects the error counters.
-            std::mutex          m_hist_mutex;           //! Protects the data histograms.
-            std::vector<double> m_thread_progress;      //! Current progress of each thread.
-            const double        m_log_update_period;    //! Period with which to update a progress print.
-
-            //  -- Random Number Generation --
-            std::vector<std::mt19937>              m_rng_engine;    //! Random number generator engine.
-            std::uniform_real_distribution<double> m_uniform_dist;  //! Distribution to draw random numbers from.
+            std::atomic<unsigned long int>       m_next_phot{0};         //! Index of the next photon to hand out.
+            std::vector<std::unique_ptr<Worker>> m_worker;              //! Run state of each thread.
+            const double                         m_log_update_period;   //! Period between progress prints.
+
+            //  -- Chunk Tallies --
+            std::vector<std::unique_ptr<Tally>> m_chunk_tally;      //! Tally of the chunk each thread is running.
+            std::map<unsigned long int, Chunk>  m_done_chunk;       //! Finished chunks waiting to merge, by first photon index.
+            unsigned long int                   m_next_merge = 0;   //! First photon index of the next chunk to merge.
+            std::mutex                          m_tally_mutex;      //! Protects the finished chunks and the total.
+
+            //  -- Output --
+            const data::Image::format     m_image_format;   //! Format to save ccd images and tree slices as.
+            const data::Histogram::format m_hist_format;    //! Format to save histograms and spectrometer data as.
+            const bool                    m_save_volume;    //! If true, also save the tree data cube as a binary volume.
+
+            //  -- Checkpoints --
+            const double                                  m_checkpoint_period;      //! Period between checkpoints.
+            Tally                                         m_total;                  //! Data merged from chunks, in order.
+            std::vector<std::array<unsigned long int, 2>> m_resumed;                //! Photon ranges completed before resuming.
+            unsigned long int                             m_resumed_phot    = 0;    //! Number of photons completed before resuming.
+            bool                                          m_checkpoint_stop = false; //! True once checkpointing should stop.
+            std::mutex                                    m_checkpoint_mutex;       //! Protects the checkpoint stop flag.
+            std::condition_variable                       m_checkpoint_cv;          //! Wakes the checkpointing thread to stop.
 
 
             //  == INSTANTIATION ==
@@ -122,7 +283,11 @@ namespace arc
             std::vector<equip::Light> init_light(const data::Json& t_json) const;
             std::vector<detector::Ccd> init_ccd(const data::Json& t_json) const;
             std::vector<detector::Spectrometer> init_spectrometer(const data::Json& t_json) const;
+            std::unique_ptr<tree::Cell> init_root(const data::Json& t_json) const;
             random::Index init_light_select() const;
+            unsigned int init_features() const;
+            template <unsigned int FEATURES = 0>
+            kernel init_kernel() const;
 
 
             //  == METHODS ==
@@ -130,31 +295,81 @@ namespace arc
             //  -- Getters --
             const data::Histogram& get_scatter_hist() const { return (m_scatters); }
             const data::Histogram& get_exit_weight_hist() const { return (m_exit_weight); }
+            unsigned long int get_num_phot() const { return (m_num_phot); }
+            unsigned long int get_first_phot() const { return (m_first_phot); }
+            unsigned long int get_last_phot() const { return (m_last_phot); }
+            unsigned long int get_num_resumed_phot() const { return (m_resumed_phot); }
+            unsigned long int get_num_tallied_phot() const { return (m_total.get_num_phot()); }
+            double get_checkpoint_period() const { return (m_checkpoint_period); }
+            random::Generator::base get_seed() const { return (m_seed); }
+            unsigned int get_max_threads() const { return (m_max_threads); }
+            const tree::Layout& get_layout() const { return (m_layout); }
+            const Tally& get_total() const { return (m_total); }
+            const std::vector<detector::Ccd>& get_ccd() const { return (m_ccd); }
+            const std::vector<detector::Spectrometer>& get_spectrometer() const { return (m_spectrometer); }
+            data::Image::format get_image_format() const { return (m_image_format); }
+            data::Histogram::format get_hist_format() const { return (m_hist_format); }
+            bool get_save_volume() const { return (m_save_volume); }
             void get_error_report() const;
 
             //  -- Setters --
             void set_num_threads(unsigned int t_num_threads);
+            void set_shard(unsigned long int t_shard_index, unsigned long int t_num_shards);
 
             //  -- Saving --
-            void save_tree_images(const std::string& t_output_dir, size_t t_level) const;
-            void save_ccd_images(const std::string& t_output_dir) const;
-            void save_spectrometer_data(const std::string& t_output_dir) const;
-            void save_histogram_data(const std::string& t_output_dir) const;
+            void save_data(const std::string& t_output_dir, size_t t_image_res) const;
+
+            //  -- Tallies --
+            void merge_tallies(const std::string& t_path);
+            bool save_tallies(const std::string& t_path) const;
 
             //  -- Rendering --
             void render() const;
 
+            //  -- Checkpointing --
+            void load_checkpoint(const std::string& t_path);
+            void run_checkpoints(const std::string& t_path);
+            void stop_checkpoints();
+
             //  -- Simulation --
-            void run_photons(unsigned long int t_num_phot, size_t t_thread_index);
+            void run_photons(size_t t_thread_index);
+            void reduce_thread_data();
 
           private:
-            //  -- Saving --
-            void save_slices(const std::string& t_output_dir, size_t t_dimension,
-                             const std::vector<std::vector<std::vector<double>>>& t_data) const;
+            //  -- Checkpointing --
+            void checkpoint(const std::string& t_path);
+            bool write_tallies(const std::string& t_path, const Tally& t_total, const std::vector<data::Image>& t_ccd_image,
+                               const std::vector<data::Histogram>& t_spectrometer_data) const;
+            void retire_chunk(const Chunk& t_chunk);
 
             //  -- Simulation --
+            template <unsigned int FEATURES>
+            void run_kernel(size_t t_thread_index);
+            template <unsigned int FEATURES>
+            void run_photon(unsigned long int t_phot_index, Tally& t_tally);
+            template <unsigned int FEATURES>
+            bool run_event(event t_event, phys::Photon& t_phot, double t_dist, size_t t_equip_index, size_t t_tri_index,
+                           tree::Cell*& t_cell, double& t_cell_energy, unsigned long int& t_num_scat,
+                           random::Generator& t_rng, Tally& t_tally);
+            template <unsigned int FEATURES>
+            bool check_photon(phys::Photon& t_phot, unsigned long int& t_loops, random::Generator& t_rng,
+                              Tally& t_tally) const;
+            template <unsigned int FEATURES>
             std::tuple<event, double, size_t, size_t> determine_event(const phys::Photon& t_phot, const tree::Cell* t_cell,
-                                                                      size_t t_thread_index);
+                                                                      random::Generator& t_rng) const;
+            bool scatter_photon(phys::Photon& t_phot, double t_dist, random::Generator& t_rng) const;
+            bool cross_cell(phys::Photon& t_phot, double t_dist, size_t t_face, tree::Cell*& t_cell, double& t_cell_energy,
+                            Tally& t_tally) const;
+            bool hit_entity(phys::Photon& t_phot, double t_dist, size_t t_entity_index, size_t t_tri_index,
+                            random::Generator& t_rng, Tally& t_tally) const;
+            bool hit_ccd(phys::Photon& t_phot, double t_dist, size_t t_ccd_index, size_t t_tri_index,
+                         const Tally& t_tally);
+            bool hit_spectrometer(phys::Photon& t_phot, double t_dist, size_t t_spectrometer_index, size_t t_tri_index,
+                                  const Tally& t_tally);
+            void finish_photon(const phys::Photon& t_phot, unsigned long int t_num_scat, Tally& t_tally);
+            unsigned long int next_pending(unsigned long int t_phot_index) const;
+            Chunk take_chunk(Tally& t_tally);
+            void merge_chunk(unsigned long int t_first_phot, Chunk&& t_chunk);
             void log_progress() const;
         };
 
@@ -0,0 +1,475 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/setup/tallies.hpp"
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+//  -- General --
+#include "gen/enum.hpp"
+#include "gen/log.hpp"
+
+//  -- Utility --
+#include "utl/file.hpp"
+#include "utl/stream.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace setup
+    {
+
+
+
+        //  == INSTANTIATION ==
+        //  -- Constructors --
+        /**
+         *  Initialise an empty set of tallies from the json setup file of the simulation which wrote the tally files.
+         *  The simulation must have set a seed, so every file drew from the same photon streams.
+         *
+         *  @param  t_param Json setup file.
+         */
+        Tallies::Tallies(const data::Json& t_param) :
+            m_num_phot(t_param["simulation"].parse_child<unsigned long int>("num_phot")),
+            m_seed(t_param["system"].parse_child<random::Generator::base>("seed")),
+            m_max_threads(std::max(1u, std::min(std::thread::hardware_concurrency(),
+                                                t_param["system"].parse_child<unsigned int>("max_threads", 1)))),
+            m_total(data::Histogram(0.0, SCATTER_HIST_MAX, PHOT_HIST_BINS, true),
+                    data::Histogram(0.0, EXIT_WEIGHT_HIST_MAX, PHOT_HIST_BINS, true), 0),
+            m_image_format(data::Image::get_format(t_param["system"].parse_child<std::string>("image_format", "ppm_ascii"))),
+            m_hist_format(data::Histogram::get_format(t_param["system"].parse_child<std::string>("hist_format", "text"))),
+            m_save_volume(t_param["tree"].parse_child<bool>("save_volume", false))
+        {
+        }
+
+        /**
+         *  Initialise a set of tallies holding the data merged from the chunks of a simulation, so the simulation's data
+         *  may be saved exactly as merged tally files are saved.
+         *
+         *  @param  t_sim   Simulation to take the data of.
+         */
+        Tallies::Tallies(const Sim& t_sim) :
+            m_num_phot(t_sim.get_num_phot()),
+            m_seed(t_sim.get_seed()),
+            m_max_threads(t_sim.get_max_threads()),
+            m_layout(t_sim.get_layout()),
+            m_total(t_sim.get_total()),
+            m_image_format(t_sim.get_image_format()),
+            m_hist_format(t_sim.get_hist_format()),
+            m_save_volume(t_sim.get_save_volume())
+        {
+            // Take the detector data.
+            for (size_t i = 0; i < t_sim.get_ccd().size(); ++i)
+            {
+                m_ccd_name.push_back(t_sim.get_ccd()[i].get_name());
+                m_ccd_image.push_back(t_sim.get_ccd()[i].get_image());
+            }
+            for (size_t i = 0; i < t_sim.get_spectrometer().size(); ++i)
+            {
+                m_spectrometer_name.push_back(t_sim.get_spectrometer()[i].get_name());
+                m_spectrometer_data.push_back(t_sim.get_spectrometer()[i].get_data());
+            }
+        }
+
+
+
+        //  == METHODS ==
+        //  -- Getters --
+        /**
+         *  Report the photon weight lost to errors within the files merged.
+         */
+        void Tallies::get_error_report() const
+        {
+            // Calculate total error.
+            const double total_error = m_total.error_loop + m_total.error_prox + m_total.error_nest;
+
+            if (total_error > 0.0)
+            {
+                WARN("Photon weight was lost.", "Total weight lost to proximity errors : " << m_total.error_prox);
+                WARN("Photon weight was lost.", "Total weight lost to exceeding set loop limit : " << m_total.error_loop);
+                WARN("Photon weight was lost.", "Total weight lost to exceeding nesting depth : " << m_total.error_nest);
+            }
+            else
+            {
+                LOG("No errors occured during the photon loop.");
+            }
+        }
+
+
+        //  -- Merging --
+        /**
+         *  Add the data tallied within a tally file, written by setup::Sim::save_tallies, to the totals.
+         *  Files are read a section at a time and added straight into the totals, so any number of files may be merged
+         *  in turn.
+         *  The first file merged sets the tree layout and detectors, which every later file must match.
+         *
+         *  @param  t_path  Path to the tally file.
+         */
+        void Tallies::merge(const std::string& t_path)
+        {
+            // Open the file.
+            std::ifstream file(t_path, std::ios::binary);
+            if (!file)
+            {
+                ERROR("Unable to read tally file.", "Unable to open file: '" << t_path << "'.");
+            }
+
+            // Check the header.
+            unsigned long int magic   = 0;
+            unsigned long int version = 0;
+            utl::read_binary(file, magic);
+            utl::read_binary(file, version);
+            if (!file || (magic != TALLY_MAGIC) || (version != TALLY_VERSION))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is not a tally file of this version.");
+            }
+
+            // Check the file was written by the simulation.
+            random::Generator::base seed = 0;
+            utl::read_binary(file, seed);
+            if (seed != m_seed)
+            {
+                ERROR("Unable to read tally file.",
+                      "File seed: '" << seed << "', does not match the simulation seed: '" << m_seed << "'.");
+            }
+            read_layout(file, t_path);
+            read_detectors(file, t_path);
+
+            // Read the error counters.
+            double error_loop = 0.0;
+            double error_prox = 0.0;
+            double error_nest = 0.0;
+            utl::read_binary(file, error_loop);
+            utl::read_binary(file, error_prox);
+            utl::read_binary(file, error_nest);
+            m_total.error_loop += error_loop;
+            m_total.error_prox += error_prox;
+            m_total.error_nest += error_nest;
+
+            // Read the histograms.
+            data::Histogram scatters(0.0, SCATTER_HIST_MAX, PHOT_HIST_BINS, true);
+            data::Histogram exit_weight(0.0, EXIT_WEIGHT_HIST_MAX, PHOT_HIST_BINS, true);
+            scatters.read_binary(file);
+            exit_weight.read_binary(file);
+            m_total.scatters += scatters;
+            m_total.exit_weight += exit_weight;
+
+            // Read the cell energy tallies.
+            std::vector<double> cell_energy;
+            utl::read_binary(file, cell_energy);
+            if (!file || (cell_energy.size() != m_total.cell_energy.size()))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+            }
+            for (size_t i = 0; i < cell_energy.size(); ++i)
+            {
+                m_total.cell_energy[i] += cell_energy[i];
+            }
+
+            // Read the ranges of photons tallied.
+            std::vector<std::array<unsigned long int, 2>> phot_range;
+            utl::read_binary(file, phot_range);
+            for (size_t i = 0; i < phot_range.size(); ++i)
+            {
+                if ((phot_range[i][0] >= phot_range[i][1]) || (phot_range[i][1] > m_num_phot))
+                {
+                    ERROR("Unable to read tally file.",
+                          "File: '" << t_path << "' holds photons beyond the number of photons to run: '" << m_num_phot
+                                    << "'.");
+                }
+            }
+            if (!m_total.add_ranges(phot_range))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' holds photons which have already been tallied.");
+            }
+
+            // Read the detector data.
+            for (size_t i = 0; i < m_ccd_image.size(); ++i)
+            {
+                data::Image image(m_ccd_image[i].get_width(), m_ccd_image[i].get_height());
+                image.read_binary(file);
+
+                m_ccd_image[i] += image;
+            }
+            for (size_t i = 0; i < m_spectrometer_data.size(); ++i)
+            {
+                data::Histogram hist(m_spectrometer_data[i].get_min_bound(), m_spectrometer_data[i].get_max_bound(),
+                                     m_spectrometer_data[i].get_num_bin());
+                hist.read_binary(file);
+
+                m_spectrometer_data[i] += hist;
+            }
+            if (!file)
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+            }
+
+            ++m_num_files;
+        }
+
+        /**
+         *  Read the layout of the leaf cells from a tally file.
+         *  The layout of the first file merged is kept, and the layout of every later file is checked against it.
+         *
+         *  @param  t_stream    Stream of the tally file.
+         *  @param  t_path      Path to the tally file.
+         */
+        void Tallies::read_layout(std::istream& t_stream, const std::string& t_path)
+        {
+            tree::Layout layout;
+            layout.read_binary(t_stream);
+
+            if (m_num_files == 0)
+            {
+                m_layout = layout;
+                m_total.cell_energy.assign(m_layout.get_total_leaves(), 0.0);
+            }
+            else if (!(layout == m_layout))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' tree does not match that of previous files.");
+            }
+        }
+
+        /**
+         *  Read the description of each detector from a tally file.
+         *  The detectors of the first file merged are kept, and the detectors of every later file are checked against
+         *  them.
+         *
+         *  @param  t_stream    Stream of the tally file.
+         *  @param  t_path      Path to the tally file.
+         */
+        void Tallies::read_detectors(std::istream& t_stream, const std::string& t_path)
+        {
+            // Read the ccds.
+            unsigned long int num_ccd = 0;
+            utl::read_binary(t_stream, num_ccd);
+            if (!t_stream || ((m_num_files > 0) && (num_ccd != m_ccd_image.size())))
+            {
+                ERROR("Unable to read tally file.", "File: '" << t_path << "' ccds do not match those of previous files.");
+            }
+            for (size_t i = 0; i < num_ccd; ++i)
+            {
+                std::string       name;
+                unsigned long int width  = 0;
+                unsigned long int height = 0;
+                utl::read_binary(t_stream, name);
+                utl::read_binary(t_stream, width);
+                utl::read_binary(t_stream, height);
+                if (!t_stream)
+                {
+                    ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+                }
+
+                if (m_num_files == 0)
+                {
+                    m_ccd_name.push_back(name);
+                    m_ccd_image.emplace_back(width, height);
+                }
+                else if ((name != m_ccd_name[i]) || (width != m_ccd_image[i].get_width())
+                         || (height != m_ccd_image[i].get_height()))
+                {
+                    ERROR("Unable to read tally file.", "File: '" << t_path << "' ccds do not match those of previous files.");
+                }
+            }
+
+            // Read the spectrometers.
+            unsigned long int num_spectrometer = 0;
+            utl::read_binary(t_stream, num_spectrometer);
+            if (!t_stream || ((m_num_files > 0) && (num_spectrometer != m_spectrometer_data.size())))
+            {
+                ERROR("Unable to read tally file.",
+                      "File: '" << t_path << "' spectrometers do not match those of previous files.");
+            }
+            for (size_t i = 0; i < num_spectrometer; ++i)
+            {
+                std::string       name;
+                double            min_bound = 0.0;
+                double            max_bound = 0.0;
+                unsigned long int num_bin   = 0;
+                utl::read_binary(t_stream, name);
+                utl::read_binary(t_stream, min_bound);
+                utl::read_binary(t_stream, max_bound);
+                utl::read_binary(t_stream, num_bin);
+                if (!t_stream || (min_bound >= max_bound) || (num_bin == 0))
+                {
+                    ERROR("Unable to read tally file.", "File: '" << t_path << "' is incomplete.");
+                }
+
+                if (m_num_files == 0)
+                {
+                    m_spectrometer_name.push_back(name);
+                    m_spectrometer_data.emplace_back(min_bound, max_bound, num_bin);
+                }
+                else if ((name != m_spectrometer_name[i]) || (min_bound != m_spectrometer_data[i].get_min_bound())
+                         || (max_bound != m_spectrometer_data[i].get_max_bound())
+                         || (num_bin != m_spectrometer_data[i].get_num_bin()))
+                {
+                    ERROR("Unable to read tally file.",
+                          "File: '" << t_path << "' spectrometers do not match those of previous files.");
+                }
+            }
+        }
+
+
+        //  -- Saving --
+        /**
+         *  Save the tree images.
+         *  The leaf energies are rasterised once into a flat data cube, which is normalised as each slice is written.
+         *  If enabled, the un-normalised cube is also saved as a single binary volume file.
+         *
+         *  @param  t_output_dir    Directory to write the images to.
+         *  @param  t_level         Level of depth resolution to save images with.
+         */
+        void Tallies::save_tree_images(const std::string& t_output_dir, const size_t t_level) const
+        {
+            // Form the data cube from the leaf energies, using up to the maximum number of threads.
+            const data::Cube data_cube = m_layout.get_data_cube(m_total.cell_energy, t_level, m_max_threads);
+
+            // Determine the normalisation.
+            const double max = data_cube.get_max_value();
+            if (max <= 0.0)
+            {
+                WARN("Unable to save tree images.", "Maximum energy density was less than, or equal to, zero.");
+
+                return;
+            }
+
+            // Save slices of the data cube.
+            data_cube.save_slices(t_output_dir, X, max, m_image_format);
+            data_cube.save_slices(t_output_dir, Y, max, m_image_format);
+            data_cube.save_slices(t_output_dir, Z, max, m_image_format);
+
+            // Save the volume.
+            if (m_save_volume)
+            {
+                const math::Vec<3> min_bound = m_layout.get_min_bound();
+                const math::Vec<3> max_bound = m_layout.get_max_bound();
+
+                data_cube.save(t_output_dir + "energy_density", {{min_bound[X], min_bound[Y], min_bound[Z]}},
+                               {{max_bound[X], max_bound[Y], max_bound[Z]}});
+
+                LOG("Grid volume saving complete.");
+            }
+        }
+
+        /**
+         *  Save the ccd images, normalised together.
+         *
+         *  @param  t_output_dir    Directory to write the images to.
+         */
+        void Tallies::save_ccd_images(const std::string& t_output_dir) const
+        {
+            // Get the maximum rgb values.
+            double max = 0.0;
+            for (size_t i = 0; i < m_ccd_image.size(); ++i)
+            {
+                const std::array<double, 3> ccd_max = m_ccd_image[i].get_max_value();
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    if (ccd_max[j] > max)
+                    {
+                        max = ccd_max[j];
+                    }
+                }
+            }
+
+            // Check maximum was not zero.
+            if ((!m_ccd_image.empty()) && (max <= 0.0))
+            {
+                WARN("Unable to save ccd images.", "Maximum pixel value was less than, or equal to, zero.");
+
+                return;
+            }
+
+            // Save each ccd image.
+            for (size_t i = 0; i < m_ccd_image.size(); ++i)
+            {
+                m_ccd_image[i].save(t_output_dir + m_ccd_name[i], max, m_image_format);
+            }
+
+            LOG("CCD image saving complete.");
+        }
+
+        /**
+         *  Save the spectrometer data.
+         *
+         *  @param  t_output_dir    Directory to write the data to.
+         */
+        void Tallies::save_spectrometer_data(const std::string& t_output_dir) const
+        {
+            // Save each spectrometer's data.
+            for (size_t i = 0; i < m_spectrometer_data.size(); ++i)
+            {
+                m_spectrometer_data[i].save(t_output_dir + m_spectrometer_name[i], false, data::Histogram::align::CENTER,
+                                            m_hist_format);
+            }
+
+            LOG("Spectrometer data saving complete.");
+        }
+
+        /**
+         *  Save the histogram data.
+         *
+         *  @param  t_output_dir    Directory to write the histograms to.
+         */
+        void Tallies::save_histogram_data(const std::string& t_output_dir) const
+        {
+            // Save the scattering data.
+            m_total.scatters.save(t_output_dir + "scatters", false, data::Histogram::align::CENTER, m_hist_format);
+
+            // Save the exit weight data.
+            m_total.exit_weight.save(t_output_dir + "weight", false, data::Histogram::align::CENTER, m_hist_format);
+        }
+
+        /**
+         *  Save all merged data, each type of data within its own sub-directory.
+         *
+         *  @param  t_output_dir    Directory to write the data to.
+         *  @param  t_image_res     Level of depth resolution to save tree images with.
+         *
+         *  @pre    The tallies must hold the data of a simulation, or of at least one tally file.
+         */
+        void Tallies::save_data(const std::string& t_output_dir, const size_t t_image_res) const
+        {
+            assert(!m_total.cell_energy.empty());
+
+            // Save tree images.
+            const std::string tree_images_dir = t_output_dir + "tree_images/";
+            utl::create_directory(tree_images_dir);
+            save_tree_images(tree_images_dir, t_image_res);
+
+            // Save ccd data.
+            const std::string ccd_images_dir = t_output_dir + "ccd_images/";
+            utl::create_directory(ccd_images_dir);
+            save_ccd_images(ccd_images_dir);
+
+            // Save spectrometer data.
+            const std::string spectrometer_data_dir = t_output_dir + "spectrometer_data/";
+            utl::create_directory(spectrometer_data_dir);
+            save_spectrometer_data(spectrometer_data_dir);
+
+            // Save histogram data.
+            const std::string hist_data_dir = t_output_dir + "hist_data/";
+            utl::create_directory(hist_data_dir);
+            save_histogram_data(hist_data_dir);
+        }
+
+
+
+    } // namespace setup
+} // namespace arc
@@ -0,0 +1,112 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_SETUP_TALLIES_HPP
+#define ARCTORUS_SRC_CLS_SETUP_TALLIES_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <string>
+#include <vector>
+
+//  -- Classes --
+#include "cls/data/histogram.hpp"
+#include "cls/data/image.hpp"
+#include "cls/data/json.hpp"
+#include "cls/random/generator.hpp"
+#include "cls/setup/sim.hpp"
+#include "cls/tree/layout.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace setup
+    {
+
+
+
+        //  == CLASS ==
+        /**
+         *  Raw data summed from any number of tally files written by the runs of a single simulation.
+         *  Each file holds the layout of the tree's leaf cells and a description of each detector alongside its tallies,
+         *  so the data may be merged and saved exactly as the simulation would, without loading any meshes or building
+         *  the tree.
+         */
+        class Tallies
+        {
+            //  == FIELDS ==
+          private:
+            //  -- Run --
+            const unsigned long int       m_num_phot;       //! Total number of photons of the simulation.
+            const random::Generator::base m_seed;           //! Seed of the simulation which wrote the files.
+            const unsigned int            m_max_threads;    //! Number of threads to rasterise the tree with.
+
+            //  -- Tree --
+            tree::Layout m_layout;  //! Layout of the leaf cells of the tree.
+
+            //  -- Data --
+            Sim::Tally                   m_total;               //! Data summed from the files merged.
+            std::vector<std::string>     m_ccd_name;            //! Name of each ccd.
+            std::vector<data::Image>     m_ccd_image;           //! Image summed for each ccd.
+            std::vector<std::string>     m_spectrometer_name;   //! Name of each spectrometer.
+            std::vector<data::Histogram> m_spectrometer_data;   //! Wavelength data summed for each spectrometer.
+            unsigned long int            m_num_files = 0;       //! Number of files merged.
+
+            //  -- Output --
+            const data::Image::format     m_image_format;   //! Format to save ccd images and tree slices as.
+            const data::Histogram::format m_hist_format;    //! Format to save histograms and spectrometer data as.
+            const bool                    m_save_volume;    //! If true, also save the tree data cube as a binary volume.
+
+
+            //  == INSTANTIATION ==
+          public:
+            //  -- Constructors --
+            explicit Tallies(const data::Json& t_param);
+            explicit Tallies(const Sim& t_sim);
+
+
+            //  == METHODS ==
+          public:
+            //  -- Getters --
+            const data::Histogram& get_scatter_hist() const { return (m_total.scatters); }
+            const data::Histogram& get_exit_weight_hist() const { return (m_total.exit_weight); }
+            unsigned long int get_num_phot() const { return (m_num_phot); }
+            unsigned long int get_num_tallied_phot() const { return (m_total.get_num_phot()); }
+            void get_error_report() const;
+
+            //  -- Merging --
+            void merge(const std::string& t_path);
+
+            //  -- Saving --
+            void save_tree_images(const std::string& t_output_dir, size_t t_level) const;
+            void save_ccd_images(const std::string& t_output_dir) const;
+            void save_spectrometer_data(const std::string& t_output_dir) const;
+            void save_histogram_data(const std::string& t_output_dir) const;
+            void save_data(const std::string& t_output_dir, size_t t_image_res) const;
+
+          private:
+            //  -- Merging --
+            void read_layout(std::istream& t_stream, const std::string& t_path);
+            void read_detectors(std::istream& t_stream, const std::string& t_path);
+        };
+
+
+
+    } // namespace setup
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_SETUP_TALLIES_HPP
@@ -14,6 +14,11 @@
 
 //  == INCLUDES ==
 //  -- System --
+#include <future>
+
+#if defined(ENABLE_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 
 
@@ -32,6 +37,7 @@ namespace arc
          *  Tree will reproduce until at least the minimum depth has been reached.
          *  Tree will stop reproducing until either the maxmium depth is reached, or the target maximum number of triangles has
          *  been reached.
+         *  Subtrees are built in parallel by up to the given number of threads.
          *
          *  @param  t_min_depth     Minimum depth for the cell to split to.
          *  @param  t_max_depth     Maximum depth for the cell to split to.
@@ -42,6 +48,9 @@ namespace arc
          *  @param  t_light         Vector of light objects which may lie within the cell.
          *  @param  t_ccd           Vector of ccd objects which may lie within the cell.
          *  @param  m_spectrometer  Vector of spectrometer objects which may lie within the cell.
+         *  @param  t_num_threads   Number of threads which may build the tree.
+         *
+         *  @pre    t_num_threads must be positive.
          *
          *  @post   t_min_depth must be less than, or equal to, t_max_depth.
          *  @post   t_max_bound[X] must be greater than t_min_bound[X].
@@ -54,21 +63,14 @@ namespace arc
         Cell::Cell(const unsigned int t_min_depth, const unsigned int t_max_depth, const unsigned int t_max_tri,
                    const math::Vec<3>& t_min_bound, const math::Vec<3>& t_max_bound, const std::vector<equip::Entity>& t_entity,
                    const std::vector<equip::Light>& t_light, const std::vector<detector::Ccd>& t_ccd,
-                   const std::vector<detector::Spectrometer>& t_spectrometer) :
-            m_center((t_max_bound + t_min_bound) / 2.0),
-            m_half_width((t_max_bound - t_min_bound) / 2.0),
-            m_entity(t_entity),
-            m_light(t_light),
-            m_ccd(t_ccd),
-            m_spectrometer(t_spectrometer),
-            m_entity_tri_list(init_entity_tri_list()),
-            m_light_tri_list(init_light_tri_list()),
-            m_ccd_tri_list(init_ccd_tri_list()),
-            m_spectrometer_tri_list(init_spectrometer_tri_list()),
-            m_depth(0),
-            m_leaf(init_leaf(t_min_depth, t_max_depth, t_max_tri)),
-            m_child(init_child(t_min_depth, t_max_depth, t_max_tri))
+                   const std::vector<detector::Spectrometer>& t_spectrometer, const unsigned int t_num_threads) :
+            Cell(0, (t_max_bound + t_min_bound) / 2.0, (t_max_bound - t_min_bound) / 2.0, t_entity, t_light, t_ccd,
+                 t_spectrometer, init_root_list(t_entity, t_light, t_ccd, t_spectrometer),
+                 Build(t_min_depth, t_max_depth, t_max_tri,
+                       std::make_shared<std::atomic<unsigned int>>(t_num_threads > 0 ? t_num_threads - 1 : 0)))
         {
+            assert(t_num_threads > 0);
+
             assert(t_min_depth <= t_max_depth);
 
             assert(t_max_bound[X] > t_min_bound[X]);
@@ -78,359 +80,458 @@ namespace arc
             assert(m_half_width[X] > 0.0);
             assert(m_half_width[Y] > 0.0);
             assert(m_half_width[Z] > 0.0);
+
+            // Number the leaf cells of the tree.
+            size_t num_leaves = 0;
+            init_leaf_index(num_leaves);
+
+            // Flatten the tree for leaf lookups and link the neighbouring cells.
+            m_node      = init_node();
+            m_leaf_rope = init_leaf_rope();
+        }
+
+        /**
+         *  Construct the top cell of a subtree with its own build state.
+         *
+         *  @param  t_depth         Depth of the cell.
+         *  @param  t_center        Center of the cell.
+         *  @param  t_half_width    Half-width of the cell.
+         *  @param  t_entity        Vector of entity objects which may lie within the cell.
+         *  @param  t_light         Vector of light objects which may lie within the cell.
+         *  @param  t_ccd           Vector of ccd objects which may lie within the cell.
+         *  @param  t_spectrometer  Vector of spectrometer objects which may lie within the cell.
+         *  @param  t_parent_list   Lists of triangles which may lie within the cell.
+         *  @param  t_build         Build state of the subtree.
+         */
+        Cell::Cell(const unsigned int t_depth, const math::Vec<3>& t_center, const math::Vec<3>& t_half_width,
+                   const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                   const std::vector<detector::Ccd>& t_ccd, const std::vector<detector::Spectrometer>& t_spectrometer,
+                   const Lists& t_parent_list, Build&& t_build) :
+            Cell(t_depth, t_center, t_half_width, t_entity, t_light, t_ccd, t_spectrometer, t_parent_list, t_build)
+        {
         }
 
         /**
          *  Construct a child cell to record a sub-list of entity, light, ccd and spectrometer objects.
-         *  Only tests overlaps of triangles listed within the given triangle directory lists.
+         *  Only tests overlaps of triangles listed within the given triangle lists.
          *  Depth, cell center and cell half-width are set using given values.
          *
-         *  @param  t_depth                 Depth of the cell.
-         *  @param  t_min_depth             Minimum depth for the cell to split to.
-         *  @param  t_max_depth             Maximum depth for the cell to split to.
-         *  @param  t_max_tri               Target maximum number of triangles to contain within leaf cells.
-         *  @param  t_center                Center of the cell.
-         *  @param  t_half_width            Half-width of the cell.
-         *  @param  t_entity                Vector of entity objects which may lie within the cell.
-         *  @param  t_light                 Vector of light objects which may lie within the cell.
-         *  @param  t_ccd                   Vector of ccd objects which may lie within the cell.
-         *  @param  t_spectrometer          Vector of spectrometer objects which may lie within the cell.
-         *  @param  t_entity_tri_list       List of entity triangles which may lie within the cell.
-         *  @param  t_light_tri_list        List of light triangles which may lie within the cell.
-         *  @param  t_ccd_tri_list          List of ccd triangles which may lie within the cell.
-         *  @param  t_spectrometer_tri_list List of spectrometer triangles which may lie within the cell.
+         *  @param  t_depth         Depth of the cell.
+         *  @param  t_center        Center of the cell.
+         *  @param  t_half_width    Half-width of the cell.
+         *  @param  t_entity        Vector of entity objects which may lie within the cell.
+         *  @param  t_light         Vector of light objects which may lie within the cell.
+         *  @param  t_ccd           Vector of ccd objects which may lie within the cell.
+         *  @param  t_spectrometer  Vector of spectrometer objects which may lie within the cell.
+         *  @param  t_parent_list   Lists of triangles which may lie within the cell.
+         *  @param  t_build         Build state of the branch containing the cell.
+         *
+         *  @pre    t_depth must not exceed the maximum depth of t_build.
          */
-        Cell::Cell(unsigned int t_depth, unsigned int t_min_depth, unsigned int t_max_depth, unsigned int t_max_tri,
-                   const math::Vec<3>& t_center, const math::Vec<3>& t_half_width, const std::vector<equip::Entity>& t_entity,
-                   const std::vector<equip::Light>& t_light, const std::vector<detector::Ccd>& t_ccd,
-                   const std::vector<detector::Spectrometer>& t_spectrometer,
-                   const std::vector<std::array<size_t, 2>>& t_entity_tri_list,
-                   const std::vector<std::array<size_t, 2>>& t_light_tri_list,
-                   const std::vector<std::array<size_t, 2>>& t_ccd_tri_list,
-                   const std::vector<std::array<size_t, 2>>& t_spectrometer_tri_list) :
+        Cell::Cell(const unsigned int t_depth, const math::Vec<3>& t_center, const math::Vec<3>& t_half_width,
+                   const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                   const std::vector<detector::Ccd>& t_ccd, const std::vector<detector::Spectrometer>& t_spectrometer,
+                   const Lists& t_parent_list, Build& t_build) :
             m_center(t_center),
             m_half_width(t_half_width),
             m_entity(t_entity),
             m_light(t_light),
             m_ccd(t_ccd),
             m_spectrometer(t_spectrometer),
-            m_entity_tri_list(init_entity_tri_list(t_entity_tri_list)),
-            m_light_tri_list(init_light_tri_list(t_light_tri_list)),
-            m_ccd_tri_list(init_ccd_tri_list(t_ccd_tri_list)),
-            m_spectrometer_tri_list(init_spectrometer_tri_list(t_spectrometer_tri_list)),
+            m_num_tri(init_list(t_parent_list, t_build.level[t_depth])),
             m_depth(t_depth),
-            m_leaf(init_leaf(t_min_depth, t_max_depth, t_max_tri)),
-            m_child(init_child(t_min_depth, t_max_depth, t_max_tri))
+            m_leaf(init_leaf(t_build)),
+            m_surface_list(init_surface_list(t_build.level[t_depth])),
+            m_surface_batch(init_surface_batch()),
+            m_child(init_child(t_build))
         {
+            assert(t_depth <= t_build.max_depth);
         }
 
 
         //  -- Initialisation --
         /**
-         *  Initialise the vector list of entity triangles within the cell.
+         *  Initialise the lists of every triangle of the given objects, from which the root cell filters its own.
          *
-         *  @return The initialised list vector of entity triangles within the cell.
+         *  @param  t_entity        Vector of entity objects.
+         *  @param  t_light         Vector of light objects.
+         *  @param  t_ccd           Vector of ccd objects.
+         *  @param  t_spectrometer  Vector of spectrometer objects.
+         *
+         *  @return The initialised lists of all object triangles.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_entity_tri_list() const
+        Cell::Lists Cell::init_root_list(const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                                         const std::vector<detector::Ccd>& t_ccd,
+                                         const std::vector<detector::Spectrometer>& t_spectrometer)
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_entity_tri_list;
+            Lists r_list;
 
-            // Iterate through each of the entity sources.
-            for (size_t i = 0; i < m_entity.size(); ++i)
+            for (size_t i = 0; i < t_entity.size(); ++i)
             {
-                // Iterate through each of the entity's triangles.
-                for (size_t j = 0; j < m_entity[i].get_mesh().get_num_tri(); ++j)
+                for (size_t j = 0; j < t_entity[i].get_mesh().get_num_tri(); ++j)
                 {
-                    // If the cell overlaps any part of the triangle, add the indices to the list.
-                    if (tri_overlap(m_entity[i].get_mesh().get_tri(j)))
-                    {
-                        r_entity_tri_list.push_back({{i, j}});
-                    }
+                    r_list[ENTITY_LIST].push_back({{i, j}});
+                }
+            }
+            for (size_t i = 0; i < t_light.size(); ++i)
+            {
+                for (size_t j = 0; j < t_light[i].get_mesh().get_num_tri(); ++j)
+                {
+                    r_list[LIGHT_LIST].push_back({{i, j}});
+                }
+            }
+            for (size_t i = 0; i < t_ccd.size(); ++i)
+            {
+                for (size_t j = 0; j < t_ccd[i].get_mesh().get_num_tri(); ++j)
+                {
+                    r_list[CCD_LIST].push_back({{i, j}});
+                }
+            }
+            for (size_t i = 0; i < t_spectrometer.size(); ++i)
+            {
+                for (size_t j = 0; j < t_spectrometer[i].get_mesh().get_num_tri(); ++j)
+                {
+                    r_list[SPECTROMETER_LIST].push_back({{i, j}});
                 }
             }
 
-            return (r_entity_tri_list);
+            return (r_list);
         }
 
         /**
-         *  Initialise the vector list of entity triangles within the cell using a sub vector list of triangles.
+         *  Filter the triangles of the parent cell's lists which overlap this cell into the given lists.
+         *  The lists are overwritten, reusing their storage, and keep the order of the parent lists.
+         *  Triangles are tested in blocks, with the final block of each list padded by repeating its last triangle.
          *
-         *  @param  t_entity_tri_list   List of entity triangles which may lie within the cell.
+         *  @param  t_parent_list   Lists of triangles which may lie within the cell.
+         *  @param  t_list          Lists to fill with the triangles overlapping the cell.
          *
-         *  @return The initialised list vector of entity triangles within the cell.
+         *  @return The total number of triangles overlapping the cell.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_entity_tri_list(
-            const std::vector<std::array<size_t, 2>>& t_entity_tri_list) const
+        size_t Cell::init_list(const Lists& t_parent_list, Lists& t_list) const
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_entity_tri_list;
+            size_t r_num_tri = 0;
 
-            // Iterate through the vector list of triangles.
-            for (size_t i = 0; i < t_entity_tri_list.size(); ++i)
+            for (size_t i = 0; i < NUM_LISTS; ++i)
             {
-                if (tri_overlap(m_entity[t_entity_tri_list[i][OBJ]].get_mesh().get_tri(t_entity_tri_list[i][TRI])))
+                const std::vector<std::array<size_t, 2>>& parent_list = t_parent_list[i];
+
+                t_list[i].clear();
+
+                for (size_t j = 0; j < parent_list.size(); j += OVERLAP_WIDTH)
                 {
-                    r_entity_tri_list.push_back(t_entity_tri_list[i]);
+                    const size_t width = std::min(OVERLAP_WIDTH, parent_list.size() - j);
+
+                    std::array<const geom::Triangle*, OVERLAP_WIDTH> tri;
+                    for (size_t k = 0; k < OVERLAP_WIDTH; ++k)
+                    {
+                        tri[k] = &get_list_tri(i, parent_list[j + std::min(k, width - 1)]);
+                    }
+
+                    // If the cell overlaps any part of a triangle, add its indices to the list.
+                    const unsigned int overlap = tri_overlap_block(tri);
+                    for (size_t k = 0; k < width; ++k)
+                    {
+                        if ((overlap & (1u << k)) != 0)
+                        {
+                            t_list[i].push_back(parent_list[j + k]);
+                        }
+                    }
                 }
+
+                r_num_tri += t_list[i].size();
             }
 
-            return (r_entity_tri_list);
+            return (r_num_tri);
         }
 
         /**
-         *  Initialise the vector list of light triangles within the cell.
+         *  Determine if this cell is a terminal leaf cell.
+         *
+         *  @param  t_build Build state of the branch containing the cell.
          *
-         *  @return The initialised list vector of light triangles within the cell.
+         *  @return True if this cell is a terminal leaf cell.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_light_tri_list() const
+        bool Cell::init_leaf(const Build& t_build) const
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_light_tri_list;
+            // If the cell has reached the maximum allowed depth, it is required to be terminal.
+            if (m_depth >= t_build.max_depth)
+            {
+                return (true);
+            }
 
-            // Iterate through each of the light sources.
-            for (size_t i = 0; i < m_light.size(); ++i)
+            // If the cell has not yet reached the minimum splitting depth, it must procreate.
+            if (m_depth < t_build.min_depth)
             {
-                // Iterate through each of the light's triangles.
-                for (size_t j = 0; j < m_light[i].get_mesh().get_num_tri(); ++j)
-                {
-                    // If the cell overlaps any part of the triangle, add the indices to the list.
-                    if (tri_overlap(m_light[i].get_mesh().get_tri(j)))
-                    {
-                        r_light_tri_list.push_back({{i, j}});
-                    }
-                }
+                return (false);
             }
 
-            return (r_light_tri_list);
+            // Otherwise, only split if the number of contained triangles exceeds that of the maximum limit.
+            return (m_num_tri <= t_build.max_tri);
         }
 
         /**
-         *  Initialise the vector list of light triangles within the cell using a sub vector list of triangles.
+         *  Initialise the tagged list of surface triangles within a leaf cell.
+         *  Entity triangles are listed first, then ccd triangles, then spectrometer triangles.
+         *  Branch cells are never intersected so their list is left empty.
          *
-         *  @param  t_light_tri_list    List of light triangles which may lie within the cell.
+         *  @param  t_list  Lists of triangles overlapping the cell.
          *
-         *  @return The initialised list vector of light triangles within the cell.
+         *  @return The initialised list of surface triangles within the cell.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_light_tri_list(
-            const std::vector<std::array<size_t, 2>>& t_light_tri_list) const
+        std::vector<Cell::Surface> Cell::init_surface_list(const Lists& t_list) const
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_light_tri_list;
+            std::vector<Surface> r_surface_list;
 
-            // Iterate through the vector list of triangles.
-            for (size_t i = 0; i < t_light_tri_list.size(); ++i)
+            // Branch cells do not require a surface list.
+            if (!m_leaf)
             {
-                if (tri_overlap(m_light[t_light_tri_list[i][OBJ]].get_mesh().get_tri(t_light_tri_list[i][TRI])))
-                {
-                    r_light_tri_list.push_back(t_light_tri_list[i]);
-                }
+                return (r_surface_list);
             }
 
-            return (r_light_tri_list);
+            const std::vector<std::array<size_t, 2>>& entity_list       = t_list[ENTITY_LIST];
+            const std::vector<std::array<size_t, 2>>& ccd_list          = t_list[CCD_LIST];
+            const std::vector<std::array<size_t, 2>>& spectrometer_list = t_list[SPECTROMETER_LIST];
+
+            r_surface_list.reserve(entity_list.size() + ccd_list.size() + spectrometer_list.size());
+            for (size_t i = 0; i < entity_list.size(); ++i)
+            {
+                r_surface_list.push_back({surface::ENTITY, entity_list[i][OBJ], entity_list[i][TRI]});
+            }
+            for (size_t i = 0; i < ccd_list.size(); ++i)
+            {
+                r_surface_list.push_back({surface::CCD, ccd_list[i][OBJ], ccd_list[i][TRI]});
+            }
+            for (size_t i = 0; i < spectrometer_list.size(); ++i)
+            {
+                r_surface_list.push_back({surface::SPECTROMETER, spectrometer_list[i][OBJ], spectrometer_list[i][TRI]});
+            }
+
+            return (r_surface_list);
         }
 
         /**
-         *  Initialise the vector list of ccd triangles within the cell.
+         *  Initialise the batch of surface triangles within the cell, in the order of the surface list.
          *
-         *  @return The initialised list vector of ccd triangles within the cell.
+         *  @return The initialised batch of surface triangles within the cell.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_ccd_tri_list() const
+        geom::Batch Cell::init_surface_batch() const
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_ccd_tri_list;
+            geom::Batch r_surface_batch;
 
-            // Iterate through each of the ccd sources.
-            for (size_t i = 0; i < m_ccd.size(); ++i)
+            for (size_t i = 0; i < m_surface_list.size(); ++i)
             {
-                // Iterate through each of the ccd's triangles.
-                for (size_t j = 0; j < m_ccd[i].get_mesh().get_num_tri(); ++j)
+                const Surface& surf = m_surface_list[i];
+
+                switch (surf.kind)
                 {
-                    // If the cell overlaps any part of the triangle, add the indices to the list.
-                    if (tri_overlap(m_ccd[i].get_mesh().get_tri(j)))
-                    {
-                        r_ccd_tri_list.push_back({{i, j}});
-                    }
+                    case surface::ENTITY:
+                        r_surface_batch.add_tri(m_entity[surf.owner].get_mesh().get_tri(surf.tri));
+                        break;
+                    case surface::CCD:
+                        r_surface_batch.add_tri(m_ccd[surf.owner].get_mesh().get_tri(surf.tri));
+                        break;
+                    case surface::SPECTROMETER:
+                        r_surface_batch.add_tri(m_spectrometer[surf.owner].get_mesh().get_tri(surf.tri));
+                        break;
+                    default: ERROR("Unable to construct surface batch.", "Surface list contains an invalid surface kind.");
                 }
             }
 
-            return (r_ccd_tri_list);
+            return (r_surface_batch);
         }
 
         /**
-         *  Initialise the vector list of ccd triangles within the cell using a sub vector list of triangles.
+         *  Initialise the array of child cells.
+         *  Each child filters this cell's lists into the next level of the build state in turn.
+         *  Whilst a thread is free, large enough children are instead built as subtrees by that thread.
          *
-         *  @param  t_ccd_tri_list  List of ccd triangles which may lie within the cell.
+         *  @param  t_build Build state of the branch containing the cell.
          *
-         *  @return The initialised list vector of ccd triangles within the cell.
+         *  @return The initialised array of child cells.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_ccd_tri_list(
-            const std::vector<std::array<size_t, 2>>& t_ccd_tri_list) const
+        std::array<std::unique_ptr<Cell>, 8> Cell::init_child(Build& t_build) const
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_ccd_tri_list;
+            std::array<std::unique_ptr<Cell>, 8> r_child;
 
-            // Iterate through the vector list of triangles.
-            for (size_t i = 0; i < t_ccd_tri_list.size(); ++i)
+            // If cell is a leaf, do not create children.
+            if (m_leaf)
             {
-                if (tri_overlap(m_ccd[t_ccd_tri_list[i][OBJ]].get_mesh().get_tri(t_ccd_tri_list[i][TRI])))
-                {
-                    r_ccd_tri_list.push_back(t_ccd_tri_list[i]);
-                }
+                return (r_child);
             }
 
-            return (r_ccd_tri_list);
-        }
+            const unsigned int child_depth = m_depth + 1;
+            const math::Vec<3> half_width  = m_half_width / 2.0;
+            const Lists& list = t_build.level[m_depth];
 
-        /**
-         *  Initialise the vector list of spectrometer triangles within the cell.
-         *
-         *  @return The initialised list vector of spectrometer triangles within the cell.
-         */
-        std::vector<std::array<size_t, 2>> Cell::init_spectrometer_tri_list() const
-        {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_spectrometer_tri_list;
+            // Only hand out subtrees worth the cost of starting a thread.
+            const bool spawn = (m_num_tri >= BUILD_TASK_MIN_TRI) || (child_depth < t_build.min_depth);
 
-            // Iterate through each of the spectrometer sources.
-            for (size_t i = 0; i < m_spectrometer.size(); ++i)
+            std::array<std::future<std::unique_ptr<Cell>>, 8> task;
+            for (size_t i = 0; i < 8; ++i)
             {
-                // Iterate through each of the spectrometer's triangles.
-                for (size_t j = 0; j < m_spectrometer[i].get_mesh().get_num_tri(); ++j)
+                // Children are ordered with the first, second and third index bits denoting the negative x, y and z sides.
+                const math::Vec<3> center(m_center[X] + (((i & 1) == 0) ? half_width[X] : -half_width[X]),
+                                          m_center[Y] + (((i & 2) == 0) ? half_width[Y] : -half_width[Y]),
+                                          m_center[Z] + (((i & 4) == 0) ? half_width[Z] : -half_width[Z]));
+
+                // Claim a free thread, if there is one, to build the subtree.
+                unsigned int free_threads = spawn ? t_build.free_threads->load() : 0;
+                while ((free_threads > 0) && !t_build.free_threads->compare_exchange_weak(free_threads, free_threads - 1))
+                {
+                }
+
+                if (free_threads > 0)
                 {
-                    // If the cell overlaps any part of the triangle, add the indices to the list.
-                    if (tri_overlap(m_spectrometer[i].get_mesh().get_tri(j)))
+                    task[i] = std::async(std::launch::async, [this, &t_build, &list, child_depth, center, half_width]()
                     {
-                        r_spectrometer_tri_list.push_back({{i, j}});
-                    }
+                        std::unique_ptr<Cell> r_cell(
+                            new Cell(child_depth, center, half_width, m_entity, m_light, m_ccd, m_spectrometer, list,
+                                     Build(t_build.min_depth, t_build.max_depth, t_build.max_tri, t_build.free_threads)));
+
+                        // Release the thread.
+                        ++(*t_build.free_threads);
+
+                        return (r_cell);
+                    });
+                }
+                else
+                {
+                    r_child[i] = std::unique_ptr<Cell>(
+                        new Cell(child_depth, center, half_width, m_entity, m_light, m_ccd, m_spectrometer, list, t_build));
+                }
+            }
+
+            // Collect the subtrees built by other threads.
+            for (size_t i = 0; i < 8; ++i)
+            {
+                if (task[i].valid())
+                {
+                    r_child[i] = task[i].get();
                 }
             }
 
-            return (r_spectrometer_tri_list);
+            return (r_child);
         }
 
         /**
-         *  Initialise the vector list of spectrometer triangles within the cell using a sub vector list of triangles.
+         *  Recursively assign each leaf cell a dense index, in Morton order, starting from the given count.
          *
-         *  @param  t_spectrometer_tri_list List of spectrometer triangles which may lie within the cell.
-         *
-         *  @return The initialised list vector of spectrometer triangles within the cell.
+         *  @param  t_num_leaves    Number of leaf cells indexed so far, incremented for each leaf cell indexed.
          */
-        std::vector<std::array<size_t, 2>> Cell::init_spectrometer_tri_list(
-            const std::vector<std::array<size_t, 2>>& t_spectrometer_tri_list) const
+        void Cell::init_leaf_index(size_t& t_num_leaves)
         {
-            // Create the return triangle list.
-            std::vector<std::array<size_t, 2>> r_spectrometer_tri_list;
-
-            // Iterate through the vector list of triangles.
-            for (size_t i = 0; i < t_spectrometer_tri_list.size(); ++i)
+            // If this cell is a leaf, take the next index.
+            if (m_leaf)
             {
-                if (tri_overlap(
-                    m_spectrometer[t_spectrometer_tri_list[i][OBJ]].get_mesh().get_tri(t_spectrometer_tri_list[i][TRI])))
-                {
-                    r_spectrometer_tri_list.push_back(t_spectrometer_tri_list[i]);
-                }
+                m_leaf_index = t_num_leaves;
+                ++t_num_leaves;
+
+                return;
             }
 
-            return (r_spectrometer_tri_list);
+            // Index the child cells.
+            for (size_t i = 0; i < 8; ++i)
+            {
+                m_child[i]->init_leaf_index(t_num_leaves);
+            }
         }
 
+
+
         /**
-         *  Determine if this cell is a terminal leaf cell.
+         *  Initialise the flattened array of tree nodes.
+         *  Nodes are stored breadth-first with the eight children of each node stored contiguously in child index order,
+         *  so each level of the tree is laid out in Morton order and a descent walks forwards through contiguous memory.
          *
-         *  @param  t_min_depth     Minimum depth for the cell to split to.
-         *  @param  t_max_depth     Maximum depth for the cell to split to.
-         *  @param  t_max_tri       Target maximum number of triangles to contain within leaf cells.
-         *
-         *  @return True if this cell is a terminal leaf cell.
+         *  @return The initialised array of tree nodes.
          */
-        bool Cell::init_leaf(const unsigned int t_min_depth, const unsigned int t_max_depth, const unsigned int t_max_tri) const
+        std::vector<Cell::Node> Cell::init_node()
         {
-            // If the cell has reached the maximum allowed depth, it is required to be terminal.
-            if (m_depth >= t_max_depth)
-            {
-                return (true);
-            }
+            // Create the return node array, starting with this cell.
+            std::vector<Node> r_node({{m_center, m_half_width, 0, this}});
 
-            // If the cell has not yet reached the minimum splitting depth, it must procreate.
-            if (m_depth < t_min_depth)
+            // Append the children of each node in turn.
+            for (size_t i = 0; i < r_node.size(); ++i)
             {
-                return (false);
+                Cell* const cell = r_node[i].cell;
+
+                if (!cell->m_leaf)
+                {
+                    r_node[i].first_child = r_node.size();
+
+                    for (size_t j = 0; j < 8; ++j)
+                    {
+                        r_node.push_back(
+                            {cell->m_child[j]->m_center, cell->m_child[j]->m_half_width, 0, cell->m_child[j].get()});
+                    }
+                }
             }
 
-            // Otherwise, only split if the number of contained triangles exceeds that of the maximum limit.
-            size_t total_triangles = m_entity_tri_list.size() + m_light_tri_list.size() + m_ccd_tri_list
-                .size() + m_spectrometer_tri_list.size();
-            return (total_triangles <= t_max_tri);
+            return (r_node);
         }
 
         /**
-         *  Initialise the array of child cells.
-         *
-         *  @param  t_min_depth     Minimum depth for the cell to split to.
-         *  @param  t_max_depth     Maximum depth for the cell to split to.
-         *  @param  t_max_tri       Target maximum number of triangles to contain within leaf cells.
+         *  Initialise the neighbour links, or ropes, of each leaf cell.
+         *  The rope of a face is the node index of the smallest node, no smaller than the leaf, which lies across that face.
+         *  Where no such node exists, as the face lies on the boundary of the tree, the rope is zero.
+         *  Ropes are found for every node from the top down, as a child's neighbour is either one of its siblings, or a
+         *  child of its parent's neighbour.
          *
-         *  @return The initialised array of child cells.
+         *  @return The initialised ropes of each leaf cell, indexed by leaf index and then by face.
          */
-        std::array<std::unique_ptr<Cell>, 8> Cell::init_child(const unsigned int t_min_depth, const unsigned int t_max_depth,
-                                                              const unsigned int t_max_tri) const
+        std::vector<std::array<size_t, 6>> Cell::init_leaf_rope() const
         {
-            // If cell is a leaf, do not create children.
-            if (m_leaf)
+            // Find the ropes of every node, parents being stored before their children.
+            std::vector<std::array<size_t, 6>> rope(m_node.size(), {{0, 0, 0, 0, 0, 0}});
+            for (size_t                        i = 0; i < m_node.size(); ++i)
             {
-                return (std::array<std::unique_ptr<Cell>, 8>(
-                    {{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}}));
+                if (m_node[i].first_child == 0)
+                {
+                    continue;
+                }
+
+                for (size_t j = 0; j < 8; ++j)
+                {
+                    for (size_t f = 0; f < 6; ++f)
+                    {
+                        // A set child index bit places the child on the minimum side of the axis.
+                        const size_t axis_bit = static_cast<size_t>(1) << (f / 2);
+                        const bool   min_side = (j & axis_bit) != 0;
+
+                        // If the face is shared with a sibling, link directly to the sibling.
+                        if (min_side == ((f % 2) == 1))
+                        {
+                            rope[m_node[i].first_child + j][f] = m_node[i].first_child + (j ^ axis_bit);
+
+                            continue;
+                        }
+
+                        // Otherwise, link to the adjacent child of the parent's neighbour if it has children.
+                        const size_t neighbour = rope[i][f];
+                        if ((neighbour != 0) && (m_node[neighbour].first_child != 0))
+                        {
+                            rope[m_node[i].first_child + j][f] = m_node[neighbour].first_child + (j ^ axis_bit);
+                        }
+                        else
+                        {
+                            rope[m_node[i].first_child + j][f] = neighbour;
+                        }
+                    }
+                }
             }
 
-            const unsigned int child_depth = m_depth + 1;
-            const math::Vec<3> half_width  = m_half_width / 2.0;
-            const math::Vec<3> offset      = m_half_width / 2.0;
-
-            return (std::array<std::unique_ptr<Cell>, 8>(
-                {{std::make_unique<Cell>(child_depth, t_min_depth, t_max_depth, t_max_tri,
-                                         math::Vec<3>(m_center[X] + offset[X], m_center[Y] + offset[Y],
-                                                      m_center[Z] + offset[Z]), half_width, m_entity, m_light, m_ccd,
-                                         m_spectrometer, m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                                         m_spectrometer_tri_list), std::make_unique<Cell>(child_depth, t_min_depth, t_max_depth,
-                                                                                          t_max_tri,
-                                                                                          math::Vec<3>(m_center[X] - offset[X],
-                                                                                                       m_center[Y] + offset[Y],
-                                                                                                       m_center[Z] + offset[Z]),
-                                                                                          half_width, m_entity, m_light, m_ccd,
-                                                                                          m_spectrometer, m_entity_tri_list,
-                                                                                          m_light_tri_list, m_ccd_tri_list,
-                                                                                          m_spectrometer_tri_list), std::make_unique<
-                    Cell>(child_depth, t_min_depth, t_max_depth, t_max_tri,
-                          math::Vec<3>(m_center[X] + offset[X], m_center[Y] - offset[Y], m_center[Z] + offset[Z]), half_width,
-                          m_entity, m_light, m_ccd, m_spectrometer, m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                          m_spectrometer_tri_list), std::make_unique<Cell>(child_depth, t_min_depth, t_max_depth, t_max_tri,
-                                                                           math::Vec<3>(m_center[X] - offset[X],
-                                                                                        m_center[Y] - offset[Y],
-                                                                                        m_center[Z] + offset[Z]), half_width,
-                                                                           m_entity, m_light, m_ccd, m_spectrometer,
-                                                                           m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                                                                           m_spectrometer_tri_list), std::make_unique<Cell>(
-                    child_depth, t_min_depth, t_max_depth, t_max_tri,
-                    math::Vec<3>(m_center[X] + offset[X], m_center[Y] + offset[Y], m_center[Z] - offset[Z]), half_width,
-                    m_entity, m_light, m_ccd, m_spectrometer, m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                    m_spectrometer_tri_list), std::make_unique<Cell>(child_depth, t_min_depth, t_max_depth, t_max_tri,
-                                                                     math::Vec<3>(m_center[X] - offset[X],
-                                                                                  m_center[Y] + offset[Y],
-                                                                                  m_center[Z] - offset[Z]), half_width,
-                                                                     m_entity, m_light, m_ccd, m_spectrometer,
-                                                                     m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                                                                     m_spectrometer_tri_list), std::make_unique<Cell>(
-                    child_depth, t_min_depth, t_max_depth, t_max_tri,
-                    math::Vec<3>(m_center[X] + offset[X], m_center[Y] - offset[Y], m_center[Z] - offset[Z]), half_width,
-                    m_entity, m_light, m_ccd, m_spectrometer, m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                    m_spectrometer_tri_list), std::make_unique<Cell>(child_depth, t_min_depth, t_max_depth, t_max_tri,
-                                                                     math::Vec<3>(m_center[X] - offset[X],
-                                                                                  m_center[Y] - offset[Y],
-                                                                                  m_center[Z] - offset[Z]), half_width,
-                                                                     m_entity, m_light, m_ccd, m_spectrometer,
-                                                                     m_entity_tri_list, m_light_tri_list, m_ccd_tri_list,
-                                                                     m_spectrometer_tri_list)}}));
+            // Keep the ropes of the leaf cells.
+            std::vector<std::array<size_t, 6>> r_leaf_rope(get_total_leaves());
+            for (size_t                        i = 0; i < m_node.size(); ++i)
+            {
+                if (m_node[i].first_child == 0)
+                {
+                    r_leaf_rope[m_node[i].cell->m_leaf_index] = rope[i];
+                }
+            }
+
+            return (r_leaf_rope);
         }
 
 
@@ -462,139 +563,45 @@ namespace arc
         }
 
         /**
-         *  Form a data cube of the cell's energy density to a given depth resolution.
-         *
-         *  @param  t_depth Depth resolution of the data cube.
-         *
-         *  @pre    t_depth must be greater than, or equal to, the cell depth.
+         *  Determine the total number of cells attached to this cell recursively.
          *
-         *  @return A data cube of the cell's energy density.
+         *  @return The total number of cells attached to this cell.
          */
-        std::vector<std::vector<std::vector<double>>> Cell::get_data_cube(const size_t t_depth) const
+        unsigned long int Cell::get_total_cells() const
         {
-            assert(t_depth >= m_depth);
-
-            // Convert depth resolution to linear resolution.
-            const size_t res = static_cast<size_t>(1) << (t_depth - m_depth);
-
-            // Create the return data cube.
-            std::vector<std::vector<std::vector<double>>> r_data_cube;
-            r_data_cube.reserve(res);
-            for (size_t i = 0; i < res; ++i)
-            {
-                r_data_cube.emplace_back(std::vector<std::vector<double>>());
-                r_data_cube[i].reserve(res);
-                for (size_t j = 0; j < res; ++j)
-                {
-                    r_data_cube[i].emplace_back(std::vector<double>());
-                    r_data_cube[i][j].reserve(res);
-                    for (size_t k = 0; k < res; ++k)
-                    {
-                        r_data_cube[i][j].emplace_back(0.0);
-                    }
-                }
-            }
-
-            // If required depth is equal to current depth, return value.
-            if (t_depth == m_depth)
-            {
-                r_data_cube[0][0][0] = get_energy_density();
-
-                return (r_data_cube);
-            }
-
-            // If this cell is a leaf, fill the data cube uniformly with this cells energy density.
-            if (m_leaf)
-            {
-                const double energy_density = get_energy_density();
-
-                for (size_t i = 0; i < res; ++i)
-                {
-                    for (size_t j = 0; j < res; ++j)
-                    {
-                        for (size_t k = 0; k < res; ++k)
-                        {
-                            r_data_cube[i][j][k] = energy_density;
-                        }
-                    }
-                }
-
-                return (r_data_cube);
-            }
+            // Count this cell.
+            unsigned long int count = 1;
 
-            // Add child cell data to the data cube.
-            for (size_t index = 0; index < 8; ++index)
+            // Recursively count child cells.
+            if (!m_leaf)
             {
-                size_t i_offset = 0;
-                size_t j_offset = 0;
-                size_t k_offset = 0;
-                switch (index)
-                {
-                    case 0:
-                        break;
-                    case 1:
-                        i_offset = res / 2;
-                        break;
-                    case 2:
-                        j_offset = res / 2;
-                        break;
-                    case 3:
-                        i_offset = res / 2;
-                        j_offset = res / 2;
-                        break;
-                    case 4:
-                        k_offset = res / 2;
-                        break;
-                    case 5:
-                        i_offset = res / 2;
-                        k_offset = res / 2;
-                        break;
-                    case 6:
-                        j_offset = res / 2;
-                        k_offset = res / 2;
-                        break;
-                    case 7:
-                        i_offset = res / 2;
-                        j_offset = res / 2;
-                        k_offset = res / 2;
-                        break;
-                    default: ERROR("Unable to retrieve cell data cube.", "Invalid enumeration index: '" << index << "'.");
-                }
-
-                // Added data from the child data cube.
-                std::vector<std::vector<std::vector<double>>> child_cube = m_child[index]->get_data_cube(t_depth);
-                for (size_t                                   i          = 0; i < (res / 2); ++i)
+                for (size_t i = 0; i < 8; ++i)
                 {
-                    for (size_t j = 0; j < (res / 2); ++j)
-                    {
-                        for (size_t k = 0; k < (res / 2); ++k)
-                        {
-                            r_data_cube[i + i_offset][j + j_offset][k + k_offset] = child_cube[i][j][k];
-                        }
-                    }
+                    count += m_child[i]->get_total_cells();
                 }
             }
 
-            return (r_data_cube);
+            return (count);
         }
 
         /**
-         *  Determine the total number of cells attached to this cell recursively.
+         *  Determine the total number of leaf cells attached to this cell recursively.
          *
-         *  @return The total number of cells attached to this cell.
+         *  @return The total number of leaf cells attached to this cell.
          */
-        unsigned long int Cell::get_total_cells() const
+        size_t Cell::get_total_leaves() const
         {
-            // Count this cell.
-            unsigned long int count = 1;
+            // If this cell is a leaf, count only itself.
+            if (m_leaf)
+            {
+                return (1);
+            }
 
-            // Recursively count child cells.
-            if (!m_leaf)
+            // Recursively count child leaf cells.
+            size_t      count = 0;
+            for (size_t i     = 0; i < 8; ++i)
             {
-                for (size_t i = 0; i < 8; ++i)
-                {
-                    count += m_child[i]->get_total_cells();
-                }
+                count += m_child[i]->get_total_leaves();
             }
 
             return (count);
@@ -610,8 +617,7 @@ namespace arc
             // If this cell is a leaf, return its number of triangles.
             if (m_leaf)
             {
-                return (m_entity_tri_list.size() + m_light_tri_list.size() + m_ccd_tri_list.size() + m_spectrometer_tri_list
-                    .size());
+                return (m_num_tri);
             }
 
             // If this cell is not a leaf, determine the maximum number of triangles within a child cell.
@@ -630,6 +636,7 @@ namespace arc
 
         /**
          *  Retrieve a pointer to the leaf cell for a given position within the cell.
+         *  The root cell descends its flattened node array, other cells recurse through their children.
          *
          *  @param  t_pos   Position of the point.
          *
@@ -647,6 +654,12 @@ namespace arc
                 return (this);
             }
 
+            // If this cell holds the flattened tree, descend it iteratively.
+            if (!m_node.empty())
+            {
+                return (descend(0, t_pos));
+            }
+
             // Determine the child index.
             size_t child_index = 0;
             if (t_pos[X] < m_center[X])
@@ -665,6 +678,51 @@ namespace arc
             return (m_child[child_index]->get_leaf(t_pos));
         }
 
+        /**
+         *  Retrieve a pointer to the leaf cell a photon has stepped into after crossing a given face of a leaf cell.
+         *  The leaf's rope for that face gives the neighbouring node directly, and only the descent from the neighbour to
+         *  the leaf containing the position remains.
+         *  If the position has slipped out of the neighbouring node, such as when crossing close to an edge, the leaf is
+         *  found from the root instead.
+         *
+         *  @param  t_leaf  Leaf cell the photon has left.
+         *  @param  t_face  Face of the leaf cell which was crossed.
+         *  @param  t_pos   Position of the photon after crossing the face.
+         *
+         *  @pre    This cell must be the root cell.
+         *  @pre    t_leaf must be a leaf cell of this tree.
+         *  @pre    t_face must be less than six.
+         *
+         *  @return A pointer to the leaf cell containing the given position, or nullptr if the position has left the tree.
+         */
+        Cell* Cell::get_next_leaf(const Cell* const t_leaf, const size_t t_face, const math::Vec<3>& t_pos)
+        {
+            assert(!m_node.empty());
+            assert(t_leaf->m_leaf);
+            assert(t_face < 6);
+
+            // Check the position lies within the neighbouring node.
+            const size_t neighbour = m_leaf_rope[t_leaf->m_leaf_index][t_face];
+            if (neighbour != 0)
+            {
+                const Node& node = m_node[neighbour];
+                if ((std::fabs(t_pos[X] - node.center[X]) <= node.half_width[X]) &&
+                    (std::fabs(t_pos[Y] - node.center[Y]) <= node.half_width[Y]) &&
+                    (std::fabs(t_pos[Z] - node.center[Z]) <= node.half_width[Z]))
+                {
+                    return (descend(neighbour, t_pos));
+                }
+            }
+
+            // Otherwise, search from the root.
+            if (!is_within(t_pos))
+            {
+                return (nullptr);
+            }
+
+            return (descend(0, t_pos));
+        }
+
         /**
          *  Determine if a given point falls within the bounds of the cell.
          *
@@ -697,9 +755,9 @@ namespace arc
          *
          *  @post   r_dist must be positive.
          *
-         *  @return The distance to the wall of the cell from the given position travelling along the given direction.
+         *  @return A pair containing the distance to the wall of the cell along the given direction, and the face hit.
          */
-        double Cell::get_dist_to_wall(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const
+        std::pair<double, size_t> Cell::get_dist_to_wall(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const
         {
             assert(is_within(t_pos));
             assert(t_dir.is_normalised());
@@ -716,215 +774,152 @@ namespace arc
 
             // Determine the smallest positive distance.
             double            r_dist = std::numeric_limits<double>::max();
+            size_t            r_face = X_MIN;
             for (unsigned int i      = 0; i < 6; ++i)
             {
                 if ((dist[i] < r_dist) && (dist[i] > 0.0))
                 {
                     r_dist = dist[i];
+                    r_face = i;
                 }
             }
 
             assert(r_dist > 0.0);
 
-            return (r_dist);
+            return (std::pair<double, size_t>(r_dist, r_face));
         }
 
         /**
-         *  Determine the distance to the closest entity triangle within the cell.
-         *  If no entity is hit, the first value of the tuple will be set to false.
-         *  The second value of the returned tuple holds the distance to the entity triangle if one was hit.
-         *  The third and fourth values of the returned tuple hold the hit entity and triangle indices respectively.
-         *  If no entity triangle is hit the first value is false and the others are set to NaN.
+         *  Determine the closest surface triangle within the cell hit by a ray before a given distance.
+         *  Where two surfaces are hit at the same distance, the one listed first is returned.
+         *  Hits at, or beyond, the given maximum distance are ignored.
+         *  If no surface is hit the kind of the returned hit is none and its distance is the maximum distance.
          *
-         *  @param  t_pos       Start position of the ray.
-         *  @param  t_dir       Direction of the ray.
+         *  @param  t_pos   Start position of the ray.
+         *  @param  t_dir   Direction of the ray.
+         *  @param  t_max   Distance along the ray beyond which hits are ignored.
          *
-         *  @return A tuple containing, hit status, distance to intersection, collision entity and triangle indices.
+         *  @pre    t_dir must be normalised.
+         *  @pre    t_max must be positive.
+         *  @pre    Cell must be a leaf cell.
+         *
+         *  @return A record of the closest surface hit.
          */
-        std::tuple<bool, double, size_t, size_t> Cell::entity_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const
+        Cell::Hit Cell::surface_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, const double t_max) const
         {
             assert(t_dir.is_normalised());
+            assert(t_max > 0.0);
+            assert(m_leaf);
 
-            // If cell contains no entity triangles, there is no hit.
-            if (m_entity_tri_list.empty())
-            {
-                return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN()));
-            }
+            // Find the closest triangle of the batch.
+            size_t index;
+            double dist;
+            std::tie(index, dist) = m_surface_batch.intersection_dist(t_pos, t_dir, t_max);
 
-            // Run through all entity triangles and determine if any hits occur.
-            bool        hit            = false;
-            double      r_dist         = std::numeric_limits<double>::max();
-            size_t      r_entity_index = std::numeric_limits<size_t>::signaling_NaN();
-            size_t      r_tri_index    = std::numeric_limits<size_t>::signaling_NaN();
-            for (size_t i              = 0; i < m_entity_tri_list.size(); ++i)
+            // If nothing was hit, return an empty record.
+            if (index >= m_surface_list.size())
             {
-                // Get a reference to the triangle.
-                const geom::Triangle& tri = m_entity[m_entity_tri_list[i][0]].get_mesh().get_tri(m_entity_tri_list[i][1]);
-
-                // Determine if there is a hit.
-                bool   tri_hit;
-                double tri_dist;
-                std::tie(tri_hit, tri_dist) = tri.intersection_dist(t_pos, t_dir);
-
-                // If a hit does occur, and it is closer than any hit so far, store the information.
-                if (tri_hit && (tri_dist < r_dist))
-                {
-                    hit            = true;
-                    r_dist         = tri_dist;
-                    r_entity_index = m_entity_tri_list[i][0];
-                    r_tri_index    = m_entity_tri_list[i][1];
-                }
+                return (Hit({surface::NONE, 0, 0, t_max}));
             }
 
-            // If a hit did occur, return the information.
-            if (hit)
-            {
-                return (std::tuple<bool, double, size_t, size_t>(true, r_dist, r_entity_index, r_tri_index));
-            }
-
-            return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN()));
+            return (Hit({m_surface_list[index].kind, m_surface_list[index].owner, m_surface_list[index].tri, dist}));
         }
 
+
+        //  -- Setters --
         /**
-         *  Determine the distance to the closest ccd triangle within the cell.
-         *  If no ccd is hit, the first value of the tuple will be set to false.
-         *  The second value of the returned tuple holds the distance to the ccd triangle if one was hit.
-         *  The third and fourth values of the returned tuple hold the hit ccd and triangle indices respectively.
-         *  If no ccd triangle is hit the first value is false and the others are set to NaN.
+         *  Add a given energy to the total energy of the cell.
          *
-         *  @param  t_pos       Start position of the ray.
-         *  @param  t_dir       Direction of the ray.
+         *  @param  t_energy    Energy to add to the cell.
          *
-         *  @return A tuple containing, hit status, distance to intersection, collision ccd and triangle indices.
+         *  @pre    t_energy must be positive.
          */
-        std::tuple<bool, double, size_t, size_t> Cell::ccd_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const
+        void Cell::add_energy(const double t_energy)
         {
-            assert(t_dir.is_normalised());
+            assert(t_energy > 0.0);
 
-            // If cell contains no ccd triangles, there is no hit.
-            if (m_ccd_tri_list.empty())
-            {
-                return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN()));
-            }
+            m_energy += t_energy;
+        }
 
-            // Run through all ccd triangles and determine if any hits occur.
-            bool        hit         = false;
-            double      r_dist      = std::numeric_limits<double>::max();
-            size_t      r_ccd_index = std::numeric_limits<size_t>::signaling_NaN();
-            size_t      r_tri_index = std::numeric_limits<size_t>::signaling_NaN();
-            for (size_t i           = 0; i < m_ccd_tri_list.size(); ++i)
+        /**
+         *  Add the energies of a tally array, indexed by leaf index, to the leaf cells of this cell recursively.
+         *
+         *  @param  t_leaf_energy   Energy to add to each leaf cell, indexed by leaf index.
+         *
+         *  @pre    t_leaf_energy must be large enough to hold an entry for each leaf index.
+         */
+        void Cell::add_energy(const std::vector<double>& t_leaf_energy)
+        {
+            // If this cell is a leaf, add its tallied energy.
+            if (m_leaf)
             {
-                // Get a reference to the triangle.
-                const geom::Triangle& tri = m_ccd[m_ccd_tri_list[i][0]].get_mesh().get_tri(m_ccd_tri_list[i][1]);
+                assert(m_leaf_index < t_leaf_energy.size());
 
-                // Determine if there is a hit.
-                bool   tri_hit;
-                double tri_dist;
-                std::tie(tri_hit, tri_dist) = tri.intersection_dist(t_pos, t_dir);
-
-                // If a hit does occur, and it is closer than any hit so far, store the information.
-                if (tri_hit && (tri_dist < r_dist))
+                if (t_leaf_energy[m_leaf_index] > 0.0)
                 {
-                    hit         = true;
-                    r_dist      = tri_dist;
-                    r_ccd_index = m_ccd_tri_list[i][0];
-                    r_tri_index = m_ccd_tri_list[i][1];
+                    add_energy(t_leaf_energy[m_leaf_index]);
                 }
+
+                return;
             }
 
-            // If a hit did occur, return the information.
-            if (hit)
+            // Add energy to the child cells.
+            for (size_t i = 0; i < 8; ++i)
             {
-                return (std::tuple<bool, double, size_t, size_t>(true, r_dist, r_ccd_index, r_tri_index));
+                m_child[i]->add_energy(t_leaf_energy);
             }
-
-            return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN()));
         }
 
+
+        //  -- Lookup --
         /**
-         *  Determine the distance to the closest spectrometer triangle within the cell.
-         *  If no spectrometer is hit, the first value of the tuple will be set to false.
-         *  The second value of the returned tuple holds the distance to the spectrometer triangle if one was hit.
-         *  The third and fourth values of the returned tuple hold the hit spectrometer and triangle indices respectively.
-         *  If no spectrometer triangle is hit the first value is false and the others are set to NaN.
+         *  Descend the flattened node array from a given node to the leaf containing a given position.
+         *
+         *  @param  t_index Node array index of the node to descend from.
+         *  @param  t_pos   Position of the point.
          *
-         *  @param  t_pos       Start position of the ray.
-         *  @param  t_dir       Direction of the ray.
+         *  @pre    t_pos must be within the node.
          *
-         *  @return A tuple containing, hit status, distance to intersection, collision spectrometer and triangle indices.
+         *  @return A pointer to the leaf cell containing the given position.
          */
-        std::tuple<bool, double, size_t, size_t> Cell::spectrometer_dist(const math::Vec<3>& t_pos,
-                                                                         const math::Vec<3>& t_dir) const
+        Cell* Cell::descend(size_t t_index, const math::Vec<3>& t_pos) const
         {
-            assert(t_dir.is_normalised());
+            assert(t_index < m_node.size());
 
-            // If cell contains no spectrometer triangles, there is no hit.
-            if (m_spectrometer_tri_list.empty())
+            while (m_node[t_index].first_child != 0)
             {
-                return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN(),
-                                                                 std::numeric_limits<size_t>::signaling_NaN()));
-            }
+                const math::Vec<3>& center = m_node[t_index].center;
 
-            // Run through all spectrometer triangles and determine if any hits occur.
-            bool        hit                  = false;
-            double      r_dist               = std::numeric_limits<double>::max();
-            size_t      r_spectrometer_index = std::numeric_limits<size_t>::signaling_NaN();
-            size_t      r_tri_index          = std::numeric_limits<size_t>::signaling_NaN();
-            for (size_t i                    = 0; i < m_spectrometer_tri_list.size(); ++i)
-            {
-                // Get a reference to the triangle.
-                const geom::Triangle& tri = m_spectrometer[m_spectrometer_tri_list[i][0]].get_mesh().get_tri(
-                    m_spectrometer_tri_list[i][1]);
-
-                // Determine if there is a hit.
-                bool   tri_hit;
-                double tri_dist;
-                std::tie(tri_hit, tri_dist) = tri.intersection_dist(t_pos, t_dir);
-
-                // If a hit does occur, and it is closer than any hit so far, store the information.
-                if (tri_hit && (tri_dist < r_dist))
-                {
-                    hit                  = true;
-                    r_dist               = tri_dist;
-                    r_spectrometer_index = m_spectrometer_tri_list[i][0];
-                    r_tri_index          = m_spectrometer_tri_list[i][1];
-                }
+                t_index = m_node[t_index].first_child + static_cast<size_t>(t_pos[X] < center[X]) +
+                          (static_cast<size_t>(t_pos[Y] < center[Y]) << 1) + (static_cast<size_t>(t_pos[Z] < center[Z]) << 2);
             }
 
-            // If a hit did occur, return the information.
-            if (hit)
-            {
-                return (std::tuple<bool, double, size_t, size_t>(true, r_dist, r_spectrometer_index, r_tri_index));
-            }
-
-            return (std::tuple<bool, double, size_t, size_t>(false, std::numeric_limits<double>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN(),
-                                                             std::numeric_limits<size_t>::signaling_NaN()));
+            return (m_node[t_index].cell);
         }
 
 
-        //  -- Setters --
         /**
-         *  Add a given energy to the total energy of the cell.
+         *  Get the triangle referred to by an entry of one of the triangle lists.
          *
-         *  @param  t_energy    Energy to add to the cell.
+         *  @param  t_list  Kind of list the entry belongs to.
+         *  @param  t_entry Object and triangle indices of the entry.
          *
-         *  @pre    t_energy must be positive.
+         *  @return A reference to the triangle referred to by the entry.
          */
-        void Cell::add_energy(const double t_energy)
+        const geom::Triangle& Cell::get_list_tri(const size_t t_list, const std::array<size_t, 2>& t_entry) const
         {
-            assert(t_energy > 0.0);
-
-            m_energy += t_energy;
+            switch (t_list)
+            {
+                case ENTITY_LIST:
+                    return (m_entity[t_entry[OBJ]].get_mesh().get_tri(t_entry[TRI]));
+                case LIGHT_LIST:
+                    return (m_light[t_entry[OBJ]].get_mesh().get_tri(t_entry[TRI]));
+                case CCD_LIST:
+                    return (m_ccd[t_entry[OBJ]].get_mesh().get_tri(t_entry[TRI]));
+                case SPECTROMETER_LIST:
+                    return (m_spectrometer[t_entry[OBJ]].get_mesh().get_tri(t_entry[TRI]));
+                default: ERROR("Unable to get list triangle.", "List kind: '" << t_list << "' is invalid.");
+            }
         }
 
 
@@ -944,6 +939,48 @@ namespace arc
             const math::Vec<3> v1 = t_tri.get_pos(1) - m_center;
             const math::Vec<3> v2 = t_tri.get_pos(2) - m_center;
 
+            // Reject triangles whose bounding box misses the cell before testing the edge axes.
+            auto find_min_max = [](const double x0, const double x1, const double x2, double& min, double& max)
+            {
+                min = max = x0;
+
+                if (x1 < min)
+                {
+                    min = x1;
+                }
+                if (x1 > max)
+                {
+                    max = x1;
+                }
+                if (x2 < min)
+                {
+                    min = x2;
+                }
+                if (x2 > max)
+                {
+                    max = x2;
+                }
+            };
+
+            double min, max;
+            find_min_max(v0[X], v1[X], v2[X], min, max);
+            if ((min > m_half_width[X]) || (max < -m_half_width[X]))
+            {
+                return (false);
+            }
+
+            find_min_max(v0[Y], v1[Y], v2[Y], min, max);
+            if ((min > m_half_width[Y]) || (max < -m_half_width[Y]))
+            {
+                return (false);
+            }
+
+            find_min_max(v0[Z], v1[Z], v2[Z], min, max);
+            if ((min > m_half_width[Z]) || (max < -m_half_width[Z]))
+            {
+                return (false);
+            }
+
             // Compute triangle edges.
             const math::Vec<3> e0 = v1 - v0;
             const math::Vec<3> e1 = v2 - v1;
@@ -951,6 +988,8 @@ namespace arc
 
             double p0, p2, rad;
 
+            // Test the axes formed by crossing each triangle edge with each cell axis.
+
             p0  = (e0[Z] * v0[Y]) - (e0[Y] * v0[Z]);
             p2  = (e0[Z] * v2[Y]) - (e0[Y] * v2[Z]);
             rad = (std::fabs(e0[Z]) * m_half_width[Y]) + (std::fabs(e0[Y]) * m_half_width[Z]);
@@ -1023,49 +1062,135 @@ namespace arc
                 return (false);
             }
 
-            auto find_min_max = [](const double x0, const double x1, const double x2, double& min, double& max)
-            {
-                min = max = x0;
+            return (plane_overlap(e0 ^ e1, v0));
+        }
 
-                if (x1 < min)
-                {
-                    min = x1;
-                }
-                if (x1 > max)
-                {
-                    max = x1;
-                }
-                if (x2 < min)
-                {
-                    min = x2;
-                }
-                if (x2 > max)
-                {
-                    max = x2;
-                }
+#if defined(ENABLE_SIMD) && defined(__AVX2__)
+        /**
+         *  Determine which of a block of triangles are intersecting with the cell box using AVX2 instructions.
+         *  Operations are performed in the same order as tri_overlap so results match it exactly.
+         *  If the bounding box of every triangle misses the cell the remaining axes are not tested.
+         *
+         *  @param  t_tri   Block of triangles to test intersection with.
+         *
+         *  @return Mask with the bit of each triangle intersecting the cell set.
+         */
+        unsigned int Cell::tri_overlap_block(const std::array<const geom::Triangle*, OVERLAP_WIDTH>& t_tri) const
+        {
+            static_assert(OVERLAP_WIDTH == 4);
+
+            // Load the vertex positions, translated so the box center is at the origin.
+            auto load = [this, &t_tri](const size_t t_vert, const size_t t_dim)
+            {
+                return (_mm256_sub_pd(_mm256_set_pd(t_tri[3]->get_pos(t_vert)[t_dim], t_tri[2]->get_pos(t_vert)[t_dim],
+                                                    t_tri[1]->get_pos(t_vert)[t_dim], t_tri[0]->get_pos(t_vert)[t_dim]),
+                                      _mm256_set1_pd(m_center[t_dim])));
             };
+            const __m256d v0_x = load(0, X), v0_y = load(0, Y), v0_z = load(0, Z);
+            const __m256d v1_x = load(1, X), v1_y = load(1, Y), v1_z = load(1, Z);
+            const __m256d v2_x = load(2, X), v2_y = load(2, Y), v2_z = load(2, Z);
 
-            double min, max;
-            find_min_max(v0[X], v1[X], v2[X], min, max);
-            if ((min > m_half_width[X]) || (max < -m_half_width[X]))
+            const __m256d hw_x = _mm256_set1_pd(m_half_width[X]);
+            const __m256d hw_y = _mm256_set1_pd(m_half_width[Y]);
+            const __m256d hw_z = _mm256_set1_pd(m_half_width[Z]);
+            const __m256d sign = _mm256_set1_pd(-0.0);
+
+            // Reject triangles whose bounding box misses the cell.
+            auto miss_range = [sign](const __m256d t_min, const __m256d t_max, const __m256d t_rad)
             {
-                return (false);
+                return (_mm256_or_pd(_mm256_cmp_pd(t_min, t_rad, _CMP_GT_OQ),
+                                     _mm256_cmp_pd(t_max, _mm256_xor_pd(t_rad, sign), _CMP_LT_OQ)));
+            };
+            auto miss_bound = [&miss_range](const __m256d t_0, const __m256d t_1, const __m256d t_2, const __m256d t_rad)
+            {
+                return (miss_range(_mm256_min_pd(_mm256_min_pd(t_0, t_1), t_2), _mm256_max_pd(_mm256_max_pd(t_0, t_1), t_2),
+                                   t_rad));
+            };
+            __m256d miss = _mm256_or_pd(_mm256_or_pd(miss_bound(v0_x, v1_x, v2_x, hw_x), miss_bound(v0_y, v1_y, v2_y, hw_y)),
+                                        miss_bound(v0_z, v1_z, v2_z, hw_z));
+            if (_mm256_movemask_pd(miss) == 0xF)
+            {
+                return (0);
             }
 
-            find_min_max(v0[Y], v1[Y], v2[Y], min, max);
-            if ((min > m_half_width[Y]) || (max < -m_half_width[Y]))
+            // Compute triangle edges.
+            const __m256d e0_x = _mm256_sub_pd(v1_x, v0_x), e0_y = _mm256_sub_pd(v1_y, v0_y), e0_z = _mm256_sub_pd(v1_z, v0_z);
+            const __m256d e1_x = _mm256_sub_pd(v2_x, v1_x), e1_y = _mm256_sub_pd(v2_y, v1_y), e1_z = _mm256_sub_pd(v2_z, v1_z);
+            const __m256d e2_x = _mm256_sub_pd(v0_x, v2_x), e2_y = _mm256_sub_pd(v0_y, v2_y), e2_z = _mm256_sub_pd(v0_z, v2_z);
+
+            // Test an axis crossing an edge with a cell axis, onto which the points (t_a0, t_b0) and (t_a2, t_b2) project.
+            auto miss_axis = [sign, &miss_range](const __m256d t_a, const __m256d t_b, const __m256d t_a0, const __m256d t_b0,
+                                                 const __m256d t_a2, const __m256d t_b2, const __m256d t_hw_a,
+                                                 const __m256d t_hw_b)
             {
-                return (false);
-            }
+                const __m256d p0  = _mm256_sub_pd(_mm256_mul_pd(t_a, t_a0), _mm256_mul_pd(t_b, t_b0));
+                const __m256d p2  = _mm256_sub_pd(_mm256_mul_pd(t_a, t_a2), _mm256_mul_pd(t_b, t_b2));
+                const __m256d rad = _mm256_add_pd(_mm256_mul_pd(_mm256_andnot_pd(sign, t_a), t_hw_a),
+                                                  _mm256_mul_pd(_mm256_andnot_pd(sign, t_b), t_hw_b));
 
-            find_min_max(v0[Z], v1[Z], v2[Z], min, max);
-            if ((min > m_half_width[Z]) || (max < -m_half_width[Z]))
+                return (miss_range(_mm256_min_pd(p0, p2), _mm256_max_pd(p0, p2), rad));
+            };
+            miss = _mm256_or_pd(miss, miss_axis(e0_z, e0_y, v0_y, v0_z, v2_y, v2_z, hw_y, hw_z));
+            miss = _mm256_or_pd(miss, miss_axis(e0_x, e0_z, v0_z, v0_x, v2_z, v2_x, hw_z, hw_x));
+            miss = _mm256_or_pd(miss, miss_axis(e0_y, e0_x, v1_x, v1_y, v2_x, v2_y, hw_x, hw_y));
+            miss = _mm256_or_pd(miss, miss_axis(e1_z, e1_y, v0_y, v0_z, v2_y, v2_z, hw_y, hw_z));
+            miss = _mm256_or_pd(miss, miss_axis(e1_x, e1_z, v0_z, v0_x, v2_z, v2_x, hw_z, hw_x));
+            miss = _mm256_or_pd(miss, miss_axis(e1_y, e1_x, v0_x, v0_y, v1_x, v1_y, hw_x, hw_y));
+            miss = _mm256_or_pd(miss, miss_axis(e2_z, e2_y, v0_y, v0_z, v1_y, v1_z, hw_y, hw_z));
+            miss = _mm256_or_pd(miss, miss_axis(e2_x, e2_z, v0_z, v0_x, v1_z, v1_x, hw_z, hw_x));
+            miss = _mm256_or_pd(miss, miss_axis(e2_y, e2_x, v1_x, v1_y, v2_x, v2_y, hw_x, hw_y));
+
+            // Test the plane of the triangle, as in plane_overlap.
+            const __m256d n_x = _mm256_sub_pd(_mm256_mul_pd(e0_y, e1_z), _mm256_mul_pd(e0_z, e1_y));
+            const __m256d n_y = _mm256_sub_pd(_mm256_mul_pd(e0_z, e1_x), _mm256_mul_pd(e0_x, e1_z));
+            const __m256d n_z = _mm256_sub_pd(_mm256_mul_pd(e0_x, e1_y), _mm256_mul_pd(e0_y, e1_x));
+
+            const __m256d zero = _mm256_setzero_pd();
+            auto corner = [sign, zero](const __m256d t_n, const __m256d t_v, const __m256d t_hw, const bool t_max)
             {
-                return (false);
+                const __m256d low  = _mm256_sub_pd(_mm256_xor_pd(t_hw, sign), t_v);
+                const __m256d high = _mm256_sub_pd(t_hw, t_v);
+                const __m256d pos  = _mm256_cmp_pd(t_n, zero, _CMP_GT_OQ);
+
+                return (t_max ? _mm256_blendv_pd(low, high, pos) : _mm256_blendv_pd(high, low, pos));
+            };
+            auto dot = [t_n_x = n_x, t_n_y = n_y, t_n_z = n_z](const __m256d t_x, const __m256d t_y, const __m256d t_z)
+            {
+                return (_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(t_n_x, t_x), _mm256_mul_pd(t_n_y, t_y)),
+                                      _mm256_mul_pd(t_n_z, t_z)));
+            };
+            const __m256d min_dot = dot(corner(n_x, v0_x, hw_x, false), corner(n_y, v0_y, hw_y, false),
+                                        corner(n_z, v0_z, hw_z, false));
+            const __m256d max_dot = dot(corner(n_x, v0_x, hw_x, true), corner(n_y, v0_y, hw_y, true),
+                                        corner(n_z, v0_z, hw_z, true));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(min_dot, zero, _CMP_GT_OQ));
+            miss = _mm256_or_pd(miss, _mm256_cmp_pd(max_dot, zero, _CMP_LT_OQ));
+
+            return (static_cast<unsigned int>(~_mm256_movemask_pd(miss)) & 0xFu);
+        }
+#else
+        /**
+         *  Determine which of a block of triangles are intersecting with the cell box.
+         *
+         *  @param  t_tri   Block of triangles to test intersection with.
+         *
+         *  @return Mask with the bit of each triangle intersecting the cell set.
+         */
+        unsigned int Cell::tri_overlap_block(const std::array<const geom::Triangle*, OVERLAP_WIDTH>& t_tri) const
+        {
+            unsigned int r_overlap = 0;
+
+            for (size_t i = 0; i < OVERLAP_WIDTH; ++i)
+            {
+                if (tri_overlap(*t_tri[i]))
+                {
+                    r_overlap |= (1u << i);
+                }
             }
 
-            return (plane_overlap(e0 ^ e1, v0));
+            return (r_overlap);
         }
+#endif
 
         /**
          *  Determine if a plane described by a given normal and point overlaps with the box centered at the origin.
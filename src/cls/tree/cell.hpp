@@ -14,11 +14,18 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 //  -- Classes --
 #include "cls/detector/ccd.hpp"
 #include "cls/detector/spectrometer.hpp"
 #include "cls/equip/entity.hpp"
 #include "cls/equip/light.hpp"
+#include "cls/geom/batch.hpp"
 #include "cls/math/vec.hpp"
 
 
@@ -31,6 +38,15 @@ namespace arc
 
 
 
+        //  == SETTINGS ==
+        //  -- Building --
+        constexpr const size_t BUILD_TASK_MIN_TRI = 4096;   //! Minimum triangles within a cell for its children to be threaded.
+
+        //  -- Overlap --
+        constexpr const size_t OVERLAP_WIDTH = 4;   //! Number of triangles tested for overlap with a cell together.
+
+
+
         //  == CLASS ==
         /**
          *  Adaptive regular mesh tree forming octal cuboid cells.
@@ -38,6 +54,34 @@ namespace arc
         class Cell
         {
             //  == ENUMERATIONS ==
+            //  -- Faces --
+          public:
+            /**
+             *  Enumeration of the faces of a cell, ordered by axis and then by the minimum and maximum wall.
+             */
+            enum face
+            {
+                X_MIN,  //! Wall at the minimum x bound.
+                X_MAX,  //! Wall at the maximum x bound.
+                Y_MIN,  //! Wall at the minimum y bound.
+                Y_MAX,  //! Wall at the maximum y bound.
+                Z_MIN,  //! Wall at the minimum z bound.
+                Z_MAX   //! Wall at the maximum z bound.
+            };
+
+            //  -- Surfaces --
+          public:
+            /**
+             *  Enumeration of the kinds of surface a photon can hit within a leaf cell.
+             */
+            enum class surface
+            {
+                NONE,           //! No surface was hit.
+                ENTITY,         //! Entity triangle.
+                CCD,            //! Ccd triangle.
+                SPECTROMETER    //! Spectrometer triangle.
+            };
+
             //  -- Indices --
           private:
             /**
@@ -49,6 +93,97 @@ namespace arc
                 TRI     //! List triangle index.
             };
 
+            /**
+             *  Enumeration of the kinds of object triangle lists.
+             */
+            enum list_kind
+            {
+                ENTITY_LIST,        //! List of entity triangles.
+                LIGHT_LIST,         //! List of light triangles.
+                CCD_LIST,           //! List of ccd triangles.
+                SPECTROMETER_LIST,  //! List of spectrometer triangles.
+                NUM_LISTS           //! Number of kinds of list.
+            };
+
+
+            //  == STRUCTURES ==
+            //  -- Hits --
+          public:
+            /**
+             *  Record of the closest surface hit by a ray within a leaf cell.
+             */
+            struct Hit
+            {
+                surface kind;   //! Kind of surface hit, or none if nothing was hit.
+                size_t  owner;  //! Index of the object owning the hit triangle.
+                size_t  tri;    //! Index of the hit triangle within the owning object's mesh.
+                double  dist;   //! Distance to the hit, or the query's maximum distance if nothing was hit.
+            };
+
+            //  -- Surfaces --
+          private:
+            /**
+             *  Entry of the tagged surface list of a leaf cell.
+             */
+            struct Surface
+            {
+                surface kind;   //! Kind of surface.
+                size_t  owner;  //! Index of the object owning the triangle.
+                size_t  tri;    //! Index of the triangle within the owning object's mesh.
+            };
+
+            //  -- Building --
+          private:
+            /**
+             *  Lists of the object triangles overlapping a cell, for each kind of object.
+             */
+            using Lists = std::array<std::vector<std::array<size_t, 2>>, NUM_LISTS>;
+
+            /**
+             *  Working state of the thread building a branch of the tree.
+             *  Lists are only required while a cell and its children are built, so instead of each cell holding its own,
+             *  a cell filters its parent's lists into the buffer of its depth, which is reused by each of its later siblings.
+             *  Subtrees may be handed to other threads, each of which builds them with its own state.
+             */
+            struct Build
+            {
+                //  -- Settings --
+                const unsigned int min_depth;   //! Minimum depth for cells to split to.
+                const unsigned int max_depth;   //! Maximum depth for cells to split to.
+                const unsigned int max_tri;     //! Target maximum number of triangles to contain within leaf cells.
+
+                //  -- Threads --
+                const std::shared_ptr<std::atomic<unsigned int>> free_threads;  //! Number of threads free to build subtrees.
+
+                //  -- Lists --
+                std::vector<Lists> level;   //! Lists of the cell being built at each depth.
+
+                //  -- Constructors --
+                Build(const unsigned int t_min_depth, const unsigned int t_max_depth, const unsigned int t_max_tri,
+                      std::shared_ptr<std::atomic<unsigned int>> t_free_threads) :
+                    min_depth(t_min_depth),
+                    max_depth(t_max_depth),
+                    max_tri(t_max_tri),
+                    free_threads(std::move(t_free_threads)),
+                    level(t_max_depth + 1)
+                {
+                }
+            };
+
+            //  -- Nodes --
+          private:
+            /**
+             *  Entry of the flattened node array held by the root cell.
+             *  Children of a node are stored contiguously in child index order, which is the order of their Morton digit.
+             */
+            struct Node
+            {
+                math::Vec<3> center;        //! Center of the cell.
+                math::Vec<3> half_width;    //! Half width of the cell.
+                size_t       first_child;   //! Node array index of the first child, or zero if the cell is a leaf.
+                Cell*        cell;          //! Pointer to the cell described by the node.
+            };
+
 
             //  == FIELDS ==
           private:
@@ -62,15 +197,17 @@ namespace arc
             const std::vector<detector::Ccd>         & m_ccd;           //! Reference to vector of sim ccds.
             const std::vector<detector::Spectrometer>& m_spectrometer;  //! Reference to vector of sim spectrometers.
 
-            //  -- Lists --
-            const std::vector<std::array<size_t, 2>> m_entity_tri_list;         //! List of entity triangles inside cell.
-            const std::vector<std::array<size_t, 2>> m_light_tri_list;          //! List of light triangles inside cell.
-            const std::vector<std::array<size_t, 2>> m_ccd_tri_list;            //! List of ccd triangles inside cell.
-            const std::vector<std::array<size_t, 2>> m_spectrometer_tri_list;   //! List of spectrometer triangles inside cell.
+            //  -- Triangles --
+            const size_t m_num_tri; //! Number of object triangles overlapping the cell.
 
             //  -- Depth Data --
             const unsigned int m_depth; //! Depth of the cell within the tree.
             const bool         m_leaf;  //! True if the cell is a terminal cell.
+            size_t             m_leaf_index = 0;    //! Dense index of the cell amongst all leaf cells of the tree.
+
+            //  -- Surfaces --
+            const std::vector<Surface> m_surface_list;  //! Tagged list of surface triangles inside a leaf cell.
+            const geom::Batch          m_surface_batch; //! Batch of the listed surface triangles inside a leaf cell.
 
             //  -- Children --
             const std::array<std::unique_ptr<Cell>, 8> m_child; //! Array of child cell pointers.
@@ -78,6 +215,10 @@ namespace arc
             //  -- Data --
             double m_energy = 0.0;  //! Total energy within the cell.
 
+            //  -- Lookup --
+            std::vector<Node>                  m_node;      //! Breadth-first array of all tree nodes, only held by the root.
+            std::vector<std::array<size_t, 6>> m_leaf_rope; //! Node index of the neighbour of each leaf across each face.
+
 
             //  == INSTANTIATION ==
           public:
@@ -85,33 +226,31 @@ namespace arc
             Cell(unsigned int t_min_depth, unsigned int t_max_depth, unsigned int t_max_tri, const math::Vec<3>& t_min_bound,
                  const math::Vec<3>& t_max_bound, const std::vector<equip::Entity>& t_entity,
                  const std::vector<equip::Light>& t_light, const std::vector<detector::Ccd>& t_ccd,
-                 const std::vector<detector::Spectrometer>& t_spectrometer);
-            Cell(unsigned int t_depth, unsigned int t_min_depth, unsigned int t_max_depth, unsigned int t_max_tri,
-                 const math::Vec<3>& t_center, const math::Vec<3>& t_half_width, const std::vector<equip::Entity>& t_entity,
-                 const std::vector<equip::Light>& t_light, const std::vector<detector::Ccd>& t_ccd,
-                 const std::vector<detector::Spectrometer>& t_spectrometer,
-                 const std::vector<std::array<size_t, 2>>& t_entity_tri_list,
-                 const std::vector<std::array<size_t, 2>>& t_light_tri_list,
-                 const std::vector<std::array<size_t, 2>>& t_ccd_tri_list,
-                 const std::vector<std::array<size_t, 2>>& t_spectrometer_tri_list);
+                 const std::vector<detector::Spectrometer>& t_spectrometer, unsigned int t_num_threads = 1);
 
           private:
+            //  -- Constructors --
+            Cell(unsigned int t_depth, const math::Vec<3>& t_center, const math::Vec<3>& t_half_width,
+                 const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                 const std::vector<detector::Ccd>& t_ccd, const std::vector<detector::Spectrometer>& t_spectrometer,
+                 const Lists& t_parent_list, Build&& t_build);
+            Cell(unsigned int t_depth, const math::Vec<3>& t_center, const math::Vec<3>& t_half_width,
+                 const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                 const std::vector<detector::Ccd>& t_ccd, const std::vector<detector::Spectrometer>& t_spectrometer,
+                 const Lists& t_parent_list, Build& t_build);
+
             //  -- Initialisation --
-            std::vector<std::array<size_t, 2>> init_entity_tri_list() const;
-            std::vector<std::array<size_t, 2>> init_entity_tri_list(
-                const std::vector<std::array<size_t, 2>>& t_entity_tri_list) const;
-            std::vector<std::array<size_t, 2>> init_light_tri_list() const;
-            std::vector<std::array<size_t, 2>> init_light_tri_list(
-                const std::vector<std::array<size_t, 2>>& t_light_tri_list) const;
-            std::vector<std::array<size_t, 2>> init_ccd_tri_list() const;
-            std::vector<std::array<size_t, 2>> init_ccd_tri_list(
-                const std::vector<std::array<size_t, 2>>& t_ccd_tri_list) const;
-            std::vector<std::array<size_t, 2>> init_spectrometer_tri_list() const;
-            std::vector<std::array<size_t, 2>> init_spectrometer_tri_list(
-                const std::vector<std::array<size_t, 2>>& t_light_spectrometer_list) const;
-            bool init_leaf(unsigned int t_min_depth, unsigned int t_max_depth, unsigned int t_max_tri) const;
-            std::array<std::unique_ptr<Cell>, 8> init_child(unsigned int t_min_depth, unsigned int t_max_depth,
-                                                            unsigned int t_max_tri) const;
+            static Lists init_root_list(const std::vector<equip::Entity>& t_entity, const std::vector<equip::Light>& t_light,
+                                        const std::vector<detector::Ccd>& t_ccd,
+                                        const std::vector<detector::Spectrometer>& t_spectrometer);
+            size_t init_list(const Lists& t_parent_list, Lists& t_list) const;
+            bool init_leaf(const Build& t_build) const;
+            std::vector<Surface> init_surface_list(const Lists& t_list) const;
+            geom::Batch init_surface_batch() const;
+            std::array<std::unique_ptr<Cell>, 8> init_child(Build& t_build) const;
+            void init_leaf_index(size_t& t_num_leaves);
+            std::vector<Node> init_node();
+            std::vector<std::array<size_t, 6>> init_leaf_rope() const;
 
 
             //  == METHODS ==
@@ -119,27 +258,37 @@ namespace arc
             //  -- Getters --
             double get_vol() const { return ((m_half_width[X] * 2.0) * (m_half_width[Y] * 2.0) * (m_half_width[Z] * 2.0)); }
             double get_energy_density() const;
-            std::vector<std::vector<std::vector<double>>> get_data_cube(size_t t_depth) const;
+            unsigned int get_depth() const { return (m_depth); }
+            const math::Vec<3>& get_center() const { return (m_center); }
+            const math::Vec<3>& get_half_width() const { return (m_half_width); }
             bool is_leaf() const { return (m_leaf); }
             const std::unique_ptr<Cell>& get_child(const size_t t_index) const { return (m_child[t_index]); }
             unsigned long int get_total_cells() const;
+            size_t get_total_leaves() const;
+            size_t get_leaf_index() const { return (m_leaf_index); }
             size_t get_max_tri() const;
             Cell* get_leaf(const math::Vec<3>& t_pos);
+            Cell* get_next_leaf(const Cell* t_leaf, size_t t_face, const math::Vec<3>& t_pos);
             bool is_within(const math::Vec<3>& t_pos) const;
             math::Vec<3> get_min_bound() const { return (m_center - m_half_width); }
             math::Vec<3> get_max_bound() const { return (m_center + m_half_width); }
-            double get_dist_to_wall(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const;
-            std::tuple<bool, double, size_t, size_t> entity_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const;
-            std::tuple<bool, double, size_t, size_t> ccd_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const;
-            std::tuple<bool, double, size_t, size_t> spectrometer_dist(const math::Vec<3>& t_pos,
-                                                                       const math::Vec<3>& t_dir) const;
+            std::pair<double, size_t> get_dist_to_wall(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir) const;
+            Hit surface_dist(const math::Vec<3>& t_pos, const math::Vec<3>& t_dir, double t_max) const;
 
             //  -- Setters --
             void add_energy(double t_energy);
+            void add_energy(const std::vector<double>& t_leaf_energy);
 
-          private:
             //  -- Overlap Test --
             bool tri_overlap(const geom::Triangle& t_tri) const;
+            unsigned int tri_overlap_block(const std::array<const geom::Triangle*, OVERLAP_WIDTH>& t_tri) const;
+
+          private:
+            //  -- Lookup --
+            Cell* descend(size_t t_index, const math::Vec<3>& t_pos) const;
+            const geom::Triangle& get_list_tri(size_t t_list, const std::array<size_t, 2>& t_entry) const;
+
+            //  -- Overlap Test --
             bool plane_overlap(const math::Vec<3>& t_norm, const math::Vec<3>& t_point) const;
         };
 
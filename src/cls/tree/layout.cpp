@@ -0,0 +1,405 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == HEADER ==
+#include "cls/tree/layout.hpp"
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+//  -- General --
+#include "gen/enum.hpp"
+#include "gen/log.hpp"
+
+//  -- Utility --
+#include "utl/stream.hpp"
+
+//  -- Classes --
+#include "cls/tree/cell.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace tree
+    {
+
+
+
+        //  == INSTANTIATION ==
+        //  -- Constructors --
+        /**
+         *  Construct an empty layout, holding no leaf cells, to be read into.
+         */
+        Layout::Layout() :
+            m_center(0.0, 0.0, 0.0),
+            m_half_width(0.0, 0.0, 0.0)
+        {
+        }
+
+        /**
+         *  Construct the layout of the leaf cells of a given tree.
+         *
+         *  @param  t_root  Root cell of the tree.
+         */
+        Layout::Layout(const Cell& t_root) :
+            m_center(t_root.get_center()),
+            m_half_width(t_root.get_half_width())
+        {
+            assert(t_root.get_depth() == 0);
+
+            init_depth(t_root);
+            m_vol = init_vol();
+        }
+
+
+        //  -- Initialisation --
+        /**
+         *  Recursively list the depth of the leaf cells of a given cell, in leaf index order.
+         *
+         *  @param  t_cell  Cell to list the leaf cells of.
+         */
+        void Layout::init_depth(const Cell& t_cell)
+        {
+            if (t_cell.is_leaf())
+            {
+                m_depth.push_back(t_cell.get_depth());
+
+                return;
+            }
+
+            for (size_t i = 0; i < 8; ++i)
+            {
+                init_depth(*t_cell.get_child(i));
+            }
+        }
+
+        /**
+         *  Initialise the volume of a cell at each depth down to the deepest leaf.
+         *  Half widths are halved exactly as when the tree was built, so the volumes match those of the tree's cells.
+         *
+         *  @return The volume of a cell at each depth.
+         */
+        std::vector<double> Layout::init_vol() const
+        {
+            const unsigned int max_depth = m_depth.empty() ? 0 : *std::max_element(m_depth.begin(), m_depth.end());
+
+            std::vector<double> r_vol;
+            math::Vec<3>        half_width = m_half_width;
+            for (unsigned int i = 0; i <= max_depth; ++i)
+            {
+                r_vol.push_back((half_width[X] * 2.0) * (half_width[Y] * 2.0) * (half_width[Z] * 2.0));
+
+                half_width = half_width / 2.0;
+            }
+
+            return (r_vol);
+        }
+
+
+
+        //  == OPERATORS ==
+        //  -- Comparison --
+        /**
+         *  Determine if two layouts describe the same tree.
+         *
+         *  @param  t_rhs   Layout to compare with.
+         *
+         *  @return True if the root bounds and leaf depths of the layouts are identical.
+         */
+        bool Layout::operator==(const Layout& t_rhs) const
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if ((m_center[i] != t_rhs.m_center[i]) || (m_half_width[i] != t_rhs.m_half_width[i]))
+                {
+                    return (false);
+                }
+            }
+
+            return (m_depth == t_rhs.m_depth);
+        }
+
+
+
+        //  == METHODS ==
+        //  -- Getters --
+        /**
+         *  Form a data cube of the energy density of the tree to a given depth resolution.
+         *  The cube is split between the cells a few levels down, which are rasterised straight into it by the given
+         *  number of threads.
+         *  Voxel indices increase with each spatial coordinate.
+         *
+         *  @param  t_leaf_energy   Energy tallied by each leaf cell, by leaf index.
+         *  @param  t_depth         Depth resolution of the data cube.
+         *  @param  t_num_threads   Number of threads to rasterise the tree with.
+         *
+         *  @pre    t_leaf_energy must hold an entry for each leaf cell.
+         *  @pre    t_num_threads must be positive.
+         *
+         *  @return A data cube of the energy density of the tree.
+         */
+        data::Cube Layout::get_data_cube(const std::vector<double>& t_leaf_energy, const size_t t_depth,
+                                         const unsigned int t_num_threads) const
+        {
+            assert(t_leaf_energy.size() == m_depth.size());
+            assert(!m_depth.empty());
+            assert(t_num_threads > 0);
+
+            // Create the return data cube.
+            data::Cube r_data_cube(static_cast<size_t>(1) << t_depth);
+
+            // List the cells, each of which fills its own region of the cube.
+            std::vector<Task> task;
+            size_t            leaf = 0;
+            add_raster_task(leaf, 0, std::min(t_depth, RASTER_TASK_DEPTH), t_depth, {{0, 0, 0}}, task);
+
+            // Hand out the cells to each thread in turn.
+            std::atomic<size_t> next_task(0);
+            auto run_tasks = [this, &task, &next_task, &t_leaf_energy, &r_data_cube, t_depth]()
+            {
+                for (size_t i = next_task++; i < task.size(); i = next_task++)
+                {
+                    size_t task_leaf = task[i].leaf;
+                    rasterise(task_leaf, task[i].depth, t_depth, task[i].origin, t_leaf_energy, r_data_cube);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < std::min(static_cast<size_t>(t_num_threads), task.size()); ++i)
+            {
+                threads.emplace_back(run_tasks);
+            }
+            run_tasks();
+
+            for (size_t i = 0; i < threads.size(); ++i)
+            {
+                threads[i].join();
+            }
+
+            return (r_data_cube);
+        }
+
+
+        //  -- Serialisation --
+        /**
+         *  Write the root bounds and leaf depths of the layout to a stream.
+         *
+         *  @param  t_stream    Stream to write to.
+         */
+        void Layout::write_binary(std::ostream& t_stream) const
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                utl::write_binary(t_stream, m_center[i]);
+                utl::write_binary(t_stream, m_half_width[i]);
+            }
+            utl::write_binary(t_stream, m_depth);
+        }
+
+        /**
+         *  Read the root bounds and leaf depths of a layout from a stream written by write_binary.
+         *  The leaf depths are checked to form a complete tree, so a layout read may always be rasterised.
+         *
+         *  @param  t_stream    Stream to read from.
+         */
+        void Layout::read_binary(std::istream& t_stream)
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                utl::read_binary(t_stream, m_center[i]);
+                utl::read_binary(t_stream, m_half_width[i]);
+            }
+            utl::read_binary(t_stream, m_depth);
+
+            if (!t_stream)
+            {
+                ERROR("Unable to read tree layout.", "Stored layout is incomplete.");
+            }
+
+            // Check the depths are shallow enough to rasterise, and form a complete tree.
+            for (size_t i = 0; i < m_depth.size(); ++i)
+            {
+                if (m_depth[i] >= static_cast<unsigned int>(std::numeric_limits<size_t>::digits))
+                {
+                    ERROR("Unable to read tree layout.", "Stored leaf depth: '" << m_depth[i] << "' is too deep.");
+                }
+            }
+            size_t leaf = 0;
+            if (!skip_cell(leaf, 0) || (leaf != m_depth.size()))
+            {
+                ERROR("Unable to read tree layout.", "Stored leaf depths do not form a complete tree.");
+            }
+
+            m_vol = init_vol();
+        }
+
+
+        //  -- Traversal --
+        /**
+         *  Move past the leaf cells of the cell at a given depth which begins with a given leaf.
+         *
+         *  @param  t_leaf  Leaf index of the first leaf of the cell, set to that of the first leaf beyond the cell.
+         *  @param  t_depth Depth of the cell.
+         *
+         *  @return False if the leaf depths do not form a complete cell.
+         */
+        bool Layout::skip_cell(size_t& t_leaf, const unsigned int t_depth) const
+        {
+            if ((t_leaf >= m_depth.size()) || (m_depth[t_leaf] < t_depth))
+            {
+                return (false);
+            }
+
+            if (m_depth[t_leaf] == t_depth)
+            {
+                ++t_leaf;
+
+                return (true);
+            }
+
+            for (size_t i = 0; i < 8; ++i)
+            {
+                if (!skip_cell(t_leaf, t_depth + 1))
+                {
+                    return (false);
+                }
+            }
+
+            return (true);
+        }
+
+
+        //  -- Rasterising --
+        /**
+         *  Determine the first voxel of a child cell within a data cube.
+         *  Children on the negative side of an axis, marked by their index bit for that axis, lie in the lower half.
+         *
+         *  @param  t_index     Index of the child cell.
+         *  @param  t_origin    First voxel of the parent cell.
+         *  @param  t_half_res  Number of voxels along each side of the child cell.
+         *
+         *  @return The first voxel of the child cell.
+         */
+        std::array<size_t, 3> Layout::get_child_origin(const size_t t_index, const std::array<size_t, 3>& t_origin,
+                                                       const size_t t_half_res)
+        {
+            return (std::array<size_t, 3>({{t_origin[X] + (((t_index & 1) == 0) ? t_half_res : 0),
+                                            t_origin[Y] + (((t_index & 2) == 0) ? t_half_res : 0),
+                                            t_origin[Z] + (((t_index & 4) == 0) ? t_half_res : 0)}}));
+        }
+
+        /**
+         *  Recursively list the cells at a given task depth, or the leaves above it, to rasterise separately.
+         *
+         *  @param  t_leaf          Leaf index of the first leaf of the cell, set to that of the first leaf beyond it.
+         *  @param  t_cell_depth    Depth of the cell.
+         *  @param  t_task_depth    Depth of the cells to list.
+         *  @param  t_depth         Depth resolution of the data cube.
+         *  @param  t_origin        First voxel of the cell.
+         *  @param  t_task          List to append the cells to.
+         */
+        void Layout::add_raster_task(size_t& t_leaf, const unsigned int t_cell_depth, const size_t t_task_depth,
+                                     const size_t t_depth, const std::array<size_t, 3>& t_origin,
+                                     std::vector<Task>& t_task) const
+        {
+            if ((m_depth[t_leaf] == t_cell_depth) || (t_cell_depth >= t_task_depth))
+            {
+                t_task.push_back({t_leaf, t_cell_depth, t_origin});
+                skip_cell(t_leaf, t_cell_depth);
+
+                return;
+            }
+
+            const size_t half_res = static_cast<size_t>(1) << (t_depth - t_cell_depth - 1);
+            for (size_t i = 0; i < 8; ++i)
+            {
+                add_raster_task(t_leaf, t_cell_depth + 1, t_task_depth, t_depth, get_child_origin(i, t_origin, half_res),
+                                t_task);
+            }
+        }
+
+        /**
+         *  Determine the energy density of a cell, moving past its leaf cells.
+         *  If the cell is not a leaf cell, the energy density returned is the average energy density of the child cells.
+         *
+         *  @param  t_leaf          Leaf index of the first leaf of the cell, set to that of the first leaf beyond it.
+         *  @param  t_cell_depth    Depth of the cell.
+         *  @param  t_leaf_energy   Energy tallied by each leaf cell, by leaf index.
+         *
+         *  @return The average energy density of the cell.
+         */
+        double Layout::get_energy_density(size_t& t_leaf, const unsigned int t_cell_depth,
+                                          const std::vector<double>& t_leaf_energy) const
+        {
+            // If this cell is a leaf cell, return its energy density.
+            if (m_depth[t_leaf] == t_cell_depth)
+            {
+                const double energy_density = t_leaf_energy[t_leaf] / m_vol[t_cell_depth];
+                ++t_leaf;
+
+                return (energy_density);
+            }
+
+            // If this cell is a parent, calculate the average energy density of its child cells.
+            double total_energy_density = 0.0;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                total_energy_density += get_energy_density(t_leaf, t_cell_depth + 1, t_leaf_energy);
+            }
+
+            return (total_energy_density / 8.0);
+        }
+
+        /**
+         *  Recursively write the energy density of a cell into its region of a data cube, moving past its leaf cells.
+         *  Leaf cells, and cells at the depth resolution of the cube, fill their region uniformly.
+         *
+         *  @param  t_leaf          Leaf index of the first leaf of the cell, set to that of the first leaf beyond it.
+         *  @param  t_cell_depth    Depth of the cell.
+         *  @param  t_depth         Depth resolution of the data cube.
+         *  @param  t_origin        First voxel of the cell.
+         *  @param  t_leaf_energy   Energy tallied by each leaf cell, by leaf index.
+         *  @param  t_cube          Data cube to write to.
+         *
+         *  @pre    t_depth must be greater than, or equal to, the cell depth.
+         */
+        void Layout::rasterise(size_t& t_leaf, const unsigned int t_cell_depth, const size_t t_depth,
+                               const std::array<size_t, 3>& t_origin, const std::vector<double>& t_leaf_energy,
+                               data::Cube& t_cube) const
+        {
+            assert(t_depth >= t_cell_depth);
+
+            const size_t res = static_cast<size_t>(1) << (t_depth - t_cell_depth);
+
+            if ((m_depth[t_leaf] == t_cell_depth) || (t_depth == t_cell_depth))
+            {
+                t_cube.fill(t_origin[X], t_origin[Y], t_origin[Z], res,
+                            get_energy_density(t_leaf, t_cell_depth, t_leaf_energy));
+
+                return;
+            }
+
+            for (size_t i = 0; i < 8; ++i)
+            {
+                rasterise(t_leaf, t_cell_depth + 1, t_depth, get_child_origin(i, t_origin, res / 2), t_leaf_energy, t_cube);
+            }
+        }
+
+
+
+    } // namespace tree
+} // namespace arc
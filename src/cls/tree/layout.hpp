@@ -0,0 +1,136 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == GUARD ==
+#ifndef ARCTORUS_SRC_CLS_TREE_LAYOUT_HPP
+#define ARCTORUS_SRC_CLS_TREE_LAYOUT_HPP
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+//  -- Classes --
+#include "cls/data/cube.hpp"
+#include "cls/math/vec.hpp"
+
+
+
+//  == NAMESPACE ==
+namespace arc
+{
+    namespace tree
+    {
+
+
+
+        //  == DECLARATIONS ==
+        //  -- Classes --
+        class Cell;
+
+
+
+        //  == SETTINGS ==
+        //  -- Rasterising --
+        constexpr const size_t RASTER_TASK_DEPTH = 3;   //! Depth below the root at which the data cube is split into tasks.
+
+
+
+        //  == CLASS ==
+        /**
+         *  Geometry of the leaf cells of a tree, without any of the equipment the tree was built around.
+         *  Every cell is split exactly in half along each axis, so the bounds of each leaf follow from the root bounds and
+         *  the depth of each leaf, listed in leaf index order.
+         *  Leaf energies tallied by leaf index may then be rasterised without the tree itself.
+         */
+        class Layout
+        {
+            //  == STRUCTURES ==
+            //  -- Rasterising --
+            /**
+             *  Cell of the tree whose region of the data cube is rasterised as a single task.
+             */
+            struct Task
+            {
+                size_t                leaf;     //! Leaf index of the first leaf within the cell.
+                unsigned int          depth;    //! Depth of the cell within the tree.
+                std::array<size_t, 3> origin;   //! First voxel of the cell.
+            };
+
+
+            //  == FIELDS ==
+          private:
+            //  -- Bounds --
+            math::Vec<3> m_center;      //! Center of the root cell.
+            math::Vec<3> m_half_width;  //! Half width of the root cell.
+
+            //  -- Leaves --
+            std::vector<unsigned int> m_depth;  //! Depth of each leaf cell, by leaf index.
+            std::vector<double>       m_vol;    //! Volume of a cell at each depth.
+
+
+            //  == INSTANTIATION ==
+          public:
+            //  -- Constructors --
+            Layout();
+            explicit Layout(const Cell& t_root);
+
+          private:
+            //  -- Initialisation --
+            void init_depth(const Cell& t_cell);
+            std::vector<double> init_vol() const;
+
+
+            //  == OPERATORS ==
+          public:
+            //  -- Comparison --
+            bool operator==(const Layout& t_rhs) const;
+
+
+            //  == METHODS ==
+          public:
+            //  -- Getters --
+            size_t get_total_leaves() const { return (m_depth.size()); }
+            math::Vec<3> get_min_bound() const { return (m_center - m_half_width); }
+            math::Vec<3> get_max_bound() const { return (m_center + m_half_width); }
+            data::Cube get_data_cube(const std::vector<double>& t_leaf_energy, size_t t_depth,
+                                     unsigned int t_num_threads = 1) const;
+
+            //  -- Serialisation --
+            void write_binary(std::ostream& t_stream) const;
+            void read_binary(std::istream& t_stream);
+
+          private:
+            //  -- Traversal --
+            bool skip_cell(size_t& t_leaf, unsigned int t_depth) const;
+
+            //  -- Rasterising --
+            static std::array<size_t, 3> get_child_origin(size_t t_index, const std::array<size_t, 3>& t_origin,
+                                                          size_t t_half_res);
+            void add_raster_task(size_t& t_leaf, unsigned int t_cell_depth, size_t t_task_depth, size_t t_depth,
+                                 const std::array<size_t, 3>& t_origin, std::vector<Task>& t_task) const;
+            double get_energy_density(size_t& t_leaf, unsigned int t_cell_depth,
+                                      const std::vector<double>& t_leaf_energy) const;
+            void rasterise(size_t& t_leaf, unsigned int t_cell_depth, size_t t_depth, const std::array<size_t, 3>& t_origin,
+                           const std::vector<double>& t_leaf_energy, data::Cube& t_cube) const;
+        };
+
+
+
+    } // namespace tree
+} // namespace arc
+
+
+
+//  == GUARD END ==
+#endif // ARCTORUS_SRC_CLS_TREE_LAYOUT_HPP
@@ -13,6 +13,9 @@
 
 
 //  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+
 //  -- General --
 #include "gen/math.hpp"
 
@@ -31,18 +34,51 @@ namespace arc
         /**
          *  Generate a random double drawn from the henyey-greenstein distribution.
          *
-         *  @param  t_g Anisotropy value.
+         *  @param  t_g     Anisotropy value.
+         *  @param  t_rng   Random number generator to draw from.
          *
          *  @pre    t_g must be between -1.0 and 1.0.
          *
          *  @return The value drawn from the henyey-greenstein phase function.
          */
-        double henyey_greenstein(const double t_g)
+        double henyey_greenstein(const double t_g, random::Generator& t_rng)
         {
             assert((t_g >= -1.0) && (t_g <= 1.0));
 
-            return (t_g == 0.0) ? rng::random(0.0, M_PI) : acos((1.0 + math::square(t_g) - math::square(
-                (1.0 - math::square(t_g)) / (1.0 - t_g + (2.0 * t_g * rng::random())))) / (2.0 * t_g));
+            return (t_g == 0.0) ? t_rng.gen_value(0.0, M_PI) : acos((1.0 + math::square(t_g) - math::square(
+                (1.0 - math::square(t_g)) / (1.0 - t_g + (2.0 * t_g * t_rng.gen_value())))) / (2.0 * t_g));
+        }
+
+        /**
+         *  Generate the cosine of a scattering angle drawn from the henyey-greenstein distribution.
+         *  The cosine is sampled directly from precomputed anisotropy constants without any trigonometric calls.
+         *  Isotropic scattering draws the cosine uniformly, which is uniform over the sphere.
+         *
+         *  @param  t_g         Anisotropy value.
+         *  @param  t_sum       Precomputed value of one plus the anisotropy squared.
+         *  @param  t_diff      Precomputed value of one minus the anisotropy squared.
+         *  @param  t_inv_2g    Precomputed reciprocal of twice the anisotropy, unused when isotropic.
+         *  @param  t_rng       Random number generator to draw from.
+         *
+         *  @pre    t_g must be between -1.0 and 1.0.
+         *
+         *  @post   r_cos must be between -1.0 and 1.0.
+         *
+         *  @return The cosine of the angle drawn from the henyey-greenstein phase function.
+         */
+        double henyey_greenstein_cos(const double t_g, const double t_sum, const double t_diff, const double t_inv_2g,
+                                     random::Generator& t_rng)
+        {
+            assert((t_g >= -1.0) && (t_g <= 1.0));
+
+            if (t_g == 0.0)
+            {
+                return (t_rng.gen_value(-1.0, 1.0));
+            }
+
+            const double r_cos = (t_sum - math::square(t_diff / (1.0 - t_g + (2.0 * t_g * t_rng.gen_value())))) * t_inv_2g;
+
+            return (std::max(-1.0, std::min(1.0, r_cos)));
         }
 
         /**
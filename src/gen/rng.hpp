@@ -19,6 +19,7 @@
 #include <ctime>
 
 //  -- Classes --
+#include "cls/random/generator.hpp"
 #include "cls/random/uniform.hpp"
 
 
@@ -37,7 +38,8 @@ namespace arc
 
         //  -- Generation --
         inline double random(double t_min = 0.0, double t_max = 1.0);
-        double henyey_greenstein(double t_g);
+        double henyey_greenstein(double t_g, random::Generator& t_rng);
+        double henyey_greenstein_cos(double t_g, double t_sum, double t_diff, double t_inv_2g, random::Generator& t_rng);
         double gaussian(double t_mu = 0.0, double t_sigma = 1.0);
 
 
@@ -10,6 +10,9 @@
 //  == INCLUDES ==
 //  -- System --
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <thread>
 #include <unistd.h>
 
@@ -29,12 +32,13 @@
 //  == FUNCTION PROTOTYPES ==
 //  -- File --
 arc::data::Json read_setup_file(int t_argc, const char** t_argv);
+std::vector<std::string> read_option(int t_argc, const char** t_argv, const std::string& t_flag, size_t t_num_values);
+unsigned long int read_option_value(const std::string& t_flag, const std::string& t_value);
 std::string create_output_dir(const std::string& t_dir_name);
 void save_run_info(const std::string& t_output_dir);
 
 //  -- Simulation --
-void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim);
-void save_data(const arc::data::Json& t_setup, const arc::setup::Sim& t_sim, const std::string& t_output_dir);
+void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim, const std::string& t_output_dir);
 
 
 
@@ -45,17 +49,45 @@ void save_data(const arc::data::Json& t_setup, const arc::setup::Sim& t_sim, con
  *  @param  t_argc  Command line argument count.
  *  @param  t_argv  Command line argument vector.
  *
- *  @return Zero upon a successful run.
+ *  @return Zero upon a successful run, or one if the shard tallies could not be saved.
  */
 int main(const int t_argc, const char** t_argv)
 {
     SEC("Initialising");
 
-    // Read the setup file.
-    const arc::data::Json setup = read_setup_file(t_argc, t_argv);
+    // Read the setup file, and any command line options.
+    const arc::data::Json          setup  = read_setup_file(t_argc, t_argv);
+    const std::vector<std::string> resume = read_option(t_argc, t_argv, "--resume", 1);
+    const std::vector<std::string> shard  = read_option(t_argc, t_argv, "--shard", 2);
 
-    // Create output directory and check it was created successfully,
-    const std::string output_dir = create_output_dir(setup["system"].parse_child<std::string>("output_dir_name"));
+    // Check the shard values before any output is written.
+    unsigned long int shard_index = 0;
+    unsigned long int num_shards  = 0;
+    if (!shard.empty())
+    {
+        shard_index = read_option_value("--shard", shard[0]);
+        num_shards  = read_option_value("--shard", shard[1]);
+        if (shard_index >= num_shards)
+        {
+            ERROR("Invalid command line arguments passed.",
+                  "Shard index: '" << shard_index << "', must be less than the number of shards: '" << num_shards << "'.");
+        }
+    }
+
+    // Shards must share a seed to form a single simulation.
+    if (!shard.empty() && !setup["system"].has_child("seed"))
+    {
+        ERROR("Unable to run simulation shard.", "A seed must be set so every shard draws from the same photon streams.");
+    }
+
+    // Create output directory and check it was created successfully, naming the shard so that shards started together
+    // never share a directory.
+    std::string dir_name = setup["system"].parse_child<std::string>("output_dir_name");
+    if (!shard.empty())
+    {
+        dir_name += "_shard_" + std::to_string(shard_index);
+    }
+    const std::string output_dir = create_output_dir(dir_name);
 
     // Save run information files.
     save_run_info(output_dir);
@@ -68,6 +100,18 @@ int main(const int t_argc, const char** t_argv)
     SEC("Constructing Simulation");
     arc::setup::Sim sim(setup);
 
+    // Restrict the run to a single shard of the photons.
+    if (!shard.empty())
+    {
+        sim.set_shard(shard_index, num_shards);
+    }
+
+    // Load the data of a previous run.
+    if (!resume.empty())
+    {
+        sim.load_checkpoint(resume[0]);
+    }
+
     // Pre-render the simulation scene.
     if (setup["system"].parse_child<bool>("pre_render", false))
     {
@@ -76,11 +120,22 @@ int main(const int t_argc, const char** t_argv)
 
     // Run the simulation.
     SEC("Running Simulation");
-    run_sim(setup, sim);
+    run_sim(setup, sim, output_dir);
 
-    // Save tree data.
+    // Save the raw shard tallies, to be merged with the other shards by arctorus-merge.
     SEC("Saving Data");
-    save_data(setup, sim, output_dir);
+    if (!shard.empty())
+    {
+        if (!sim.save_tallies(output_dir + "shard_" + std::to_string(shard_index) + ".bin"))
+        {
+            return (1);
+        }
+
+        return (0);
+    }
+
+    // Save tree data.
+    sim.save_data(output_dir, setup["tree"].parse_child<size_t>("image_res"));
 
     // Post-render the simulation scene.
     if (setup["system"].parse_child<bool>("post_render", false))
@@ -103,10 +158,14 @@ int main(const int t_argc, const char** t_argv)
  */
 arc::data::Json read_setup_file(const int t_argc, const char** t_argv)
 {
-    // Check the number of command line arguments.
-    if (t_argc != 2)
+    // Check the command line arguments.
+    int num_args = 2;
+    num_args += read_option(t_argc, t_argv, "--resume", 1).empty() ? 0 : 2;
+    num_args += read_option(t_argc, t_argv, "--shard", 2).empty() ? 0 : 3;
+    if (t_argc != num_args)
     {
-        ERROR("Invalid number of command line arguments passed.", "./path/to/arctorus <parameters.json>");
+        ERROR("Invalid command line arguments passed.",
+              "./path/to/arctorus <parameters.json> [--resume <checkpoint.bin>] [--shard <index> <count>]");
     }
 
     // Convert first command line argument to a string.
@@ -117,6 +176,70 @@ arc::data::Json read_setup_file(const int t_argc, const char** t_argv)
     return (arc::data::Json("setup_file", arc::utl::read(parameters_filepath)));
 }
 
+/**
+ *  Read the values following an optional command line flag.
+ *
+ *  @param  t_argc          Command line argument count.
+ *  @param  t_argv          Command line argument vector.
+ *  @param  t_flag          Flag of the option to read.
+ *  @param  t_num_values    Number of values which follow the flag.
+ *
+ *  @return The values following the flag, or an empty vector if the flag was not given.
+ */
+std::vector<std::string> read_option(const int t_argc, const char** t_argv, const std::string& t_flag,
+                                     const size_t t_num_values)
+{
+    // Search the arguments following the setup file for the flag.
+    for (int i = 2; i < t_argc; ++i)
+    {
+        if (t_argv[i] != t_flag)
+        {
+            continue;
+        }
+
+        if ((i + static_cast<int>(t_num_values)) >= t_argc)
+        {
+            ERROR("Invalid command line arguments passed.",
+                  "Option: '" << t_flag << "', requires " << t_num_values << " values.");
+        }
+
+        return (std::vector<std::string>(t_argv + i + 1, t_argv + i + 1 + t_num_values));
+    }
+
+    return (std::vector<std::string>());
+}
+
+/**
+ *  Read a non-negative integer value given to a command line option.
+ *
+ *  @param  t_flag  Flag of the option the value was given to.
+ *  @param  t_value String of the value to read.
+ *
+ *  @return The value read.
+ */
+unsigned long int read_option_value(const std::string& t_flag, const std::string& t_value)
+{
+    // Check the value is made only of digits, as strtoul would otherwise accept signs and trailing characters.
+    const bool digits = std::all_of(t_value.begin(), t_value.end(),
+                                    [](const char t_c) { return (std::isdigit(static_cast<unsigned char>(t_c)) != 0); });
+    if (t_value.empty() || !digits)
+    {
+        ERROR("Invalid command line arguments passed.",
+              "Option: '" << t_flag << "', value: '" << t_value << "', is not a non-negative integer.");
+    }
+
+    // Convert the value, checking it is within range.
+    errno                           = 0;
+    const unsigned long int r_value = std::strtoul(t_value.c_str(), nullptr, 10);
+    if (errno == ERANGE)
+    {
+        ERROR("Invalid command line arguments passed.",
+              "Option: '" << t_flag << "', value: '" << t_value << "', is out of range.");
+    }
+
+    return (r_value);
+}
+
 /**
  *  Create the output directory.
  *
@@ -165,13 +288,14 @@ void save_run_info(const std::string& t_output_dir)
 /**
  *  Initialise the threads and run the simulation.
  *
- *  @param  t_setup Json simulation setup file.
- *  @param  t_sim   Simulation object.
+ *  @param  t_setup         Json simulation setup file.
+ *  @param  t_sim           Simulation object.
+ *  @param  t_output_dir    Directory to write checkpoints to.
  */
-void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim)
+void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim, const std::string& t_output_dir)
 {
-    // Get the number of photons to run.
-    const auto total_phot                = t_setup["simulation"].parse_child<unsigned long int>("num_phot");
+    // Get the number of photons to run within the shard, excluding those completed before resuming.
+    const unsigned long int total_phot = t_sim.get_last_phot() - t_sim.get_first_phot() - t_sim.get_num_resumed_phot();
     LOG("Number of photons to run: " << total_phot);
 
     // Initialise the threads.
@@ -188,23 +312,18 @@ void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim)
     // Get start time of simulation.
     const std::chrono::steady_clock::time_point sim_start_time = std::chrono::steady_clock::now();
 
-    // Load balance the threads.
-    std::vector<double> num_phot(num_threads);
-    for (size_t         i                                      = 0; i < num_threads; ++i)
-    {
-        num_phot[i] = total_phot / num_threads;
-    }
-    unsigned long int   remaining_phot                         = total_phot % num_threads;
-    assert(remaining_phot < num_threads);
-    for (size_t i = 0; i < remaining_phot; ++i)
+    // Set off the threads, which take chunks of photons from the simulation until none remain.
+    for (unsigned long int i = 0; i < num_threads; ++i)
     {
-        ++num_phot[i];
+        threads.emplace_back(&arc::setup::Sim::run_photons, &t_sim, i);
     }
 
-    // Set off the threads.
-    for (unsigned long int i = 0; i < num_threads; ++i)
+    // Set off the checkpointing thread, which periodically saves the photons completed so far.
+    std::thread checkpoint_thread;
+    if (t_sim.get_checkpoint_period() > 0.0)
     {
-        threads.emplace_back(&arc::setup::Sim::run_photons, &t_sim, num_phot[i], i);
+        LOG("Checkpoint file: " << t_output_dir << "checkpoint.bin");
+        checkpoint_thread = std::thread(&arc::setup::Sim::run_checkpoints, &t_sim, t_output_dir + "checkpoint.bin");
     }
 
     // Wait for each thread to finish.
@@ -213,11 +332,22 @@ void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim)
         threads[i].join();
     }
 
+    // Stop checkpointing.
+    if (checkpoint_thread.joinable())
+    {
+        t_sim.stop_checkpoints();
+        checkpoint_thread.join();
+    }
+
+    // Combine the thread data.
+    t_sim.reduce_thread_data();
+
     // Calculate runtime.
     const double sim_runtime = std::chrono::duration_cast<std::chrono::duration<double>>(
         std::chrono::steady_clock::now() - sim_start_time).count();
     LOG("Simulation runtime: " << arc::utl::create_time_string(sim_runtime));
     LOG("Ave photon runtime: " << arc::utl::create_time_string(sim_runtime / total_phot));
+    LOG("Photon rate: " << (total_phot / sim_runtime) << " photons/s over " << num_threads << " threads");
     LOG("Ave scatters: " << t_sim.get_scatter_hist().get_average());
     LOG("MP scatters: " << t_sim.get_scatter_hist().get_most_probable());
     LOG("Ave exit weight: " << t_sim.get_exit_weight_hist().get_average());
@@ -226,34 +356,3 @@ void run_sim(const arc::data::Json& t_setup, arc::setup::Sim& t_sim)
     // Report any warnings.
     t_sim.get_error_report();
 }
-
-/**
- *  Save the simulation data.
- *
- *  @param  t_setup         Json simulation setup file.
- *  @param  t_sim           Simulation to save the data from.
- *  @param  t_output_dir    Directory to save data to.
- */
-void save_data(const arc::data::Json& t_setup, const arc::setup::Sim& t_sim, const std::string& t_output_dir)
-{
-    // Save tree images.
-    const std::string tree_images_dir = t_output_dir + "tree_images/";
-    arc::utl::create_directory(tree_images_dir);
-    const auto res = t_setup["tree"].parse_child<size_t>("image_res");
-    t_sim.save_tree_images(tree_images_dir, res);
-
-    // Save ccd data.
-    const std::string ccd_images_dir = t_output_dir + "ccd_images/";
-    arc::utl::create_directory(ccd_images_dir);
-    t_sim.save_ccd_images(ccd_images_dir);
-
-    // Save spectrometer data.
-    const std::string spectrometer_data_dir = t_output_dir + "spectrometer_data/";
-    arc::utl::create_directory(spectrometer_data_dir);
-    t_sim.save_spectrometer_data(spectrometer_data_dir);
-
-    // Save histogram data.
-    const std::string hist_data_dir = t_output_dir + "hist_data/";
-    arc::utl::create_directory(hist_data_dir);
-    t_sim.save_histogram_data(hist_data_dir);
-}
@@ -0,0 +1,92 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- General --
+#include "gen/log.hpp"
+
+//  -- Utility --
+#include "utl/file.hpp"
+#include "utl/string.hpp"
+
+//  -- Classes --
+#include "cls/setup/tallies.hpp"
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the Arctorus shard merging program.
+ *  Sums the raw tallies written by any number of simulation shards, then normalises and saves the merged data exactly
+ *  as a single run would.
+ *  Shard files hold the layout of the tree's leaf cells and a description of each detector, so no meshes are loaded
+ *  and no tree is built.
+ *  Shard files are read one after another straight into the totals, so only one is held at a time.
+ *
+ *  @param  t_argc  Command line argument count.
+ *  @param  t_argv  Command line argument vector.
+ *
+ *  @return Zero upon a successful merge.
+ */
+int main(const int t_argc, const char** t_argv)
+{
+    SEC("Initialising");
+
+    // Check the number of command line arguments.
+    if (t_argc < 3)
+    {
+        ERROR("Invalid number of command line arguments passed.",
+              "./path/to/arctorus-merge <parameters.json> <shard.bin> [<shard.bin> ...]");
+    }
+
+    // Read the setup file shared by the shards.
+    const std::string parameters_filepath(t_argv[1]);
+    LOG("Setup file: '" << parameters_filepath << "'.");
+    const arc::data::Json setup("setup_file", arc::utl::read(parameters_filepath));
+    if (!setup["system"].has_child("seed"))
+    {
+        ERROR("Unable to merge simulation shards.", "A seed must be set so every shard draws from the same photon streams.");
+    }
+
+    // Create output directory.
+    const std::string output_dir = "output_" + setup["system"].parse_child<std::string>("output_dir_name") + "_merged_"
+                                   + arc::utl::create_timestamp("%Y%m%d%H%M%S") + "/";
+    arc::utl::create_directory(output_dir);
+    LOG("Output directory: " << output_dir);
+    arc::file::Handle(output_dir + "setup.json", std::fstream::out) << setup;
+
+    // Add the tallies of each shard.
+    SEC("Merging Shards");
+    arc::setup::Tallies tallies(setup);
+    for (int i = 2; i < t_argc; ++i)
+    {
+        LOG("Merging shard: '" << t_argv[i] << "'.");
+        tallies.merge(t_argv[i]);
+    }
+
+    // Check the shards covered the whole simulation.
+    const unsigned long int num_merged = tallies.get_num_tallied_phot();
+    LOG("Photons merged: " << num_merged << " of " << tallies.get_num_phot());
+    if (num_merged != tallies.get_num_phot())
+    {
+        WARN("Merged shards are incomplete.",
+             "Only " << num_merged << " of " << tallies.get_num_phot() << " photons were merged.");
+    }
+    LOG("Ave scatters: " << tallies.get_scatter_hist().get_average());
+    LOG("MP scatters: " << tallies.get_scatter_hist().get_most_probable());
+    LOG("Ave exit weight: " << tallies.get_exit_weight_hist().get_average());
+    LOG("MP exit weight: " << tallies.get_exit_weight_hist().get_most_probable());
+    tallies.get_error_report();
+
+    // Save the merged data.
+    SEC("Saving Data");
+    tallies.save_data(output_dir, setup["tree"].parse_child<size_t>("image_res"));
+
+    return (0);
+}
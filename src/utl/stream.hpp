@@ -15,7 +15,12 @@
 
 //  == INCLUDES ==
 //  -- System --
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
 
@@ -27,11 +32,33 @@ namespace arc
 
 
 
+        //  == SETTINGS ==
+        //  -- Byte Order --
+        constexpr const bool HOST_IS_LITTLE_ENDIAN = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);  //! True on little-endian hosts.
+
+
+
         //  == FUNCTION PROTOTYPES ==
         //  -- Manipulation --
         template <typename T>
         inline void rewind(T& t_stream);
 
+        //  -- Binary --
+        template <typename T>
+        inline void write_binary(std::ostream& t_stream, const T& t_val);
+        template <typename T>
+        inline void write_binary(std::ostream& t_stream, const std::vector<T>& t_vec);
+        inline void write_binary(std::ostream& t_stream, const std::string& t_str);
+        template <typename T>
+        inline void read_binary(std::istream& t_stream, T& t_val);
+        template <typename T>
+        inline void read_binary(std::istream& t_stream, std::vector<T>& t_vec);
+        inline void read_binary(std::istream& t_stream, std::string& t_str);
+        template <typename T>
+        inline void write_little_endian(std::ostream& t_stream, const T* t_data, size_t t_num);
+        template <typename T>
+        inline void write_little_endian(std::ostream& t_stream, const T& t_val);
+
 
 
         //  == FUNCTIONS ==
@@ -54,6 +81,157 @@ namespace arc
         }
 
 
+        //  -- Binary --
+        /**
+         *  Write the raw bytes of a value to a given stream.
+         *
+         *  @tparam T   Type of value to write.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_val       Value to write.
+         */
+        template <typename T>
+        inline void write_binary(std::ostream& t_stream, const T& t_val)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types may be written as bytes.");
+
+            t_stream.write(reinterpret_cast<const char*>(&t_val), sizeof(T));
+        }
+
+        /**
+         *  Write the size of a vector followed by the raw bytes of its elements to a given stream.
+         *
+         *  @tparam T   Type stored by the vector.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_vec       Vector to write.
+         */
+        template <typename T>
+        inline void write_binary(std::ostream& t_stream, const std::vector<T>& t_vec)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types may be written as bytes.");
+
+            write_binary(t_stream, static_cast<unsigned long int>(t_vec.size()));
+            t_stream.write(reinterpret_cast<const char*>(t_vec.data()), static_cast<std::streamsize>(t_vec.size() * sizeof(T)));
+        }
+
+        /**
+         *  Write the length of a string followed by its characters to a given stream.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_str       String to write.
+         */
+        inline void write_binary(std::ostream& t_stream, const std::string& t_str)
+        {
+            write_binary(t_stream, static_cast<unsigned long int>(t_str.size()));
+            t_stream.write(t_str.data(), static_cast<std::streamsize>(t_str.size()));
+        }
+
+        /**
+         *  Read the raw bytes of a value from a given stream.
+         *
+         *  @tparam T   Type of value to read.
+         *
+         *  @param  t_stream    Stream to read from.
+         *  @param  t_val       Value to read into.
+         */
+        template <typename T>
+        inline void read_binary(std::istream& t_stream, T& t_val)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types may be read as bytes.");
+
+            t_stream.read(reinterpret_cast<char*>(&t_val), sizeof(T));
+        }
+
+        /**
+         *  Read a vector written by write_binary from a given stream.
+         *
+         *  @tparam T   Type stored by the vector.
+         *
+         *  @param  t_stream    Stream to read from.
+         *  @param  t_vec       Vector to read into, which is resized to the stored size.
+         */
+        template <typename T>
+        inline void read_binary(std::istream& t_stream, std::vector<T>& t_vec)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types may be read as bytes.");
+
+            unsigned long int size = 0;
+            read_binary(t_stream, size);
+            if (!t_stream)
+            {
+                return;
+            }
+
+            t_vec.resize(size);
+            t_stream.read(reinterpret_cast<char*>(t_vec.data()), static_cast<std::streamsize>(size * sizeof(T)));
+        }
+
+        /**
+         *  Read a string written by write_binary from a given stream.
+         *
+         *  @param  t_stream    Stream to read from.
+         *  @param  t_str       String to read into, which is resized to the stored length.
+         */
+        inline void read_binary(std::istream& t_stream, std::string& t_str)
+        {
+            unsigned long int size = 0;
+            read_binary(t_stream, size);
+            if (!t_stream)
+            {
+                return;
+            }
+
+            t_str.resize(size);
+            t_stream.read(&t_str[0], static_cast<std::streamsize>(size));
+        }
+
+        /**
+         *  Write an array of values to a given stream in little-endian byte order, whatever the byte order of the host.
+         *  Values are written directly on little-endian hosts, and have their bytes reversed first otherwise.
+         *
+         *  @tparam T   Arithmetic type of the values to write.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_data      Pointer to the first value to write.
+         *  @param  t_num       Number of values to write.
+         */
+        template <typename T>
+        inline void write_little_endian(std::ostream& t_stream, const T* const t_data, const size_t t_num)
+        {
+            static_assert(std::is_arithmetic<T>::value, "Only arithmetic types may be written little-endian.");
+
+            if constexpr (HOST_IS_LITTLE_ENDIAN)
+            {
+                t_stream.write(reinterpret_cast<const char*>(t_data), static_cast<std::streamsize>(t_num * sizeof(T)));
+            }
+            else
+            {
+                std::vector<char> bytes(t_num * sizeof(T));
+                for (size_t i = 0; i < t_num; ++i)
+                {
+                    const char* const val = reinterpret_cast<const char*>(&t_data[i]);
+                    std::reverse_copy(val, val + sizeof(T), bytes.begin() + static_cast<std::ptrdiff_t>(i * sizeof(T)));
+                }
+                t_stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            }
+        }
+
+        /**
+         *  Write a value to a given stream in little-endian byte order, whatever the byte order of the host.
+         *
+         *  @tparam T   Arithmetic type of the value to write.
+         *
+         *  @param  t_stream    Stream to write to.
+         *  @param  t_val       Value to write.
+         */
+        template <typename T>
+        inline void write_little_endian(std::ostream& t_stream, const T& t_val)
+        {
+            write_little_endian(t_stream, &t_val, 1);
+        }
+
+
 
     } // namespace utl
 } // namespace arc
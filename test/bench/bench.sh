@@ -0,0 +1,57 @@
+#!/bin/bash
+
+#   == BENCHMARK ==
+#
+#   Run the benchmark scene once per thread count and report the photon rate of each run.
+#   The scene and its resources are found relative to the Arctorus directory, so the script may be called from anywhere.
+#   Runs write their output to a temporary directory which is removed afterwards.
+#
+#   Usage: bench.sh [thread counts...]
+#   The thread counts default to 1 2 4 8. Arctorus never runs more threads than the hardware supports, so the thread
+#   count reported for each run is the number actually used.
+#
+
+# Locate Arctorus.
+ARCTORUS_DIR=${ARCTORUS_DIR:-$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." > /dev/null && pwd)};
+ARCTORUS_BIN=${ARCTORUS_BIN:-$ARCTORUS_DIR/bin/arctorus};
+SCENE=$ARCTORUS_DIR/test/bench/scene.json;
+
+if [ ! -x "$ARCTORUS_BIN" ]; then
+    echo "Arctorus binary not found: $ARCTORUS_BIN";
+    exit 1;
+fi
+
+# Read thread counts.
+if [ "$#" -eq 0 ]; then
+    set -- 1 2 4 8;
+fi
+
+# Create working directory.
+WORK_DIR=$(mktemp -d);
+trap 'rm -rf "$WORK_DIR"' EXIT;
+cd "$WORK_DIR" > /dev/null;
+
+# Run benchmark.
+printf "%-10s %-10s %-16s %s\n" "requested" "threads" "photons/s" "speedup";
+base_rate="";
+for num_threads in "$@"; do
+    sed "s/\"max_threads\": *[0-9]*/\"max_threads\":       $num_threads/" "$SCENE" > scene.json;
+
+    if ! "$ARCTORUS_BIN" scene.json > log.txt 2>&1; then
+        echo "Run with $num_threads threads failed, log:";
+        tr '\r' '\n' < log.txt | tail -n 20;
+        exit 1;
+    fi
+    rm -rf output_bench_*;
+
+    rate_line=$(tr '\r' '\n' < log.txt | grep "Photon rate:" | tail -n 1);
+    if [ -z "$rate_line" ]; then
+        echo "Run with $num_threads threads did not report a photon rate.";
+        exit 1;
+    fi
+    rate=$(echo "$rate_line" | sed -E 's/.*Photon rate: ([0-9.e+]+) photons\/s over ([0-9]+) threads.*/\1/');
+    used=$(echo "$rate_line" | sed -E 's/.*Photon rate: ([0-9.e+]+) photons\/s over ([0-9]+) threads.*/\2/');
+    base_rate=${base_rate:-$rate};
+
+    printf "%-10s %-10s %-16s %s\n" "$num_threads" "$used" "$rate" "$(awk "BEGIN { printf \"%.2f\", $rate / $base_rate }")";
+done
@@ -0,0 +1,221 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+//  -- General --
+#include "gen/config.hpp"
+#include "gen/log.hpp"
+
+//  -- Classes --
+#include "cls/geom/batch.hpp"
+#include "cls/geom/mesh.hpp"
+#include "cls/random/generator.hpp"
+
+
+
+//  == SETTINGS ==
+//  -- Leaves --
+constexpr const char*  MESH_PATH = "test/bench/meshes/sphere.obj";  //! Mesh whose triangles fill the leaves.
+constexpr const size_t LEAF_TRI  = 18;                              //! Triangles per leaf, as the max_tri setting.
+
+//  -- Rays --
+constexpr const size_t   RAYS_PER_LEAF = 4096;  //! Number of rays cast from within each leaf.
+constexpr const size_t   NUM_REPS      = 8;     //! Number of times every ray is cast by each method.
+constexpr const uint64_t SEED          = 77;    //! Seed of the ray generator.
+
+
+
+//  == STRUCTURES ==
+//  -- Rays --
+/**
+ *  Ray cast within a leaf, limited to the length of the diagonal of the leaf.
+ */
+struct Ray
+{
+    size_t            leaf; //! Index of the leaf the ray is cast in.
+    arc::math::Vec<3> pos;  //! Start position of the ray.
+    arc::math::Vec<3> dir;  //! Direction of the ray.
+    double            max;  //! Distance along the ray beyond which hits are ignored.
+};
+
+
+
+//  == FUNCTION PROTOTYPES ==
+//  -- Intersection --
+std::pair<size_t, double> scan_dist(const std::vector<const arc::geom::Triangle*>& t_tri, const Ray& t_ray);
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the leaf intersection benchmark.
+ *  Triangles of a mesh are split into leaves of the tree's maximum size, and rays cast from within each leaf are
+ *  intersected with its triangles both by a scan of Triangle::intersection_dist and by a geom::Batch.
+ *  The batch uses the AVX2 kernel when built with SIMD enabled, and the scalar kernel otherwise.
+ *  Every ray must find the same closest triangle at the same distance by both methods.
+ *
+ *  @return Zero if both methods agree on every ray.
+ */
+int main()
+{
+    SEC("Building Leaves");
+    const arc::geom::Mesh mesh = arc::geom::Mesh::load(MESH_PATH);
+
+    // Split the triangles of the mesh into leaves.
+    std::vector<std::vector<const arc::geom::Triangle*>>         leaf_tri;
+    std::vector<arc::geom::Batch>                                leaf_batch;
+    std::vector<std::pair<arc::math::Vec<3>, arc::math::Vec<3>>> leaf_bound;
+    for (size_t i = 0; i < mesh.get_num_tri(); i += LEAF_TRI)
+    {
+        leaf_tri.emplace_back();
+        leaf_batch.emplace_back();
+        leaf_bound.emplace_back(mesh.get_tri(i).get_pos(0), mesh.get_tri(i).get_pos(0));
+        for (size_t j = i; j < std::min(i + LEAF_TRI, mesh.get_num_tri()); ++j)
+        {
+            leaf_tri.back().push_back(&mesh.get_tri(j));
+            leaf_batch.back().add_tri(mesh.get_tri(j));
+            for (size_t k = 0; k < 3; ++k)
+            {
+                for (size_t l = 0; l < 3; ++l)
+                {
+                    leaf_bound.back().first[l]  = std::min(leaf_bound.back().first[l], mesh.get_tri(j).get_pos(k)[l]);
+                    leaf_bound.back().second[l] = std::max(leaf_bound.back().second[l], mesh.get_tri(j).get_pos(k)[l]);
+                }
+            }
+        }
+    }
+    LOG("Mesh triangles: " << mesh.get_num_tri());
+    LOG("Leaves: " << leaf_tri.size() << " of up to " << LEAF_TRI << " triangles");
+
+    // Cast isotropic rays from random points within the bounds of each leaf.
+    arc::random::Generator rng(SEED, 0);
+    std::vector<Ray>       ray;
+    ray.reserve(leaf_tri.size() * RAYS_PER_LEAF);
+    for (size_t i = 0; i < leaf_tri.size(); ++i)
+    {
+        const arc::math::Vec<3>& min_bound = leaf_bound[i].first;
+        const arc::math::Vec<3>& max_bound = leaf_bound[i].second;
+        for (size_t j = 0; j < RAYS_PER_LEAF; ++j)
+        {
+            const double cos_theta = rng.gen_value(-1.0, 1.0);
+            const double sin_theta = std::sqrt(1.0 - (cos_theta * cos_theta));
+            const double phi       = rng.gen_value(0.0, 2.0 * M_PI);
+            const double x         = rng.gen_value(min_bound[0], max_bound[0] + 1.0e-12);
+            const double y         = rng.gen_value(min_bound[1], max_bound[1] + 1.0e-12);
+            const double z         = rng.gen_value(min_bound[2], max_bound[2] + 1.0e-12);
+
+            ray.push_back(Ray({i, arc::math::Vec<3>(x, y, z),
+                               arc::math::normalise(arc::math::Vec<3>(sin_theta * std::cos(phi),
+                                                                      sin_theta * std::sin(phi), cos_theta)),
+                               (max_bound - min_bound).magnitude() + 1.0e-12}));
+        }
+    }
+    LOG("Rays: " << ray.size());
+
+    // Check both methods find the same hits.
+    SEC("Checking");
+    size_t num_hit = 0;
+    for (size_t i = 0; i < ray.size(); ++i)
+    {
+        const std::pair<size_t, double> scan  = scan_dist(leaf_tri[ray[i].leaf], ray[i]);
+        const std::pair<size_t, double> batch = leaf_batch[ray[i].leaf].intersection_dist(ray[i].pos, ray[i].dir,
+                                                                                           ray[i].max);
+        if (scan != batch)
+        {
+            ERROR("Leaf intersection benchmark failed.",
+                  "Ray " << i << " hit triangle " << batch.first << " at " << batch.second << " by batch, but triangle "
+                         << scan.first << " at " << scan.second << " by scan.");
+        }
+        num_hit += (scan.first < leaf_tri[ray[i].leaf].size()) ? 1 : 0;
+    }
+    LOG("Rays hitting a triangle: " << num_hit);
+
+    // Time each method.
+    SEC("Timing");
+#ifdef ENABLE_SIMD
+    LOG("Batch kernel: AVX2");
+#else
+    LOG("Batch kernel: scalar");
+#endif
+    double checksum = 0.0;
+
+    const std::chrono::steady_clock::time_point scan_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_REPS; ++i)
+    {
+        for (size_t j = 0; j < ray.size(); ++j)
+        {
+            checksum += scan_dist(leaf_tri[ray[j].leaf], ray[j]).second;
+        }
+    }
+    const double scan_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - scan_start).count();
+
+    const std::chrono::steady_clock::time_point batch_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_REPS; ++i)
+    {
+        for (size_t j = 0; j < ray.size(); ++j)
+        {
+            checksum -= leaf_batch[ray[j].leaf].intersection_dist(ray[j].pos, ray[j].dir, ray[j].max).second;
+        }
+    }
+    const double batch_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - batch_start).count();
+
+    const double num_queries = static_cast<double>(NUM_REPS * ray.size());
+    LOG("Triangle scan: " << (num_queries / scan_time / 1.0e6) << " M leaf queries/s");
+    LOG("Batch        : " << (num_queries / batch_time / 1.0e6) << " M leaf queries/s");
+    LOG("Speedup      : " << (scan_time / batch_time));
+    LOG("Checksum     : " << checksum);
+
+    return (0);
+}
+
+
+
+//  == FUNCTIONS ==
+//  -- Intersection --
+/**
+ *  Determine the closest triangle of a leaf hit by a ray by testing each triangle in turn.
+ *  This is the per-triangle scan the leaf cells performed before triangles were batched.
+ *  If no triangle is hit the returned index is the number of triangles and the distance is the ray's maximum.
+ *
+ *  @param  t_tri   Triangles of the leaf.
+ *  @param  t_ray   Ray to intersect.
+ *
+ *  @return A pair containing the index of the closest triangle and the distance to it.
+ */
+std::pair<size_t, double> scan_dist(const std::vector<const arc::geom::Triangle*>& t_tri, const Ray& t_ray)
+{
+    size_t r_index = t_tri.size();
+    double r_dist  = t_ray.max;
+    for (size_t i = 0; i < t_tri.size(); ++i)
+    {
+        bool   hit;
+        double dist;
+        std::tie(hit, dist) = t_tri[i]->intersection_dist(t_ray.pos, t_ray.dir);
+
+        if (hit && (dist < r_dist))
+        {
+            r_index = i;
+            r_dist  = dist;
+        }
+    }
+
+    return (std::pair<size_t, double>(r_index, r_dist));
+}
@@ -0,0 +1,130 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//  -- General --
+#include "gen/log.hpp"
+
+//  -- Classes --
+#include "cls/random/generator.hpp"
+#include "cls/random/index.hpp"
+
+
+
+//  == SETTINGS ==
+//  -- Distributions --
+constexpr const std::array<size_t, 4> NUM_ENTRIES = {{8, 1000, 100000, 1000000}};   //! Sizes of the distributions.
+constexpr const size_t                ZERO_STRIDE = 7;  //! Stride of the entries given zero probability.
+
+//  -- Drawing --
+constexpr const unsigned long int NUM_DRAWS = 4000000;  //! Number of indices drawn by each method.
+constexpr const uint64_t          SEED      = 77;       //! Seed of the generator streams.
+
+
+
+//  == FUNCTION PROTOTYPES ==
+//  -- Timing --
+double time_draws(const arc::random::Index& t_index, const std::vector<double>& t_p, unsigned long int& t_checksum);
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the random index benchmark.
+ *  Indices are drawn from random step distributions of increasing size by searching the cumulative distribution and
+ *  by looking up the alias table.
+ *  The time per draw includes generating the uniform value each draw consumes, which is also timed alone.
+ *  Every entry of zero probability is checked never to be drawn.
+ *
+ *  @return Zero if no entry of zero probability is drawn.
+ */
+int main()
+{
+    SEC("Random Index Drawing");
+
+    // Time the generation of the uniform values alone.
+    arc::random::Generator rng(SEED, 0);
+    double                 sum = 0.0;
+    const std::chrono::steady_clock::time_point gen_start = std::chrono::steady_clock::now();
+    for (unsigned long int i = 0; i < NUM_DRAWS; ++i)
+    {
+        sum += rng.gen_value();
+    }
+    const double gen_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - gen_start).count();
+    LOG("Uniform value: " << (gen_time / NUM_DRAWS * 1.0e9) << " ns/draw (sum " << sum << ")");
+
+    for (size_t i = 0; i < NUM_ENTRIES.size(); ++i)
+    {
+        // Form a random distribution with some entries of zero probability.
+        std::vector<double> p(NUM_ENTRIES[i]);
+        for (size_t j = 0; j < p.size(); ++j)
+        {
+            p[j] = ((j % ZERO_STRIDE) == (ZERO_STRIDE - 1)) ? 0.0 : rng.gen_value();
+        }
+
+        const arc::random::Index search(p, arc::random::Index::method::SEARCH);
+        const arc::random::Index alias(p, arc::random::Index::method::ALIAS);
+
+        unsigned long int checksum    = 0;
+        const double      search_time = time_draws(search, p, checksum);
+        const double      alias_time  = time_draws(alias, p, checksum);
+
+        LOG("Entries: " << NUM_ENTRIES[i] << "\tsearch: " << (search_time / NUM_DRAWS * 1.0e9) << " ns/draw\talias: "
+                        << (alias_time / NUM_DRAWS * 1.0e9) << " ns/draw\tspeedup: " << (search_time / alias_time)
+                        << "\t(checksum " << checksum << ")");
+    }
+
+    return (0);
+}
+
+
+
+//  == FUNCTIONS ==
+//  -- Timing --
+/**
+ *  Time the drawing of indices from a generator, and check no entry of zero probability is drawn.
+ *
+ *  @param  t_index     Index generator to draw from.
+ *  @param  t_p         Probabilities the generator was formed from.
+ *  @param  t_checksum  Sum of the drawn indices, kept so the draws are not optimised away.
+ *
+ *  @return The time taken to draw the indices in seconds.
+ */
+double time_draws(const arc::random::Index& t_index, const std::vector<double>& t_p, unsigned long int& t_checksum)
+{
+    arc::random::Generator rng(SEED, t_p.size());
+
+    std::vector<size_t> index(NUM_DRAWS);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long int i = 0; i < NUM_DRAWS; ++i)
+    {
+        index[i] = t_index.gen_index(rng);
+    }
+    const double r_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - start).count();
+
+    for (unsigned long int i = 0; i < NUM_DRAWS; ++i)
+    {
+        if (t_p[index[i]] <= 0.0)
+        {
+            ERROR("Random index benchmark failed.",
+                  "Index " << index[i] << " of zero probability was drawn from " << t_p.size() << " entries.");
+        }
+        t_checksum += index[i];
+    }
+
+    return (r_time);
+}
@@ -0,0 +1,146 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//  -- General --
+#include "gen/config.hpp"
+#include "gen/log.hpp"
+
+//  -- Classes --
+#include "cls/geom/triangle.hpp"
+#include "cls/random/generator.hpp"
+#include "cls/tree/cell.hpp"
+
+
+
+//  == SETTINGS ==
+//  -- Triangles --
+constexpr const size_t                NUM_TRI        = 1000000;              //! Number of triangles tested.
+constexpr const std::array<double, 3> TRI_SIZE       = {{2.0, 0.3, 0.02}};   //! Edge scales of the triangles, cycled.
+constexpr const size_t                DEGEN_STRIDE   = 1000;                 //! Stride of the degenerate triangles.
+constexpr const size_t                ON_FACE_STRIDE = 777;                  //! Stride of the triangles on a cell face.
+constexpr const uint64_t              SEED           = 77;                   //! Seed of the triangle generator.
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the tree build overlap benchmark.
+ *  Random triangles of a range of sizes, including degenerate triangles and triangles lying in a face of the cell, are
+ *  tested for overlap with a cell one at a time by Cell::tri_overlap and in blocks by Cell::tri_overlap_block.
+ *  The block test uses AVX2 lanes when built with SIMD enabled, and loops over the scalar test otherwise.
+ *  Every triangle must be given the same result by both tests.
+ *
+ *  @return Zero if both tests agree on every triangle.
+ */
+int main()
+{
+    SEC("Generating Triangles");
+
+    // Form a single cell with no equipment inside.
+    const std::vector<arc::equip::Entity>          entity;
+    const std::vector<arc::equip::Light>           light;
+    const std::vector<arc::detector::Ccd>          ccd;
+    const std::vector<arc::detector::Spectrometer> spectrometer;
+    const arc::tree::Cell cell(0, 0, 1, arc::math::Vec<3>(-1.0, -0.5, -2.0), arc::math::Vec<3>(1.0, 1.5, 0.0), entity,
+                               light, ccd, spectrometer);
+
+    // Generate triangles around the cell.
+    arc::random::Generator           rng(SEED, 0);
+    std::vector<arc::geom::Triangle> tri;
+    const arc::math::Vec<3>          norm(0.0, 0.0, 1.0);
+    tri.reserve(NUM_TRI);
+    for (size_t i = 0; i < NUM_TRI; ++i)
+    {
+        const double      size = TRI_SIZE[i % TRI_SIZE.size()];
+        arc::math::Vec<3> alpha(rng.gen_value(-3.0, 3.0), rng.gen_value(-3.5, 2.5), rng.gen_value(-4.0, 2.0));
+        arc::math::Vec<3> beta  = alpha + arc::math::Vec<3>(rng.gen_value(-size, size), rng.gen_value(-size, size),
+                                                             rng.gen_value(-size, size));
+        arc::math::Vec<3> gamma = alpha + arc::math::Vec<3>(rng.gen_value(-size, size), rng.gen_value(-size, size),
+                                                             rng.gen_value(-size, size));
+
+        if ((i % DEGEN_STRIDE) == 0)
+        {
+            beta = alpha;
+        }
+        if ((i % ON_FACE_STRIDE) == 0)
+        {
+            alpha[arc::X] = 1.0;
+            beta[arc::X]  = 1.0;
+            gamma[arc::X] = 1.0;
+        }
+
+        tri.emplace_back(std::array<arc::math::Vec<3>, 3>({{alpha, beta, gamma}}),
+                         std::array<arc::math::Vec<3>, 3>({{norm, norm, norm}}));
+    }
+    LOG("Triangles: " << tri.size());
+
+    // Time each test.
+    SEC("Timing");
+#ifdef ENABLE_SIMD
+    LOG("Block test: AVX2");
+#else
+    LOG("Block test: scalar");
+#endif
+
+    std::vector<bool>                           scalar(NUM_TRI);
+    const std::chrono::steady_clock::time_point scalar_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_TRI; ++i)
+    {
+        scalar[i] = cell.tri_overlap(tri[i]);
+    }
+    const double scalar_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - scalar_start).count();
+
+    std::vector<bool>                           block(NUM_TRI);
+    const std::chrono::steady_clock::time_point block_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_TRI; i += arc::tree::OVERLAP_WIDTH)
+    {
+        std::array<const arc::geom::Triangle*, arc::tree::OVERLAP_WIDTH> block_tri;
+        for (size_t j = 0; j < arc::tree::OVERLAP_WIDTH; ++j)
+        {
+            block_tri[j] = &tri[std::min(i + j, NUM_TRI - 1)];
+        }
+
+        const unsigned int mask = cell.tri_overlap_block(block_tri);
+        for (size_t j = 0; (j < arc::tree::OVERLAP_WIDTH) && ((i + j) < NUM_TRI); ++j)
+        {
+            block[i + j] = ((mask >> j) & 1u) != 0;
+        }
+    }
+    const double block_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - block_start).count();
+
+    // Check both tests agree.
+    size_t num_overlap = 0;
+    for (size_t i = 0; i < NUM_TRI; ++i)
+    {
+        if (scalar[i] != block[i])
+        {
+            ERROR("Overlap benchmark failed.",
+                  "Triangle " << i << " overlaps the cell by the block test: " << block[i] << ", but by the scalar test: "
+                              << scalar[i] << ".");
+        }
+        num_overlap += scalar[i] ? 1 : 0;
+    }
+    LOG("Triangles overlapping the cell: " << num_overlap);
+
+    LOG("Scalar test: " << (scalar_time / NUM_TRI * 1.0e9) << " ns/triangle");
+    LOG("Block test : " << (block_time / NUM_TRI * 1.0e9) << " ns/triangle");
+    LOG("Speedup    : " << (scalar_time / block_time));
+
+    return (0);
+}
@@ -0,0 +1,166 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//  -- General --
+#include "gen/log.hpp"
+#include "gen/math.hpp"
+#include "gen/rng.hpp"
+
+//  -- Classes --
+#include "cls/random/generator.hpp"
+
+
+
+//  == SETTINGS ==
+//  -- Sampling --
+constexpr const unsigned long int NUM_SAMPLES = 1000000;   //! Number of cosines drawn for each anisotropy.
+constexpr const size_t            NUM_BINS    = 100;       //! Number of equal width cosine bins.
+constexpr const double            MIN_EXPECT  = 5.0;       //! Minimum expected count of a bin entering the statistic.
+constexpr const uint64_t          SEED        = 77;        //! Seed of the generator streams.
+
+//  -- Testing --
+constexpr const std::array<double, 6> ANISOTROPY = {{-0.9, -0.5, 0.0, 0.3, 0.8, 0.99}};   //! Anisotropies to test.
+constexpr const double                CRIT_Z     = 3.09;    //! Normal deviate of the one in a thousand rejection level.
+
+
+
+//  == FUNCTION PROTOTYPES ==
+//  -- Distribution --
+double henyey_greenstein_cdf(double t_g, double t_cos);
+
+//  -- Testing --
+double chi_sq_crit(size_t t_dof);
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the henyey-greenstein sampling test.
+ *  Cosines drawn by rng::henyey_greenstein_cos are binned and compared with the analytic distribution by a chi-squared
+ *  test for each anisotropy.
+ *  Bins are merged, in order, until their expected count is large enough for the statistic to hold.
+ *  Every stream is seeded, so the test is repeatable and fails only if the sampler is wrong.
+ *
+ *  @return Zero if every anisotropy passes.
+ */
+int main()
+{
+    SEC("Henyey-Greenstein Sampling");
+
+    for (size_t i = 0; i < ANISOTROPY.size(); ++i)
+    {
+        const double g = ANISOTROPY[i];
+
+        // Draw the cosines.
+        arc::random::Generator         rng(SEED, i);
+        std::vector<unsigned long int> count(NUM_BINS, 0);
+        for (unsigned long int j = 0; j < NUM_SAMPLES; ++j)
+        {
+            const double cos_theta = arc::rng::henyey_greenstein_cos(g, 1.0 + arc::math::square(g),
+                                                                     1.0 - arc::math::square(g),
+                                                                     (g == 0.0) ? 0.0 : (1.0 / (2.0 * g)), rng);
+            ++count[std::min(NUM_BINS - 1, static_cast<size_t>((cos_theta + 1.0) * 0.5 * NUM_BINS))];
+        }
+
+        // Compare the counts with the expected counts.
+        double chi_sq     = 0.0;
+        size_t num_groups = 0;
+        double expect     = 0.0;
+        double observe    = 0.0;
+        double prev_cdf   = 0.0;
+        for (size_t j = 0; j < NUM_BINS; ++j)
+        {
+            const double cdf = henyey_greenstein_cdf(g, -1.0 + ((2.0 * (j + 1)) / NUM_BINS));
+            expect += (cdf - prev_cdf) * NUM_SAMPLES;
+            observe += count[j];
+            prev_cdf = cdf;
+
+            if ((expect >= MIN_EXPECT) || (j == (NUM_BINS - 1)))
+            {
+                chi_sq += arc::math::square(observe - expect) / expect;
+                ++num_groups;
+                expect  = 0.0;
+                observe = 0.0;
+            }
+        }
+
+        const size_t dof  = num_groups - 1;
+        const double crit = chi_sq_crit(dof);
+        LOG("g: " << g << "\tchi^2/dof: " << (chi_sq / dof) << "\tcritical: " << (crit / dof) << "\tdof: " << dof);
+
+        if (chi_sq > crit)
+        {
+            ERROR("Henyey-Greenstein sampling test failed.",
+                  "Chi-squared of " << chi_sq << " exceeds " << crit << " over " << dof << " degrees of freedom for g "
+                                    << g << ".");
+        }
+    }
+
+    LOG("All anisotropies passed.");
+
+    return (0);
+}
+
+
+
+//  == FUNCTIONS ==
+//  -- Distribution --
+/**
+ *  Determine the cumulative probability of the henyey-greenstein distribution of scattering cosines.
+ *
+ *  @param  t_g     Anisotropy value.
+ *  @param  t_cos   Cosine of the scattering angle.
+ *
+ *  @pre    t_g must be between -1.0 and 1.0.
+ *  @pre    t_cos must be between -1.0 and 1.0.
+ *
+ *  @return The probability of a scattering cosine below the given cosine.
+ */
+double henyey_greenstein_cdf(const double t_g, const double t_cos)
+{
+    assert((t_g >= -1.0) && (t_g <= 1.0));
+    assert((t_cos >= -1.0) && (t_cos <= 1.0));
+
+    if (t_g == 0.0)
+    {
+        return ((t_cos + 1.0) * 0.5);
+    }
+
+    return (((1.0 - arc::math::square(t_g)) / (2.0 * t_g))
+            * ((1.0 / std::sqrt(1.0 + arc::math::square(t_g) - (2.0 * t_g * t_cos))) - (1.0 / (1.0 + t_g))));
+}
+
+
+//  -- Testing --
+/**
+ *  Determine the critical chi-squared value of the rejection level using the Wilson-Hilferty approximation.
+ *
+ *  @param  t_dof   Number of degrees of freedom.
+ *
+ *  @pre    t_dof must be positive.
+ *
+ *  @return The chi-squared value exceeded by chance once in a thousand tests.
+ */
+double chi_sq_crit(const size_t t_dof)
+{
+    assert(t_dof > 0);
+
+    const double k = static_cast<double>(t_dof);
+
+    return (k * std::pow(1.0 - (2.0 / (9.0 * k)) + (CRIT_Z * std::sqrt(2.0 / (9.0 * k))), 3));
+}
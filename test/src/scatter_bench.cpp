@@ -0,0 +1,144 @@
+/**
+ *  @author Freddy Wordingham
+ *  @email  fjmw201@exeter.ac.uk
+ *
+ *  @date   17/10/2026.
+ */
+
+
+
+//  == INCLUDES ==
+//  -- System --
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//  -- General --
+#include "gen/log.hpp"
+#include "gen/rng.hpp"
+
+//  -- Classes --
+#include "cls/phys/material.hpp"
+#include "cls/phys/photon.hpp"
+#include "cls/random/generator.hpp"
+
+
+
+//  == SETTINGS ==
+//  -- Material --
+constexpr const std::array<double, 5> ANISOTROPY = {{-0.5, 0.0, 0.3, 0.8, 0.99}};   //! Anisotropies to scatter with.
+constexpr const double                WAVELENGTH = 600e-9;  //! Wavelength of the scattered photons.
+
+//  -- Scattering --
+constexpr const unsigned long int NUM_CHECKS   = 100000;    //! Number of scatterings compared between the methods.
+constexpr const unsigned long int NUM_SCATTERS = 4000000;   //! Number of scatterings timed for each method.
+constexpr const double            DIR_TOL      = 1.0e-9;    //! Tolerance of the direction components of the methods.
+constexpr const uint64_t          SEED         = 77;        //! Seed of the generator streams.
+
+
+
+//  == FUNCTION PROTOTYPES ==
+//  -- Scattering --
+void scatter_acos(arc::phys::Photon& t_phot, arc::random::Generator& t_rng);
+
+
+
+//  == MAIN ==
+/**
+ *  Main function of the photon scattering benchmark.
+ *  Photons are scattered by Photon::scatter, which samples the cosine of the scattering angle directly, and by drawing
+ *  the angle with rng::henyey_greenstein and rotating by it, which takes an acos and then a cos of the angle.
+ *  Both methods draw the same values from identically seeded streams, so every anisotropic scattering must give the
+ *  same direction to within a tolerance.
+ *  Isotropic scattering is only timed, as the angle method draws the angle uniformly rather than its cosine.
+ *
+ *  @return Zero if both methods agree on every compared scattering.
+ */
+int main()
+{
+    SEC("Photon Scattering");
+
+    for (size_t i = 0; i < ANISOTROPY.size(); ++i)
+    {
+        const double              g = ANISOTROPY[i];
+        const arc::phys::Material mat({300e-9, 900e-9}, {1.33, 1.33}, {100.0, 100.0}, {1e4, 1e4}, {g, g});
+        const arc::phys::Photon   start(arc::math::Vec<3>(0.0, 0.0, 0.0), arc::math::Vec<3>(0.0, 0.0, 1.0), WAVELENGTH,
+                                        mat);
+
+        // Check both methods scatter into the same direction.
+        if (g != 0.0)
+        {
+            arc::random::Generator direct_rng(SEED, i);
+            arc::random::Generator acos_rng(SEED, i);
+            arc::phys::Photon      phot = start;
+            for (unsigned long int j = 0; j < NUM_CHECKS; ++j)
+            {
+                arc::phys::Photon acos_phot = phot;
+                phot.scatter(direct_rng);
+                scatter_acos(acos_phot, acos_rng);
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    if (std::fabs(phot.get_dir()[k] - acos_phot.get_dir()[k]) > DIR_TOL)
+                    {
+                        ERROR("Scattering benchmark failed.",
+                              "Scattering " << j << " with anisotropy " << g << " gave direction " << phot.get_dir()
+                                            << " by direct sampling, but " << acos_phot.get_dir() << " by acos.");
+                    }
+                }
+            }
+        }
+
+        // Time each method.
+        double checksum = 0.0;
+
+        arc::random::Generator                      direct_rng(SEED, i);
+        arc::phys::Photon                           direct_phot = start;
+        const std::chrono::steady_clock::time_point direct_start = std::chrono::steady_clock::now();
+        for (unsigned long int j = 0; j < NUM_SCATTERS; ++j)
+        {
+            direct_phot.scatter(direct_rng);
+            checksum += direct_phot.get_dir()[arc::Z];
+        }
+        const double direct_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+            std::chrono::steady_clock::now() - direct_start).count();
+
+        arc::random::Generator                      acos_rng(SEED, i);
+        arc::phys::Photon                           acos_phot  = start;
+        const std::chrono::steady_clock::time_point acos_start = std::chrono::steady_clock::now();
+        for (unsigned long int j = 0; j < NUM_SCATTERS; ++j)
+        {
+            scatter_acos(acos_phot, acos_rng);
+            checksum -= acos_phot.get_dir()[arc::Z];
+        }
+        const double acos_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+            std::chrono::steady_clock::now() - acos_start).count();
+
+        LOG("g: " << g << "\tdirect: " << (direct_time / NUM_SCATTERS * 1.0e9) << " ns/scatter\tacos: "
+                  << (acos_time / NUM_SCATTERS * 1.0e9) << " ns/scatter\tspeedup: " << (acos_time / direct_time)
+                  << "\t(checksum " << checksum << ")");
+    }
+
+    return (0);
+}
+
+
+
+//  == FUNCTIONS ==
+//  -- Scattering --
+/**
+ *  Scatter a photon by drawing the scattering angle and rotating by it.
+ *  This is the path Photon::scatter took before the cosine was sampled directly.
+ *
+ *  @param  t_phot  Photon to scatter.
+ *  @param  t_rng   Random number generator to draw from.
+ */
+void scatter_acos(arc::phys::Photon& t_phot, arc::random::Generator& t_rng)
+{
+    const double dec = arc::rng::henyey_greenstein(t_phot.get_anisotropy(), t_rng);
+    const double azi = t_rng.gen_value(0.0, 2.0 * M_PI);
+
+    t_phot.rotate(dec, azi);
+}